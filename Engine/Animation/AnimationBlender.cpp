@@ -0,0 +1,183 @@
+#include "Engine/Animation/AnimationBlender.hpp"
+
+#include <ThirdParty/EASTL-master/include/EASTL/utility.h>
+
+#include <cmath>
+
+namespace Engine
+{
+	AnimationBlender::AnimationBlender(eastl::shared_ptr<Skeleton> skeleton) : layers(1), maxBoneDepth(UINT32_MAX)
+	{
+		SetSkeleton(skeleton);
+	}
+
+	void AnimationBlender::SetSkeleton(eastl::shared_ptr<Skeleton> skeleton)
+	{
+		this->skeleton = skeleton;
+
+		const size_t boneCount = skeleton != nullptr ? skeleton->GetBoneCount() : 0;
+		pose.resize(boneCount);
+		clipPose.resize(boneCount);
+		fadePose.resize(boneCount);
+		localTransforms.resize(boneCount);
+		modelTransforms.clear();
+
+		for (size_t i = 0, size = layers.size(); i < size; ++i)
+		{
+			layers[i].clips[0] = Clip();
+			layers[i].clips[1] = Clip();
+			layers[i].fadeDuration = 0.f;
+		}
+	}
+
+	size_t AnimationBlender::AddLayer()
+	{
+		layers.push_back();
+		return layers.size() - 1;
+	}
+
+	size_t AnimationBlender::GetLayerCount() const
+	{
+		return layers.size();
+	}
+
+	void AnimationBlender::Play(size_t layer, size_t animation, float fadeDuration, float startTime)
+	{
+		Layer& playedLayer = layers[layer];
+
+		// Swapping the clips keeps the memory of both cursors, so switching animations doesn't allocate once both have been used.
+		eastl::swap(playedLayer.clips[0], playedLayer.clips[1]);
+		playedLayer.clips[0].animation = animation;
+		playedLayer.clips[0].time = startTime;
+		playedLayer.fadeTime = 0.f;
+		playedLayer.fadeDuration = fadeDuration;
+
+		if (fadeDuration <= 0.f)
+			playedLayer.clips[1].animation = size_t(-1);
+	}
+
+	void AnimationBlender::SetTime(size_t layer, float time)
+	{
+		layers[layer].clips[0].time = time;
+	}
+
+	float AnimationBlender::GetTime(size_t layer) const
+	{
+		return layers[layer].clips[0].time;
+	}
+
+	void AnimationBlender::SetWeight(size_t layer, float weight)
+	{
+		layers[layer].weight = weight;
+	}
+
+	void AnimationBlender::SetLooping(size_t layer, bool looping)
+	{
+		layers[layer].looping = looping;
+	}
+
+	void AnimationBlender::SetBoneMask(size_t layer, const eastl::vector<float>& boneWeights)
+	{
+		layers[layer].boneMask = boneWeights;
+	}
+
+	eastl::vector<float> AnimationBlender::CreateBoneMask(const eastl::string& boneName) const
+	{
+		if (skeleton == nullptr)
+			return eastl::vector<float>();
+
+		eastl::vector<float> boneWeights(skeleton->GetBoneCount(), 0.f);
+		const int32_t boneIndex = skeleton->GetBoneIndex(boneName);
+		if (boneIndex < 0)
+			return boneWeights;
+
+		// Every parent comes before its children, so the descendants of the bone are the bones after it whose parent is in the mask.
+		const eastl::vector<int32_t>& parentIndices = skeleton->GetParentIndices();
+		boneWeights[boneIndex] = 1.f;
+		for (size_t i = boneIndex + 1, size = boneWeights.size(); i < size; ++i)
+		{
+			if (parentIndices[i] >= 0)
+				boneWeights[i] = boneWeights[parentIndices[i]];
+		}
+
+		return boneWeights;
+	}
+
+	void AnimationBlender::SetMaxBoneDepth(uint32_t maxBoneDepth)
+	{
+		this->maxBoneDepth = maxBoneDepth;
+	}
+
+	uint32_t AnimationBlender::GetMaxBoneDepth() const
+	{
+		return maxBoneDepth;
+	}
+
+	void AnimationBlender::AdvanceClip(Clip& clip, float deltaTime, bool looping)
+	{
+		const float duration = skeleton->GetAnimationDuration(clip.animation);
+		if (duration <= 0.f)
+			return;
+
+		clip.time += deltaTime;
+		if (clip.time > duration)
+			clip.time = looping ? fmodf(clip.time, duration) : duration;
+	}
+
+	void AnimationBlender::Update(float deltaTime)
+	{
+		if (skeleton == nullptr)
+			return;
+
+		for (size_t i = 0, size = layers.size(); i < size; ++i)
+		{
+			Layer& layer = layers[i];
+			AdvanceClip(layer.clips[0], deltaTime, layer.looping);
+
+			if (layer.clips[1].animation == size_t(-1))
+				continue;
+
+			AdvanceClip(layer.clips[1], deltaTime, layer.looping);
+			layer.fadeTime += deltaTime;
+			if (layer.fadeTime >= layer.fadeDuration)
+				layer.clips[1].animation = size_t(-1);
+		}
+	}
+
+	void AnimationBlender::Evaluate()
+	{
+		if (skeleton == nullptr)
+			return;
+
+		const size_t boneCount = pose.size();
+		const eastl::vector<BoneTransform>& defaultPose = skeleton->GetDefaultPose();
+		pose.assign(defaultPose.begin(), defaultPose.end());
+
+		for (size_t i = 0, size = layers.size(); i < size; ++i)
+		{
+			Layer& layer = layers[i];
+			const bool isFading = layer.clips[1].animation != size_t(-1);
+			if (layer.weight <= 0.f || (layer.clips[0].animation == size_t(-1) && isFading == false))
+				continue;
+
+			skeleton->SamplePose(layer.clips[0].animation, layer.clips[0].time, layer.clips[0].cursor, clipPose, maxBoneDepth);
+			if (isFading)
+			{
+				skeleton->SamplePose(layer.clips[1].animation, layer.clips[1].time, layer.clips[1].cursor, fadePose, maxBoneDepth);
+				BlendPoses(fadePose.data(), clipPose.data(), layer.fadeTime / layer.fadeDuration, nullptr, clipPose.data(), boneCount);
+			}
+
+			const float* boneWeights = layer.boneMask.size() == boneCount ? layer.boneMask.data() : nullptr;
+			BlendPoses(pose.data(), clipPose.data(), layer.weight, boneWeights, pose.data(), boneCount);
+		}
+
+		modelTransforms.resize(boneCount);
+		ComposePose(pose.data(), localTransforms.data(), boneCount);
+		LocalToModel(skeleton->GetParentIndices().data(), localTransforms.data(), modelTransforms.data(), boneCount);
+	}
+
+	const eastl::vector<glm::mat4>& AnimationBlender::GetBoneTransforms() const
+	{
+		return modelTransforms;
+	}
+} // namespace Engine
\ No newline at end of file
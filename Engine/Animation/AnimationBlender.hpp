@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Engine/api.hpp"
+#include "Engine/Animation/Pose.hpp"
+#include "Engine/Animation/Skeleton.hpp"
+
+#include <ThirdParty/EASTL-master/include/EASTL/shared_ptr.h>
+#include <ThirdParty/EASTL-master/include/EASTL/string.h>
+#include <ThirdParty/EASTL-master/include/EASTL/vector.h>
+
+namespace Engine
+{
+	/// <summary>
+	/// Evaluates a stack of animation layers on a skeleton into a single pose.
+	/// Every layer plays an animation and can cross fade to the next one, the layers are blended on top of each other from first to last
+	/// with their weight and bone mask. The first layer is blended on top of the default pose of the skeleton.
+	/// All pose buffers are allocated when the skeleton is set, evaluating a blender doesn't allocate.
+	/// A blender only reads from its skeleton, so blenders of different instances can be updated and evaluated on different threads.
+	/// </summary>
+	class ENGINE_API AnimationBlender
+	{
+	public:
+		/// <summary>
+		/// Creates a blender with a single layer.
+		/// </summary>
+		/// <param name="skeleton">The skeleton to animate, can be nullptr.</param>
+		explicit AnimationBlender(eastl::shared_ptr<Skeleton> skeleton = nullptr);
+
+		/// <summary>
+		/// Sets the skeleton to animate and allocates the pose buffers for it. The layers stay, but stop playing their animations.
+		/// </summary>
+		/// <param name="skeleton">The skeleton to animate, can be nullptr.</param>
+		void SetSkeleton(eastl::shared_ptr<Skeleton> skeleton);
+
+		/// <summary>
+		/// Adds a layer on top of the existing layers.
+		/// </summary>
+		/// <returns>The index of the new layer.</returns>
+		size_t AddLayer();
+
+		/// <summary>
+		/// Returns the amount of layers.
+		/// </summary>
+		size_t GetLayerCount() const;
+
+		/// <summary>
+		/// Starts playing an animation on a layer, fading out the animation the layer was playing.
+		/// A layer can only fade between two animations, starting a third one while fading drops the animation that was fading out.
+		/// </summary>
+		/// <param name="layer">The index of the layer.</param>
+		/// <param name="animation">The index of the animation in the skeleton, an invalid index fades to the default pose.</param>
+		/// <param name="fadeDuration">The duration of the cross fade in seconds, 0 switches immediately.</param>
+		/// <param name="startTime">The time in the new animation to start at in seconds.</param>
+		void Play(size_t layer, size_t animation, float fadeDuration = 0.f, float startTime = 0.f);
+
+		/// <summary>
+		/// Sets the time of the animation a layer is playing.
+		/// </summary>
+		/// <param name="layer">The index of the layer.</param>
+		/// <param name="time">The new time in seconds.</param>
+		void SetTime(size_t layer, float time);
+
+		/// <summary>
+		/// Returns the time of the animation a layer is playing in seconds.
+		/// </summary>
+		/// <param name="layer">The index of the layer.</param>
+		float GetTime(size_t layer) const;
+
+		/// <summary>
+		/// Sets how much a layer contributes to the pose, between 0 and 1.
+		/// </summary>
+		/// <param name="layer">The index of the layer.</param>
+		/// <param name="weight">The new weight.</param>
+		void SetWeight(size_t layer, float weight);
+
+		/// <summary>
+		/// Sets whether the animations of a layer loop, or stop at their last key.
+		/// </summary>
+		/// <param name="layer">The index of the layer.</param>
+		/// <param name="looping">Whether the animations of the layer should loop.</param>
+		void SetLooping(size_t layer, bool looping);
+
+		/// <summary>
+		/// Limits a layer to part of the skeleton, the weight of every bone is multiplied with the weight of the layer.
+		/// </summary>
+		/// <param name="layer">The index of the layer.</param>
+		/// <param name="boneWeights">The weight of every bone by bone data index, an empty mask affects every bone.</param>
+		void SetBoneMask(size_t layer, const eastl::vector<float>& boneWeights);
+
+		/// <summary>
+		/// Creates a bone mask that contains the given bone and all of its descendants, like the upper body from the spine up.
+		/// </summary>
+		/// <param name="boneName">The name of the first bone in the mask.</param>
+		/// <returns>The weight of every bone by bone data index, 1 for the bones in the mask and 0 for the others.</returns>
+		eastl::vector<float> CreateBoneMask(const eastl::string& boneName) const;
+
+		/// <summary>
+		/// Limits the bones that are animated, the deeper bones keep their default transform. Used to animate distant instances with fewer bones.
+		/// </summary>
+		/// <param name="maxBoneDepth">The depth of the deepest animated bone, the root has a depth of 0.</param>
+		void SetMaxBoneDepth(uint32_t maxBoneDepth);
+
+		/// <summary>
+		/// Returns the depth of the deepest animated bone.
+		/// </summary>
+		uint32_t GetMaxBoneDepth() const;
+
+		/// <summary>
+		/// Advances the animations and the cross fades of every layer.
+		/// </summary>
+		/// <param name="deltaTime">Time since last update in seconds.</param>
+		void Update(float deltaTime);
+
+		/// <summary>
+		/// Samples the animations of every layer and blends them into the pose of the skeleton.
+		/// </summary>
+		void Evaluate();
+
+		/// <summary>
+		/// Returns the transform of every bone relative to the model by bone data index, as evaluated by the last call to Evaluate.
+		/// </summary>
+		const eastl::vector<glm::mat4>& GetBoneTransforms() const;
+
+	private:
+		/// <summary>
+		/// An animation playing on a layer, every clip keeps its own cursor.
+		/// </summary>
+		struct Clip
+		{
+			size_t animation = size_t(-1);
+			float time = 0.f;
+			Skeleton::AnimationCursor cursor;
+		};
+
+		struct Layer
+		{
+			Clip clips[2];						/// The animation that is playing and the animation that is fading out
+			float fadeTime = 0.f;
+			float fadeDuration = 0.f;
+			float weight = 1.f;
+			bool looping = true;
+			eastl::vector<float> boneMask;
+		};
+
+		void AdvanceClip(Clip& clip, float deltaTime, bool looping);
+
+		eastl::shared_ptr<Skeleton> skeleton;
+		eastl::vector<Layer> layers;
+		uint32_t maxBoneDepth;
+
+		// The pose buffers, reused by every layer.
+		eastl::vector<BoneTransform> pose;
+		eastl::vector<BoneTransform> clipPose;
+		eastl::vector<BoneTransform> fadePose;
+		eastl::vector<glm::mat4> localTransforms;
+		eastl::vector<glm::mat4> modelTransforms;
+	};
+} // namespace Engine
\ No newline at end of file
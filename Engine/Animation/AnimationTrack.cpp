@@ -0,0 +1,320 @@
+#include "Engine/Animation/AnimationTrack.hpp"
+
+#include <ThirdParty/EASTL-master/include/EASTL/algorithm.h>
+
+#include <cmath>
+
+namespace Engine
+{
+	namespace
+	{
+		// Playing forward only moves the cursor a few keys, larger jumps fall back to a binary search.
+		constexpr size_t CursorSearchLimit = 4;
+
+		// Keys closer together than this are interpolated linearly, slerp is only needed for large angles.
+		constexpr float NlerpThreshold = 0.9995f;
+
+		// Limits the keys checked for every removed key, so compressing long tracks that barely move doesn't take quadratic time.
+		constexpr size_t MaxRemovedKeys = 256;
+
+		constexpr float VectorQuantization = 65535.f;
+		constexpr float QuaternionQuantization = 32767.f;
+
+		// The three smallest components of a unit quaternion are never larger than 1 / sqrt(2).
+		constexpr float SmallestThreeRange = 0.707106781f;
+
+		/// <summary>
+		/// Finds the key the given time lies after, starting at the key found by the previous search. The track has at least two keys.
+		/// </summary>
+		size_t FindKey(const eastl::vector<float>& times, float ticks, uint32_t& cursor)
+		{
+			const size_t lastKey = times.size() - 2;
+			size_t key = cursor <= lastKey ? cursor : 0;
+
+			if (times[key] <= ticks) {
+				for (size_t i = 0; i < CursorSearchLimit && key < lastKey && times[key + 1] <= ticks; ++i)
+					++key;
+
+				if (key < lastKey && times[key + 1] <= ticks)
+					key = static_cast<size_t>(eastl::upper_bound(times.begin() + key + 1, times.end() - 1, ticks) - times.begin()) - 1;
+			}
+			else {
+				key = static_cast<size_t>(eastl::upper_bound(times.begin() + 1, times.begin() + key + 1, ticks) - times.begin()) - 1;
+			}
+
+			cursor = static_cast<uint32_t>(key);
+			return key;
+		}
+
+		/// <summary>
+		/// Returns how far the given time lies between a key and the next key.
+		/// </summary>
+		float GetKeyDelta(const float* times, size_t key, size_t nextKey, float ticks)
+		{
+			const float delta = (ticks - times[key]) / (times[nextKey] - times[key]);
+			return fmaxf(0.f, fminf(delta, 1.f));
+		}
+
+		glm::vec3 InterpolateVector(const glm::vec3& from, const glm::vec3& to, float delta)
+		{
+			return glm::mix(from, to, delta);
+		}
+
+		glm::quat InterpolateQuaternion(const glm::quat& from, const glm::quat& to, float delta)
+		{
+			// q and -q are the same rotation, flipping the target keeps the interpolation on the shortest path.
+			float cosTheta = glm::dot(from, to);
+			glm::quat target = to;
+			if (cosTheta < 0.f) {
+				target = -to;
+				cosTheta = -cosTheta;
+			}
+
+			if (cosTheta > NlerpThreshold)
+				return glm::normalize(from * (1.f - delta) + target * delta);
+
+			const float theta = acosf(cosTheta);
+			return (from * sinf((1.f - delta) * theta) + target * sinf(delta * theta)) / sinf(theta);
+		}
+
+		float GetVectorError(const glm::vec3& value, const glm::vec3& expected)
+		{
+			const glm::vec3 difference = glm::abs(value - expected);
+			return fmaxf(difference.x, fmaxf(difference.y, difference.z));
+		}
+
+		float GetQuaternionError(const glm::quat& value, const glm::quat& expected)
+		{
+			const glm::quat aligned = glm::dot(value, expected) < 0.f ? -value : value;
+			return fmaxf(fmaxf(fabsf(aligned.x - expected.x), fabsf(aligned.y - expected.y)), fmaxf(fabsf(aligned.z - expected.z), fabsf(aligned.w - expected.w)));
+		}
+
+		template<typename T, typename Interpolate, typename Error>
+		/// <summary>
+		/// Returns the keys that are needed to reproduce the track within the tolerance, with the same interpolation that is used to sample it.
+		/// Every removed key is checked against the interpolation between the kept keys around it. A track that doesn't change keeps a single key.
+		/// </summary>
+		eastl::vector<uint32_t> ReduceKeys(const float* times, const T* values, size_t keyCount, float tolerance, Interpolate interpolate, Error error)
+		{
+			eastl::vector<uint32_t> keptKeys;
+			if (keyCount == 0)
+				return keptKeys;
+
+			keptKeys.push_back(0);
+
+			bool isConstant = true;
+			for (size_t i = 1; i < keyCount && isConstant; ++i)
+				isConstant = error(values[i], values[0]) <= tolerance;
+			if (isConstant)
+				return keptKeys;
+
+			size_t previousKey = 0;
+			for (size_t nextKey = 2; nextKey < keyCount; ++nextKey)
+			{
+				bool canRemove = nextKey - previousKey <= MaxRemovedKeys && times[nextKey] > times[previousKey];
+				for (size_t i = previousKey + 1; i < nextKey && canRemove; ++i)
+				{
+					const T interpolated = interpolate(values[previousKey], values[nextKey], GetKeyDelta(times, previousKey, nextKey, times[i]));
+					canRemove = error(interpolated, values[i]) <= tolerance;
+				}
+
+				// The key before the next key can't be removed, so it becomes the start of the next span.
+				if (canRemove == false) {
+					previousKey = nextKey - 1;
+					keptKeys.push_back(static_cast<uint32_t>(previousKey));
+				}
+			}
+
+			keptKeys.push_back(static_cast<uint32_t>(keyCount - 1));
+			return keptKeys;
+		}
+
+		QuantizedQuaternion EncodeQuaternion(glm::quat rotation)
+		{
+			size_t largest = 0;
+			for (size_t i = 1; i < 4; ++i) {
+				if (fabsf(rotation[i]) > fabsf(rotation[largest]))
+					largest = i;
+			}
+
+			// The largest component is rebuilt as a positive value, q and -q are the same rotation.
+			if (rotation[largest] < 0.f)
+				rotation = -rotation;
+
+			uint16_t components[3];
+			for (size_t i = 0, component = 0; i < 4; ++i) {
+				if (i == largest)
+					continue;
+
+				const float normalized = fmaxf(0.f, fminf(rotation[i] / SmallestThreeRange * 0.5f + 0.5f, 1.f));
+				components[component++] = static_cast<uint16_t>(normalized * QuaternionQuantization + 0.5f);
+			}
+
+			QuantizedQuaternion quantized;
+			quantized.values[0] = static_cast<uint16_t>(components[0] | ((largest >> 1) << 15));
+			quantized.values[1] = static_cast<uint16_t>(components[1] | ((largest & 1) << 15));
+			quantized.values[2] = components[2];
+			return quantized;
+		}
+
+		glm::quat DecodeQuaternion(const QuantizedQuaternion& quantized)
+		{
+			const size_t largest = ((quantized.values[0] >> 15) << 1) | (quantized.values[1] >> 15);
+
+			glm::quat rotation;
+			float lengthSquared = 0.f;
+			for (size_t i = 0, component = 0; i < 4; ++i) {
+				if (i == largest)
+					continue;
+
+				const float value = ((quantized.values[component++] & 0x7fff) / QuaternionQuantization * 2.f - 1.f) * SmallestThreeRange;
+				rotation[i] = value;
+				lengthSquared += value * value;
+			}
+
+			rotation[largest] = sqrtf(fmaxf(0.f, 1.f - lengthSquared));
+			return rotation;
+		}
+	}
+
+	void VectorTrack::Compress(const float* times, const glm::vec3* values, size_t keyCount, float tolerance)
+	{
+		const eastl::vector<uint32_t> keptKeys = ReduceKeys(times, values, keyCount, tolerance, InterpolateVector, GetVectorError);
+
+		this->times.clear();
+		this->values.resize(keptKeys.size());
+		if (keptKeys.size() > 1) {
+			this->times.resize(keptKeys.size());
+			for (size_t i = 0, size = keptKeys.size(); i < size; ++i)
+				this->times[i] = times[keptKeys[i]];
+		}
+
+		// The keys are quantized within the range of the track, a constant track is stored exactly.
+		minimum = keptKeys.empty() ? glm::vec3(0.f) : values[keptKeys[0]];
+		glm::vec3 maximum = minimum;
+		for (size_t i = 1, size = keptKeys.size(); i < size; ++i) {
+			minimum = glm::min(minimum, values[keptKeys[i]]);
+			maximum = glm::max(maximum, values[keptKeys[i]]);
+		}
+		step = (maximum - minimum) / VectorQuantization;
+
+		for (size_t i = 0, size = keptKeys.size(); i < size; ++i) {
+			const glm::vec3 offset = values[keptKeys[i]] - minimum;
+			this->values[i].x = step.x > 0.f ? static_cast<uint16_t>(fminf(offset.x / step.x + 0.5f, VectorQuantization)) : 0;
+			this->values[i].y = step.y > 0.f ? static_cast<uint16_t>(fminf(offset.y / step.y + 0.5f, VectorQuantization)) : 0;
+			this->values[i].z = step.z > 0.f ? static_cast<uint16_t>(fminf(offset.z / step.z + 0.5f, VectorQuantization)) : 0;
+		}
+	}
+
+	glm::vec3 VectorTrack::Sample(float ticks, uint32_t& cursor, const glm::vec3& defaultValue) const
+	{
+		if (values.empty())
+			return defaultValue;
+		if (values.size() == 1 || ticks <= times.front())
+			return Decode(0);
+		if (ticks >= times.back())
+			return Decode(values.size() - 1);
+
+		const size_t key = FindKey(times, ticks, cursor);
+		return InterpolateVector(Decode(key), Decode(key + 1), GetKeyDelta(times.data(), key, key + 1, ticks));
+	}
+
+	size_t VectorTrack::GetKeyCount() const
+	{
+		return values.size();
+	}
+
+	size_t VectorTrack::GetMemorySize() const
+	{
+		return times.size() * sizeof(float) + values.size() * sizeof(QuantizedVector);
+	}
+
+	void VectorTrack::SetKeys(eastl::vector<float> times, eastl::vector<QuantizedVector> values, const glm::vec3& minimum, const glm::vec3& step)
+	{
+		this->times = eastl::move(times);
+		this->values = eastl::move(values);
+		this->minimum = minimum;
+		this->step = step;
+	}
+
+	const eastl::vector<float>& VectorTrack::GetTimes() const
+	{
+		return times;
+	}
+
+	const eastl::vector<QuantizedVector>& VectorTrack::GetValues() const
+	{
+		return values;
+	}
+
+	const glm::vec3& VectorTrack::GetMinimum() const
+	{
+		return minimum;
+	}
+
+	const glm::vec3& VectorTrack::GetStep() const
+	{
+		return step;
+	}
+
+	glm::vec3 VectorTrack::Decode(size_t key) const
+	{
+		const QuantizedVector& quantized = values[key];
+		return minimum + glm::vec3(quantized.x, quantized.y, quantized.z) * step;
+	}
+
+	void RotationTrack::Compress(const float* times, const glm::quat* values, size_t keyCount, float tolerance)
+	{
+		const eastl::vector<uint32_t> keptKeys = ReduceKeys(times, values, keyCount, tolerance, InterpolateQuaternion, GetQuaternionError);
+
+		this->times.clear();
+		this->values.resize(keptKeys.size());
+		if (keptKeys.size() > 1) {
+			this->times.resize(keptKeys.size());
+			for (size_t i = 0, size = keptKeys.size(); i < size; ++i)
+				this->times[i] = times[keptKeys[i]];
+		}
+
+		for (size_t i = 0, size = keptKeys.size(); i < size; ++i)
+			this->values[i] = EncodeQuaternion(glm::normalize(values[keptKeys[i]]));
+	}
+
+	glm::quat RotationTrack::Sample(float ticks, uint32_t& cursor, const glm::quat& defaultValue) const
+	{
+		if (values.empty())
+			return defaultValue;
+		if (values.size() == 1 || ticks <= times.front())
+			return DecodeQuaternion(values.front());
+		if (ticks >= times.back())
+			return DecodeQuaternion(values.back());
+
+		const size_t key = FindKey(times, ticks, cursor);
+		return InterpolateQuaternion(DecodeQuaternion(values[key]), DecodeQuaternion(values[key + 1]), GetKeyDelta(times.data(), key, key + 1, ticks));
+	}
+
+	size_t RotationTrack::GetKeyCount() const
+	{
+		return values.size();
+	}
+
+	size_t RotationTrack::GetMemorySize() const
+	{
+		return times.size() * sizeof(float) + values.size() * sizeof(QuantizedQuaternion);
+	}
+
+	void RotationTrack::SetKeys(eastl::vector<float> times, eastl::vector<QuantizedQuaternion> values)
+	{
+		this->times = eastl::move(times);
+		this->values = eastl::move(values);
+	}
+
+	const eastl::vector<float>& RotationTrack::GetTimes() const
+	{
+		return times;
+	}
+
+	const eastl::vector<QuantizedQuaternion>& RotationTrack::GetValues() const
+	{
+		return values;
+	}
+} // namespace Engine
\ No newline at end of file
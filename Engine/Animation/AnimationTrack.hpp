@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Engine/api.hpp"
+
+#include <ThirdParty/glm/glm/glm.hpp>
+#include <ThirdParty/glm/glm/gtc/quaternion.hpp>
+
+#include <ThirdParty/EASTL-master/include/EASTL/vector.h>
+
+namespace Engine
+{
+	/// <summary>
+	/// A vector quantized to 16 bits per component, relative to the range of the track it belongs to.
+	/// </summary>
+	struct QuantizedVector
+	{
+		uint16_t x;
+		uint16_t y;
+		uint16_t z;
+	};
+
+	/// <summary>
+	/// A unit quaternion stored as its three smallest components, quantized to 15 bits each.
+	/// The largest component is rebuilt from the other three, its index is stored in the top bits of the first two values.
+	/// </summary>
+	struct QuantizedQuaternion
+	{
+		uint16_t values[3];
+	};
+
+	/// <summary>
+	/// The compressed keys of an animated position or scale. Keys that can be interpolated from their neighbours are removed,
+	/// and a track that doesn't change is stored as a single key. The remaining keys are quantized within the range of the track.
+	/// </summary>
+	class ENGINE_API VectorTrack
+	{
+	public:
+		/// <summary>
+		/// Compresses the given keys into this track, replacing the keys it contained.
+		/// </summary>
+		/// <param name="times">The time of every key in ticks, sorted.</param>
+		/// <param name="values">The value of every key.</param>
+		/// <param name="keyCount">The amount of keys.</param>
+		/// <param name="tolerance">The largest difference per component a removed key is allowed to have from the interpolated value.</param>
+		void Compress(const float* times, const glm::vec3* values, size_t keyCount, float tolerance);
+
+		/// <summary>
+		/// Samples the track, times before the first key and after the last key are clamped.
+		/// </summary>
+		/// <param name="ticks">The time to sample at.</param>
+		/// <param name="cursor">The key found by the previous sample, updated to the key the time lies after.</param>
+		/// <param name="defaultValue">The value of a track without keys.</param>
+		glm::vec3 Sample(float ticks, uint32_t& cursor, const glm::vec3& defaultValue) const;
+
+		/// <summary>
+		/// Returns the amount of keys left after compression.
+		/// </summary>
+		size_t GetKeyCount() const;
+
+		/// <summary>
+		/// Returns the amount of bytes used by the keys of the track.
+		/// </summary>
+		size_t GetMemorySize() const;
+
+		/// <summary>
+		/// Replaces the keys of the track with keys that have been compressed before, like the keys stored in a model cache.
+		/// </summary>
+		/// <param name="times">The time of every key in ticks, empty for a track with a single key.</param>
+		/// <param name="values">The quantized value of every key.</param>
+		/// <param name="minimum">The value a quantized value of 0 stands for.</param>
+		/// <param name="step">The size of a single quantization step of every component.</param>
+		void SetKeys(eastl::vector<float> times, eastl::vector<QuantizedVector> values, const glm::vec3& minimum, const glm::vec3& step);
+
+		const eastl::vector<float>& GetTimes() const;
+		const eastl::vector<QuantizedVector>& GetValues() const;
+		const glm::vec3& GetMinimum() const;
+		const glm::vec3& GetStep() const;
+
+	private:
+		glm::vec3 Decode(size_t key) const;
+
+		eastl::vector<float> times;				// In ticks, empty for tracks with a single key
+		eastl::vector<QuantizedVector> values;
+		glm::vec3 minimum;
+		glm::vec3 step;							// The size of a single quantization step of every component
+	};
+
+	/// <summary>
+	/// The compressed keys of an animated rotation, see VectorTrack. The keys are stored as smallest three quaternions.
+	/// </summary>
+	class ENGINE_API RotationTrack
+	{
+	public:
+		/// <summary>
+		/// Compresses the given keys into this track, replacing the keys it contained.
+		/// </summary>
+		/// <param name="times">The time of every key in ticks, sorted.</param>
+		/// <param name="values">The value of every key, normalized.</param>
+		/// <param name="keyCount">The amount of keys.</param>
+		/// <param name="tolerance">The largest difference per component a removed key is allowed to have from the interpolated value.</param>
+		void Compress(const float* times, const glm::quat* values, size_t keyCount, float tolerance);
+
+		/// <summary>
+		/// Samples the track, times before the first key and after the last key are clamped.
+		/// </summary>
+		/// <param name="ticks">The time to sample at.</param>
+		/// <param name="cursor">The key found by the previous sample, updated to the key the time lies after.</param>
+		/// <param name="defaultValue">The value of a track without keys.</param>
+		glm::quat Sample(float ticks, uint32_t& cursor, const glm::quat& defaultValue) const;
+
+		/// <summary>
+		/// Returns the amount of keys left after compression.
+		/// </summary>
+		size_t GetKeyCount() const;
+
+		/// <summary>
+		/// Returns the amount of bytes used by the keys of the track.
+		/// </summary>
+		size_t GetMemorySize() const;
+
+		/// <summary>
+		/// Replaces the keys of the track with keys that have been compressed before, like the keys stored in a model cache.
+		/// </summary>
+		/// <param name="times">The time of every key in ticks, empty for a track with a single key.</param>
+		/// <param name="values">The quantized value of every key.</param>
+		void SetKeys(eastl::vector<float> times, eastl::vector<QuantizedQuaternion> values);
+
+		const eastl::vector<float>& GetTimes() const;
+		const eastl::vector<QuantizedQuaternion>& GetValues() const;
+
+	private:
+		eastl::vector<float> times;				// In ticks, empty for tracks with a single key
+		eastl::vector<QuantizedQuaternion> values;
+	};
+} // namespace Engine
\ No newline at end of file
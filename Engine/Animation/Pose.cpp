@@ -0,0 +1,202 @@
+#include "Engine/Animation/Pose.hpp"
+#include "Engine/Utility/TransformBatch.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ENGINE_POSE_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Engine
+{
+#ifdef ENGINE_POSE_SSE
+	namespace
+	{
+		template<int Element>
+		/// <summary>
+		/// Broadcasts a single element of a register to all four lanes.
+		/// </summary>
+		__m128 Splat(__m128 value)
+		{
+			return _mm_shuffle_ps(value, value, _MM_SHUFFLE(Element, Element, Element, Element));
+		}
+
+		/// <summary>
+		/// Multiplies two column major matrices, every column of the result is a combination of the columns of the left matrix.
+		/// Both matrices are loaded before anything is stored, so the output can be either of the inputs.
+		/// </summary>
+		void MultiplyMatrices(const glm::mat4& left, const glm::mat4& right, glm::mat4& output)
+		{
+			const __m128 left0 = _mm_loadu_ps(&left[0][0]);
+			const __m128 left1 = _mm_loadu_ps(&left[1][0]);
+			const __m128 left2 = _mm_loadu_ps(&left[2][0]);
+			const __m128 left3 = _mm_loadu_ps(&left[3][0]);
+
+			__m128 rightColumns[4];
+			for (int column = 0; column < 4; ++column)
+				rightColumns[column] = _mm_loadu_ps(&right[column][0]);
+
+			for (int column = 0; column < 4; ++column)
+			{
+				__m128 result = _mm_mul_ps(left0, Splat<0>(rightColumns[column]));
+				result = _mm_add_ps(result, _mm_mul_ps(left1, Splat<1>(rightColumns[column])));
+				result = _mm_add_ps(result, _mm_mul_ps(left2, Splat<2>(rightColumns[column])));
+				result = _mm_add_ps(result, _mm_mul_ps(left3, Splat<3>(rightColumns[column])));
+				_mm_storeu_ps(&output[column][0], result);
+			}
+		}
+	}
+
+	void LocalToModel(const int32_t* parentIndices, const glm::mat4* localTransforms, glm::mat4* modelTransforms, size_t boneCount)
+	{
+		for (size_t i = 0; i < boneCount; ++i)
+		{
+			if (parentIndices[i] < 0)
+				modelTransforms[i] = localTransforms[i];
+			else
+				MultiplyMatrices(modelTransforms[parentIndices[i]], localTransforms[i], modelTransforms[i]);
+		}
+	}
+
+	void CalculateSkinningMatrices(const glm::mat4* modelTransforms, const glm::mat4* boneOffsets, glm::mat4* skinningMatrices, size_t boneCount)
+	{
+		for (size_t i = 0; i < boneCount; ++i)
+			MultiplyMatrices(modelTransforms[i], boneOffsets[i], skinningMatrices[i]);
+	}
+
+	void SkinVertices(const Vertex* vertices, size_t vertexCount, const glm::mat4* skinningMatrices, size_t boneCount, glm::vec3* positions, glm::vec3* normals)
+	{
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			const Vertex& vertex = vertices[i];
+
+			// Blend the matrices of the bones first, so every vertex only needs a single matrix transform.
+			__m128 columns[4] = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+			float totalWeight = 0.0f;
+			for (size_t j = 0; j < 4; ++j)
+			{
+				const float weight = vertex.boneWeights[j];
+				if (weight == 0.0f || vertex.boneIds[j] >= boneCount)
+					continue;
+
+				const glm::mat4& matrix = skinningMatrices[vertex.boneIds[j]];
+				const __m128 weights = _mm_set1_ps(weight);
+				for (int column = 0; column < 4; ++column)
+					columns[column] = _mm_add_ps(columns[column], _mm_mul_ps(_mm_loadu_ps(&matrix[column][0]), weights));
+				totalWeight += weight;
+			}
+
+			if (totalWeight == 0.0f)
+			{
+				positions[i] = vertex.position;
+				normals[i] = vertex.normal;
+				continue;
+			}
+
+			__m128 position = _mm_add_ps(_mm_mul_ps(columns[0], _mm_set1_ps(vertex.position.x)), columns[3]);
+			position = _mm_add_ps(position, _mm_mul_ps(columns[1], _mm_set1_ps(vertex.position.y)));
+			position = _mm_add_ps(position, _mm_mul_ps(columns[2], _mm_set1_ps(vertex.position.z)));
+
+			__m128 normal = _mm_mul_ps(columns[0], _mm_set1_ps(vertex.normal.x));
+			normal = _mm_add_ps(normal, _mm_mul_ps(columns[1], _mm_set1_ps(vertex.normal.y)));
+			normal = _mm_add_ps(normal, _mm_mul_ps(columns[2], _mm_set1_ps(vertex.normal.z)));
+
+			float values[4];
+			_mm_storeu_ps(values, position);
+			positions[i] = glm::vec3(values[0], values[1], values[2]);
+
+			_mm_storeu_ps(values, normal);
+			const glm::vec3 skinnedNormal = glm::vec3(values[0], values[1], values[2]);
+			const float length = glm::length(skinnedNormal);
+			normals[i] = length > 0.0f ? skinnedNormal / length : vertex.normal;
+		}
+	}
+#else
+	void LocalToModel(const int32_t* parentIndices, const glm::mat4* localTransforms, glm::mat4* modelTransforms, size_t boneCount)
+	{
+		for (size_t i = 0; i < boneCount; ++i)
+			modelTransforms[i] = parentIndices[i] < 0 ? localTransforms[i] : modelTransforms[parentIndices[i]] * localTransforms[i];
+	}
+
+	void CalculateSkinningMatrices(const glm::mat4* modelTransforms, const glm::mat4* boneOffsets, glm::mat4* skinningMatrices, size_t boneCount)
+	{
+		for (size_t i = 0; i < boneCount; ++i)
+			skinningMatrices[i] = modelTransforms[i] * boneOffsets[i];
+	}
+
+	void SkinVertices(const Vertex* vertices, size_t vertexCount, const glm::mat4* skinningMatrices, size_t boneCount, glm::vec3* positions, glm::vec3* normals)
+	{
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			const Vertex& vertex = vertices[i];
+
+			glm::mat4 matrix(0.0f);
+			float totalWeight = 0.0f;
+			for (size_t j = 0; j < 4; ++j)
+			{
+				const float weight = vertex.boneWeights[j];
+				if (weight == 0.0f || vertex.boneIds[j] >= boneCount)
+					continue;
+
+				matrix += skinningMatrices[vertex.boneIds[j]] * weight;
+				totalWeight += weight;
+			}
+
+			if (totalWeight == 0.0f)
+			{
+				positions[i] = vertex.position;
+				normals[i] = vertex.normal;
+				continue;
+			}
+
+			positions[i] = glm::vec3(matrix * glm::vec4(vertex.position, 1.0f));
+			const glm::vec3 skinnedNormal = glm::vec3(matrix * glm::vec4(vertex.normal, 0.0f));
+			const float length = glm::length(skinnedNormal);
+			normals[i] = length > 0.0f ? skinnedNormal / length : vertex.normal;
+		}
+	}
+#endif
+
+	void BlendPoses(const BoneTransform* from, const BoneTransform* to, float weight, const float* boneWeights, BoneTransform* output, size_t boneCount)
+	{
+		for (size_t i = 0; i < boneCount; ++i)
+		{
+			const float boneWeight = boneWeights != nullptr ? weight * boneWeights[i] : weight;
+			if (boneWeight <= 0.0f)
+			{
+				output[i] = from[i];
+				continue;
+			}
+			if (boneWeight >= 1.0f)
+			{
+				output[i] = to[i];
+				continue;
+			}
+
+			// q and -q are the same rotation, flipping the target keeps the blend on the shortest path.
+			const glm::quat target = glm::dot(from[i].rotation, to[i].rotation) < 0.0f ? -to[i].rotation : to[i].rotation;
+
+			output[i].position = glm::mix(from[i].position, to[i].position, boneWeight);
+			output[i].rotation = glm::normalize(from[i].rotation * (1.0f - boneWeight) + target * boneWeight);
+			output[i].scale = glm::mix(from[i].scale, to[i].scale, boneWeight);
+		}
+	}
+
+	void ComposePose(const BoneTransform* pose, glm::mat4* localTransforms, size_t boneCount)
+	{
+		TransformBatch batch;
+		glm::mat4* outputs[TransformBatch::Capacity];
+
+		for (size_t begin = 0; begin < boneCount; begin += TransformBatch::Capacity)
+		{
+			const size_t count = boneCount - begin < TransformBatch::Capacity ? boneCount - begin : TransformBatch::Capacity;
+			for (size_t lane = 0; lane < count; ++lane)
+			{
+				const BoneTransform& transform = pose[begin + lane];
+				batch.SetTransform(lane, transform.position, transform.rotation, transform.scale);
+				outputs[lane] = &localTransforms[begin + lane];
+			}
+
+			ComposeTransforms(batch, count, outputs);
+		}
+	}
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Engine/api.hpp"
+#include "Engine/Utility/Vertex.hpp"
+
+#include <ThirdParty/glm/glm/glm.hpp>
+#include <ThirdParty/glm/glm/gtc/quaternion.hpp>
+
+namespace Engine
+{
+	/// <summary>
+	/// The transform of a bone relative to its parent, kept as separate parts so poses can be blended.
+	/// </summary>
+	struct BoneTransform
+	{
+		glm::vec3 position;
+		glm::quat rotation;
+		glm::vec3 scale;
+	};
+
+	/// <summary>
+	/// Converts the local transforms of a pose to model space, by multiplying every transform with the model transform of its parent.
+	/// The bones are stored as a flat array in which every parent comes before its children, so a single pass over the array is enough.
+	/// Uses SSE on x86 targets and plain scalar code elsewhere.
+	/// </summary>
+	/// <param name="parentIndices">The index of the parent of every bone, -1 for bones without a parent.</param>
+	/// <param name="localTransforms">The transform of every bone relative to its parent.</param>
+	/// <param name="modelTransforms">Filled with the transform of every bone relative to the model. Can't be the same array as the local transforms.</param>
+	/// <param name="boneCount">The amount of bones in the arrays.</param>
+	ENGINE_API void LocalToModel(const int32_t* parentIndices, const glm::mat4* localTransforms, glm::mat4* modelTransforms, size_t boneCount);
+
+	/// <summary>
+	/// Multiplies the model transform of every bone with the offset of the bone, the offset transforms a vertex from mesh space to the space of the bone.
+	/// </summary>
+	/// <param name="modelTransforms">The transform of every bone relative to the model, see LocalToModel.</param>
+	/// <param name="boneOffsets">The offset of every bone in the mesh.</param>
+	/// <param name="skinningMatrices">Filled with the matrix that moves a vertex along with every bone.</param>
+	/// <param name="boneCount">The amount of bones in the arrays.</param>
+	ENGINE_API void CalculateSkinningMatrices(const glm::mat4* modelTransforms, const glm::mat4* boneOffsets, glm::mat4* skinningMatrices, size_t boneCount);
+
+	/// <summary>
+	/// Deforms the vertices of a mesh on the CPU using linear blend skinning, the same way the skeletal mesh shader does on the GPU.
+	/// Every vertex is moved by the weighted sum of the skinning matrices of its four bones. Vertices without any weight keep their bind pose.
+	/// Bone ids past the amount of skinning matrices are ignored. The normals are transformed by the blended matrix and normalized.
+	/// </summary>
+	/// <param name="vertices">The vertices to deform, with the bone ids and weights assigned by the mesh.</param>
+	/// <param name="vertexCount">The amount of vertices.</param>
+	/// <param name="skinningMatrices">The skinning matrix of every bone, see CalculateSkinningMatrices.</param>
+	/// <param name="boneCount">The amount of skinning matrices.</param>
+	/// <param name="positions">Filled with the deformed position of every vertex.</param>
+	/// <param name="normals">Filled with the deformed normal of every vertex.</param>
+	ENGINE_API void SkinVertices(const Vertex* vertices, size_t vertexCount, const glm::mat4* skinningMatrices, size_t boneCount, glm::vec3* positions, glm::vec3* normals);
+
+	/// <summary>
+	/// Blends two poses bone by bone. Positions and scales are interpolated linearly, rotations along the shortest path and normalized afterwards.
+	/// </summary>
+	/// <param name="from">The pose at a weight of 0.</param>
+	/// <param name="to">The pose at a weight of 1.</param>
+	/// <param name="weight">How far to blend towards the second pose.</param>
+	/// <param name="boneWeights">Multiplies the weight of every bone, used to only blend part of the skeleton. Can be nullptr to blend every bone.</param>
+	/// <param name="output">Filled with the blended pose, can be the same array as either of the inputs.</param>
+	/// <param name="boneCount">The amount of bones in the poses.</param>
+	ENGINE_API void BlendPoses(const BoneTransform* from, const BoneTransform* to, float weight, const float* boneWeights, BoneTransform* output, size_t boneCount);
+
+	/// <summary>
+	/// Builds the local transform matrix of every bone of a pose, in batches with ComposeTransforms.
+	/// </summary>
+	/// <param name="pose">The pose to convert.</param>
+	/// <param name="localTransforms">Filled with the transform of every bone relative to its parent.</param>
+	/// <param name="boneCount">The amount of bones in the pose.</param>
+	ENGINE_API void ComposePose(const BoneTransform* pose, glm::mat4* localTransforms, size_t boneCount);
+} // namespace Engine
\ No newline at end of file
@@ -1,370 +1,252 @@
 #include "Engine/Animation/Skeleton.hpp"
 
-#include "Engine/Utility/Defines.hpp"
-
-#ifdef USING_OPENGL
-#include "Engine/Texture/OpenGLTexture.hpp"
-#endif
-#ifdef USING_VULKAN
-#include "Engine/Texture/VulkanTexture.hpp"
-#endif
-
 #include <iostream>
 #include <ThirdParty/glm/glm/gtc/matrix_transform.hpp>
 
 namespace Engine {
 
-	Skeleton::Skeleton(const aiScene* scene)
+	namespace
 	{
-		this->scene = scene;
-
-		if (scene->HasAnimations()) {
+		// The largest error the compression of the animation keys may introduce. Positions are in the units of the model file.
+		constexpr float PositionTolerance = 0.001f;
+		constexpr float RotationTolerance = 0.0005f;
+		constexpr float ScaleTolerance = 0.0001f;
 
-			animated = true;
+		glm::mat4 ConvertMatrix(const aiMatrix4x4& transform)
+		{
+			return glm::mat4(transform.a1, transform.b1, transform.c1, transform.d1,
+				transform.a2, transform.b2, transform.c2, transform.d2,
+				transform.a3, transform.b3, transform.c3, transform.d3,
+				transform.a4, transform.b4, transform.c4, transform.d4);
+		}
 
-			speed = 1.f;
+		/// <summary>
+		/// Adds the given node and its children to the bones, in an order in which every parent comes before its children.
+		/// </summary>
+		void ReadBoneData(const aiNode* node, int32_t parentIndex, SkeletonData& skeletonData)
+		{
+			const int32_t boneIndex = static_cast<int32_t>(skeletonData.bones.size());
+			skeletonData.bones.push_back();
 
-			boneData.resize(0xff, { glm::mat4() });
+			SkeletonData::Bone& bone = skeletonData.bones.back();
+			bone.name = eastl::string(node->mName.C_Str());
+			bone.parentIndex = parentIndex;
+			bone.transform = ConvertMatrix(node->mTransformation);
 
-			rootBone = new Bone_t;
+			aiVector3D position, scale;
+			aiQuaternion rotation;
+			node->mTransformation.Decompose(scale, rotation, position);
+			bone.defaultPose = BoneTransform{ glm::vec3(position.x, position.y, position.z), glm::quat(rotation.w, rotation.x, rotation.y, rotation.z), glm::vec3(scale.x, scale.y, scale.z) };
 
-			rootBone->boneDataIndex = -1;
-			rootBone->parent = nullptr;
+			for (unsigned int i = 0; i < node->mNumChildren; ++i)
+				ReadBoneData(node->mChildren[i], boneIndex, skeletonData);
+		}
 
-			ReadBones(rootBone, scene->mRootNode);
+		void ReadAnimationNode(const aiNodeAnim* node, SkeletonData::AnimationNode& animationNode)
+		{
+			// The keys are converted into temporary arrays first, only the compressed tracks are kept.
+			eastl::vector<float> times;
+			eastl::vector<glm::vec3> vectors;
+			eastl::vector<glm::quat> rotations;
+
+			times.resize(node->mNumPositionKeys);
+			vectors.resize(node->mNumPositionKeys);
+			for (unsigned int k = 0; k < node->mNumPositionKeys; ++k) {
+				times[k] = static_cast<float>(node->mPositionKeys[k].mTime);
+				vectors[k] = glm::vec3(node->mPositionKeys[k].mValue.x,
+					node->mPositionKeys[k].mValue.y,
+					node->mPositionKeys[k].mValue.z);
+			}
+			animationNode.positions.Compress(times.data(), vectors.data(), times.size(), PositionTolerance);
+
+			times.resize(node->mNumRotationKeys);
+			rotations.resize(node->mNumRotationKeys);
+			for (unsigned int k = 0; k < node->mNumRotationKeys; ++k) {
+				times[k] = static_cast<float>(node->mRotationKeys[k].mTime);
+				rotations[k] = glm::quat(node->mRotationKeys[k].mValue.w,
+					node->mRotationKeys[k].mValue.x,
+					node->mRotationKeys[k].mValue.y,
+					node->mRotationKeys[k].mValue.z);
+			}
+			animationNode.rotations.Compress(times.data(), rotations.data(), times.size(), RotationTolerance);
+
+			times.resize(node->mNumScalingKeys);
+			vectors.resize(node->mNumScalingKeys);
+			for (unsigned int k = 0; k < node->mNumScalingKeys; ++k) {
+				times[k] = static_cast<float>(node->mScalingKeys[k].mTime);
+				vectors[k] = glm::vec3(node->mScalingKeys[k].mValue.x,
+					node->mScalingKeys[k].mValue.y,
+					node->mScalingKeys[k].mValue.z);
+			}
+			animationNode.scales.Compress(times.data(), vectors.data(), times.size(), ScaleTolerance);
 
-			for (unsigned int i = 0; i < scene->mNumAnimations; ++i) {
-				Animation_t* animation = new Animation_t;
-				animation->name = eastl::string(scene->mAnimations[i]->mName.C_Str());
-				animation->duration = static_cast<float>(scene->mAnimations[i]->mDuration);
-				animation->ticksPerSecond = static_cast<float>(scene->mAnimations[i]->mTicksPerSecond);
-				
-				animations.push_back(animation);
-
-				animationMap[animation->name] = animations.size() - 1;
-
-				currentAnimationIndex = animations.size() - 1;
-
-				for (unsigned int j = 0; j < scene->mAnimations[i]->mNumChannels; ++j) {
-					AnimationNode_t animationNode = {};
-					aiNodeAnim* node = scene->mAnimations[i]->mChannels[j];
-
-					eastl::map<eastl::string, Bone_t*>::iterator it = boneMap.find(eastl::string(node->mNodeName.C_Str()));
-
-					if (it != boneMap.end()) {
-						animationNode.bone = it->second;
-					}
-					else {
-						std::cout << "[ERROR] Animation using bones not contained in skeleton" << std::endl;
-						continue;
-					}
-
-					animationNode.positionKeys.resize(node->mNumPositionKeys);
-					animationNode.rotationKeys.resize(node->mNumRotationKeys);
-					animationNode.scalingKeys.resize(node->mNumScalingKeys);
-
-					for (unsigned int k = 0; k < node->mNumPositionKeys; ++k) {
-						AnimationPositionKey_t key = {};
-						key.time = static_cast<float>(node->mPositionKeys[k].mTime);
-						key.position = glm::vec3(node->mPositionKeys[k].mValue.x,
-							node->mPositionKeys[k].mValue.y,
-							node->mPositionKeys[k].mValue.z);
-
-						animationNode.positionKeys[k] = key;
-					}
-
-					for (unsigned int k = 0; k < node->mNumRotationKeys; ++k) {
-						AnimationRotationKey_t key = {};
-						key.time = static_cast<float>(node->mRotationKeys[k].mTime);
-						key.rotation = glm::quat();
-						key.rotation.x = node->mRotationKeys[k].mValue.x;
-						key.rotation.y = node->mRotationKeys[k].mValue.y;
-						key.rotation.z = node->mRotationKeys[k].mValue.z;
-						key.rotation.w = node->mRotationKeys[k].mValue.w;
-
-						animationNode.rotationKeys[k] = key;
-					}
-
-					for (unsigned int k = 0; k < node->mNumScalingKeys; ++k) {
-						AnimationScalingKey_t key = {};
-						key.time = static_cast<float>(node->mScalingKeys[k].mTime);
-						key.scale = glm::vec3(node->mScalingKeys[k].mValue.x,
-							node->mScalingKeys[k].mValue.y,
-							node->mScalingKeys[k].mValue.z);
-
-						animationNode.scalingKeys[k] = key;
-					}
-
-					animationNode.preAnimBehaviour = node->mPreState;
-					animationNode.postAnimBehaviour = node->mPostState;
-
-					animation->nodes.push_back(animationNode);
+			animationNode.preState = static_cast<uint32_t>(node->mPreState);
+			animationNode.postState = static_cast<uint32_t>(node->mPostState);
+		}
 
-				}
+		void ReadAnimationData(const aiAnimation* animation, const eastl::map<eastl::string, uint32_t>& boneIndices, SkeletonData::Animation& animationData)
+		{
+			animationData.name = eastl::string(animation->mName.C_Str());
+			animationData.duration = static_cast<float>(animation->mDuration);
+			animationData.ticksPerSecond = static_cast<float>(animation->mTicksPerSecond);
 
-				eastl::vector<float> animationBuffer;
-				
-				currentAnimation = animation;
-
-				paused = false;
-				
-				animationBuffer.resize(static_cast<size_t>(animation->duration) * 3 * 256 * 4);
-
-				size_t currentRow = 0;
-
-				for (float t = 0.f, inc = 1.f / animation->ticksPerSecond, 
-					duration = animation->duration/animation->ticksPerSecond; 
-					t < duration; 
-					t+=inc) {
-					time = t;
-					Update(0.f);
-					
-					for (size_t j = 0, size = boneData.size(); j < size; ++j) {
-						glm::mat4 transform = boneData[j].transform;
-
-						glm::vec4 translate = transform[3];
-						transform[3] = glm::vec4(0.f, 0.f, 0.f, 1.f);
-
-						glm::vec3 scale = glm::vec3(
-							glm::length(glm::vec3(transform[0][0], transform[0][1], transform[0][2])),
-							glm::length(glm::vec3(transform[1][0], transform[1][1], transform[1][2])),
-							glm::length(glm::vec3(transform[2][0], transform[2][1], transform[2][2]))
-						);
-
-						transform[0][0] /= scale.x;
-						transform[0][1] /= scale.x;
-						transform[0][2] /= scale.x;
-						transform[1][0] /= scale.y;
-						transform[1][1] /= scale.y;
-						transform[1][2] /= scale.y;
-						transform[2][0] /= scale.z;
-						transform[2][1] /= scale.z;
-						transform[2][2] /= scale.z;
-
-						glm::quat rotation = glm::quat_cast(transform);
-
-						animationBuffer[(currentRow * 256 * 4) + j * 4] = translate.x;
-						animationBuffer[(currentRow * 256 * 4) + j * 4 + 1] = translate.y;
-						animationBuffer[(currentRow * 256 * 4) + j * 4 + 2] = translate.z;
-						animationBuffer[(currentRow * 256 * 4) + j * 4 + 3] = translate.w;
-
-						animationBuffer[((currentRow + 1) * 256 * 4) + j * 4] = scale.x;
-						animationBuffer[((currentRow + 1) * 256 * 4) + j * 4 + 1] = scale.y;
-						animationBuffer[((currentRow + 1) * 256 * 4) + j * 4 + 2] = scale.z;
-
-						animationBuffer[((currentRow + 2) * 256 * 4) + j * 4] = rotation.x;
-						animationBuffer[((currentRow + 2) * 256 * 4) + j * 4 + 1] = rotation.y;
-						animationBuffer[((currentRow + 2) * 256 * 4) + j * 4 + 2] = rotation.z;
-						animationBuffer[((currentRow + 2) * 256 * 4) + j * 4 + 3] = rotation.w;
-					}
-
-					currentRow += 3;
+			for (unsigned int i = 0; i < animation->mNumChannels; ++i) {
+				const aiNodeAnim* node = animation->mChannels[i];
 
+				eastl::map<eastl::string, uint32_t>::const_iterator it = boneIndices.find(eastl::string(node->mNodeName.C_Str()));
+				if (it == boneIndices.end()) {
+					std::cout << "[ERROR] Animation using bones not contained in skeleton" << std::endl;
+					continue;
 				}
 
-#ifdef USING_VULKAN
-				animation->texture = eastl::shared_ptr<VulkanTexture>(new VulkanTexture(256, static_cast<int>(animation->duration * 3.f)));
-				animation->texture->CreateTextureWithData(reinterpret_cast<stbi_uc*>(animationBuffer.data()), false, TextureDataSize::S_INT, true);
-
-				VkSamplerCreateInfo samplerInfo = {};
-				samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-				samplerInfo.magFilter = VK_FILTER_NEAREST;
-				samplerInfo.minFilter = VK_FILTER_NEAREST;
-				samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
-				samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-				samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-				samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-				samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-				samplerInfo.anisotropyEnable = VK_FALSE;
-				samplerInfo.compareEnable = VK_FALSE;
-				samplerInfo.unnormalizedCoordinates = VK_TRUE;
-
-				eastl::static_pointer_cast<VulkanTexture, Texture>(animation->texture)->SetSampler(samplerInfo);
-#endif
-#ifdef USING_OPENGL
-				animation->texture = eastl::shared_ptr<OpenGLTexture>(new OpenGLTexture(256, static_cast<int>(animation->duration * 3.f)));
-				animation->texture->CreateTextureWithData(reinterpret_cast<stbi_uc*>(animationBuffer.data()), false, TextureDataSize::S_INT, true);
-#endif
+				animationData.nodes.push_back();
+				animationData.nodes.back().bone = it->second;
+				ReadAnimationNode(node, animationData.nodes.back());
 			}
-
-		}
-		else {
-			animated = false;
 		}
 	}
 
-	void Skeleton::LoadAnimationSet(const aiScene * scene, eastl::vector<eastl::string> names)
+	Skeleton::Skeleton(const aiScene* scene)
 	{
-		if (scene->HasAnimations()) {
+		SkeletonData skeletonData;
+		ReadSkeletonData(scene, skeletonData);
+		Initialize(skeletonData);
 
-			for (unsigned int i = 0; i < scene->mNumAnimations; ++i) {
-				Animation_t* animation = new Animation_t;
-				if (names.size() > i) {
-					animation->name = names[i];
-					if(animation->name=="")
-						animation->name = eastl::string(scene->mAnimations[i]->mName.C_Str());
-				}
-				else {
-					animation->name = eastl::string(scene->mAnimations[i]->mName.C_Str());
-				}
-				animation->duration = static_cast<float>(scene->mAnimations[i]->mDuration);
-				animation->ticksPerSecond = static_cast<float>(scene->mAnimations[i]->mTicksPerSecond);
-				
-				animations.push_back(animation);
-
-				animationMap[animation->name] = animations.size() - 1;
-
-				currentAnimationIndex = animations.size() - 1;
-
-				for (unsigned int j = 0; j < scene->mAnimations[i]->mNumChannels; ++j) {
-					AnimationNode_t animationNode = {};
-					aiNodeAnim* node = scene->mAnimations[i]->mChannels[j];
-
-					eastl::map<eastl::string, Bone_t*>::iterator it = boneMap.find(eastl::string(node->mNodeName.C_Str()));
-
-					if (it != boneMap.end()) {
-						animationNode.bone = it->second;
-					}
-					else {
-						std::cout << "[ERROR] Animation using bones not contained in skeleton" << std::endl;
-						continue;
-					}
-
-					animationNode.positionKeys.resize(node->mNumPositionKeys);
-					animationNode.rotationKeys.resize(node->mNumRotationKeys);
-					animationNode.scalingKeys.resize(node->mNumScalingKeys);
-
-					for (unsigned int k = 0; k < node->mNumPositionKeys; ++k) {
-						AnimationPositionKey_t key = {};
-						key.time = static_cast<float>(node->mPositionKeys[k].mTime);
-						key.position = glm::vec3(node->mPositionKeys[k].mValue.x,
-							node->mPositionKeys[k].mValue.y,
-							node->mPositionKeys[k].mValue.z);
-
-						animationNode.positionKeys[k] = key;
-					}
-
-					for (unsigned int k = 0; k < node->mNumRotationKeys; ++k) {
-						AnimationRotationKey_t key = {};
-						key.time = static_cast<float>(node->mRotationKeys[k].mTime);
-						key.rotation = glm::quat();
-						key.rotation.x = node->mRotationKeys[k].mValue.x;
-						key.rotation.y = node->mRotationKeys[k].mValue.y;
-						key.rotation.z = node->mRotationKeys[k].mValue.z;
-						key.rotation.w = node->mRotationKeys[k].mValue.w;
-
-						animationNode.rotationKeys[k] = key;
-					}
-
-					for (unsigned int k = 0; k < node->mNumScalingKeys; ++k) {
-						AnimationScalingKey_t key = {};
-						key.time = static_cast<float>(node->mScalingKeys[k].mTime);
-						key.scale = glm::vec3(node->mScalingKeys[k].mValue.x,
-							node->mScalingKeys[k].mValue.y,
-							node->mScalingKeys[k].mValue.z);
-
-						animationNode.scalingKeys[k] = key;
-					}
-
-					animationNode.preAnimBehaviour = node->mPreState;
-					animationNode.postAnimBehaviour = node->mPostState;
-
-					animation->nodes.push_back(animationNode);
-
-				}
+		this->scene = scene;
+	}
 
-				eastl::vector<float> animationBuffer;
+	Skeleton::Skeleton(const SkeletonData& skeletonData)
+	{
+		Initialize(skeletonData);
 
-				currentAnimation = animation;
+		this->scene = nullptr;
+	}
 
-				paused = false;
+	void Skeleton::ReadSkeletonData(const aiScene* scene, SkeletonData& skeletonData)
+	{
+		// Only animated scenes get a skeleton with bones.
+		if (scene->HasAnimations() == false)
+			return;
 
-				animationBuffer.resize(static_cast<size_t>(animation->duration) * 3 * 256 * 4);
+		ReadBoneData(scene->mRootNode, -1, skeletonData);
 
-				size_t currentRow = 0;
+		eastl::map<eastl::string, uint32_t> boneIndices;
+		for (size_t i = 0, size = skeletonData.bones.size(); i < size; ++i)
+			boneIndices[skeletonData.bones[i].name] = static_cast<uint32_t>(i);
 
-				for (float t = 0.f, inc = 1.f / animation->ticksPerSecond,
-					duration = animation->duration / animation->ticksPerSecond;
-					t < duration;
-					t += inc) {
-					time = t;
-					Update(0.f);
+		skeletonData.animations.resize(scene->mNumAnimations);
+		for (unsigned int i = 0; i < scene->mNumAnimations; ++i)
+			ReadAnimationData(scene->mAnimations[i], boneIndices, skeletonData.animations[i]);
+	}
 
-					for (size_t i = 0, size = boneData.size(); i < size; ++i) {
-						glm::mat4 transform = boneData[i].transform;
+	void Skeleton::LoadAnimationSet(const aiScene * scene, eastl::vector<eastl::string> names)
+	{
+		if (scene->HasAnimations()) {
 
-						glm::vec4 translate = transform[3];
-						transform[3] = glm::vec4(0.f, 0.f, 0.f, 1.f);
+			eastl::map<eastl::string, uint32_t> boneIndices;
+			for (eastl::map<eastl::string, Bone_t*>::iterator it = boneMap.begin(); it != boneMap.end(); ++it)
+				boneIndices[it->first] = static_cast<uint32_t>(it->second->boneDataIndex);
 
-						glm::vec3 scale = glm::vec3(
-							glm::length(glm::vec3(transform[0][0], transform[0][1], transform[0][2])),
-							glm::length(glm::vec3(transform[1][0], transform[1][1], transform[1][2])),
-							glm::length(glm::vec3(transform[2][0], transform[2][1], transform[2][2]))
-						);
+			for (unsigned int i = 0; i < scene->mNumAnimations; ++i) {
+				SkeletonData::Animation animation;
+				ReadAnimationData(scene->mAnimations[i], boneIndices, animation);
+				if (names.size() > i && names[i] != "")
+					animation.name = names[i];
 
-						transform[0][0] /= scale.x;
-						transform[0][1] /= scale.x;
-						transform[0][2] /= scale.x;
-						transform[1][0] /= scale.y;
-						transform[1][1] /= scale.y;
-						transform[1][2] /= scale.y;
-						transform[2][0] /= scale.z;
-						transform[2][1] /= scale.z;
-						transform[2][2] /= scale.z;
+				AddAnimation(animation);
+			}
 
-						glm::quat rotation = glm::quat_cast(transform);
+		}
+		else {
+			std::cout << "[WARNING] No animations detected in file" << std::endl;
+		}
+	}
 
-						animationBuffer[(currentRow * 256 * 4) + i * 4] = translate.x;
-						animationBuffer[(currentRow * 256 * 4) + i * 4 + 1] = translate.y;
-						animationBuffer[(currentRow * 256 * 4) + i * 4 + 2] = translate.z;
-						animationBuffer[(currentRow * 256 * 4) + i * 4 + 3] = translate.w;
+	void Skeleton::Initialize(const SkeletonData& skeletonData)
+	{
+		rootBone = nullptr;
+		maxBoneDepth = 0;
 
-						animationBuffer[((currentRow + 1) * 256 * 4) + i * 4] = scale.x;
-						animationBuffer[((currentRow + 1) * 256 * 4) + i * 4 + 1] = scale.y;
-						animationBuffer[((currentRow + 1) * 256 * 4) + i * 4 + 2] = scale.z;
+		if (skeletonData.animations.empty()) {
+			animated = false;
+			return;
+		}
 
-						animationBuffer[((currentRow + 2) * 256 * 4) + i * 4] = rotation.x;
-						animationBuffer[((currentRow + 2) * 256 * 4) + i * 4 + 1] = rotation.y;
-						animationBuffer[((currentRow + 2) * 256 * 4) + i * 4 + 2] = rotation.z;
-						animationBuffer[((currentRow + 2) * 256 * 4) + i * 4 + 3] = rotation.w;
-					}
+		animated = true;
 
-					currentRow += 3;
+		speed = 1.f;
 
-				}
+		boneData.resize(0xff, glm::mat4());
 
-#ifdef USING_VULKAN
-				animation->texture = eastl::shared_ptr<VulkanTexture>(new VulkanTexture(256, static_cast<int>(animation->duration * 3.f)));
-				animation->texture->CreateTextureWithData(reinterpret_cast<stbi_uc*>(animationBuffer.data()), false, TextureDataSize::S_INT, true);
-
-				VkSamplerCreateInfo samplerInfo = {};
-				samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-				samplerInfo.magFilter = VK_FILTER_NEAREST;
-				samplerInfo.minFilter = VK_FILTER_NEAREST;
-				samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
-				samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-				samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-				samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-				samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-				samplerInfo.anisotropyEnable = VK_FALSE;
-				samplerInfo.compareEnable = VK_FALSE;
-				samplerInfo.unnormalizedCoordinates = VK_TRUE;
-
-				eastl::static_pointer_cast<VulkanTexture, Texture>(animation->texture)->SetSampler(samplerInfo);
-#endif
-#ifdef USING_OPENGL
-				animation->texture = eastl::shared_ptr<OpenGLTexture>(new OpenGLTexture(256, static_cast<int>(animation->duration * 3.f)));
-				animation->texture->CreateTextureWithData(reinterpret_cast<stbi_uc*>(animationBuffer.data()), false, TextureDataSize::S_INT, true);
-#endif
+		CreateBones(skeletonData);
 
-			}
+		for (size_t i = 0, size = skeletonData.animations.size(); i < size; ++i)
+			AddAnimation(skeletonData.animations[i]);
+	}
 
+	void Skeleton::CreateBones(const SkeletonData& skeletonData)
+	{
+		for (size_t i = 0, size = skeletonData.bones.size(); i < size; ++i) {
+			const SkeletonData::Bone& boneDescription = skeletonData.bones[i];
+
+			Bone_t* bone = new Bone_t;
+			bone->name = boneDescription.name;
+			bone->boneDataIndex = static_cast<int>(i);
+			bone->transform = boneDescription.transform;
+			bone->defaultTransform = boneDescription.transform;
+			bone->node = nullptr;
+
+			// Every parent comes before its children, so the parent already exists and the children keep their order.
+			bone->parent = boneDescription.parentIndex >= 0 ? bones[boneDescription.parentIndex] : nullptr;
+			if (bone->parent != nullptr)
+				bone->parent->childBones.push_back(bone);
+
+			if (i < boneData.size())
+				boneData[i] = boneDescription.transform;
+
+			boneMap[bone->name] = bone;
+
+			bones.push_back(bone);
+			parentIndices.push_back(boneDescription.parentIndex);
+			boneDepths.push_back(boneDescription.parentIndex >= 0 ? boneDepths[boneDescription.parentIndex] + 1 : 0);
+			maxBoneDepth = eastl::max(maxBoneDepth, boneDepths.back());
+			defaultTransforms.push_back(bone->defaultTransform);
+			defaultPose.push_back(boneDescription.defaultPose);
+			localTransforms.push_back(bone->transform);
 		}
-		else {
-			std::cout << "[WARNING] No animations detected in file" << std::endl;
-		}
+
+		rootBone = bones.empty() ? nullptr : bones.front();
 	}
 
+	void Skeleton::AddAnimation(const SkeletonData::Animation& animationData)
+	{
+		Animation_t* animation = new Animation_t;
+		animation->name = animationData.name;
+		animation->duration = animationData.duration;
+		animation->ticksPerSecond = animationData.ticksPerSecond;
+
+		animations.push_back(animation);
+
+		animationMap[animation->name] = animations.size() - 1;
+
+		currentAnimationIndex = animations.size() - 1;
+
+		animation->nodes.resize(animationData.nodes.size());
+		for (size_t i = 0, size = animationData.nodes.size(); i < size; ++i) {
+			const SkeletonData::AnimationNode& nodeData = animationData.nodes[i];
+			AnimationNode_t& node = animation->nodes[i];
+			node.bone = bones[nodeData.bone];
+			node.positions = nodeData.positions;
+			node.rotations = nodeData.rotations;
+			node.scales = nodeData.scales;
+			node.preAnimBehaviour = static_cast<aiAnimBehaviour>(nodeData.preState);
+			node.postAnimBehaviour = static_cast<aiAnimBehaviour>(nodeData.postState);
+		}
+
+		currentAnimation = animation;
+
+		paused = false;
+	}
 
 	Skeleton::~Skeleton()
 	{
@@ -373,7 +255,6 @@ namespace Engine {
 			delete bone.second;
 		}
 		for (size_t i = 0, size = animations.size(); i < size; ++i) {
-			animations[i]->texture.reset();
 			delete animations[i];
 		}
 	}
@@ -405,7 +286,10 @@ namespace Engine {
 
 	void Skeleton::UpdateBoneTreeTransformData()
 	{
-		UpdateBoneTransformData(rootBone);
+		for (size_t i = 0, size = bones.size(); i < size; ++i)
+			localTransforms[i] = bones[i]->transform;
+
+		LocalToModel(parentIndices.data(), localTransforms.data(), boneData.data(), bones.size());
 		UpdateBoneBuffers();
 	}
 
@@ -413,116 +297,80 @@ namespace Engine {
 	{
 	}
 
-	glm::mat4 Skeleton::InterpolateScale(float time, AnimationNode_t node)
+	glm::mat4 Skeleton::InterpolateScale(float ticks, const AnimationNode_t& node, uint32_t& key) const
 	{
-		glm::vec3 scale;
-
-		time *= currentAnimation->ticksPerSecond*speed;
-
-		if (node.scalingKeys.size() == 1) {
-			scale = node.scalingKeys[0].scale;
-		}
-		else {
-			size_t frameIndex = 0;
-			for (size_t i = 0, size = node.scalingKeys.size(); i < size - 1; ++i) {
-				if (time < node.scalingKeys[i + 1].time) {
-					frameIndex = i;
-					break;
-				}
-			}
-
-			AnimationScalingKey_t currFrame = node.scalingKeys[frameIndex];
-			AnimationScalingKey_t nextFrame;
-			if (frameIndex + 1 == node.scalingKeys.size()) {
-				nextFrame = node.scalingKeys[frameIndex];
-			}
-			else {
-				nextFrame = node.scalingKeys[frameIndex + 1];
-			}
-
-			float delta = (time - currFrame.time) / (nextFrame.time - currFrame.time);
-
-			delta = fmaxf(0.f, fminf(delta, 1.f));
-
-			scale = glm::mix(currFrame.scale, nextFrame.scale, delta);
-		}
+		const glm::vec3 scale = node.scales.Sample(ticks, key, glm::vec3(1.f));
 		return glm::scale(glm::mat4(), scale);
 	}
 
-	glm::mat4 Skeleton::InterpolateRotation(float time, AnimationNode_t node)
+	glm::mat4 Skeleton::InterpolateRotation(float ticks, const AnimationNode_t& node, uint32_t& key) const
 	{
-		glm::quat rotation;
-
-		time *= currentAnimation->ticksPerSecond*speed;
-
-		if (node.rotationKeys.size() == 1) {
-			rotation = node.rotationKeys[0].rotation;
-		}
-		else {
-			size_t frameIndex = 0;
-			for (size_t i = 0, size = node.rotationKeys.size(); i < size - 1; ++i) {
-				if (time < node.rotationKeys[i + 1].time) {
-					frameIndex = i;
-					break;
-				}
-			}
-
-			AnimationRotationKey_t currFrame = node.rotationKeys[frameIndex];
-			AnimationRotationKey_t nextFrame;
-			if (frameIndex + 1 == node.rotationKeys.size()) {
-				nextFrame = node.rotationKeys[frameIndex];
-			}
-			else {
-				nextFrame = node.rotationKeys[frameIndex + 1];
-			}
-
-			float delta = (time - currFrame.time) / (nextFrame.time - currFrame.time);
+		const glm::quat rotation = node.rotations.Sample(ticks, key, glm::quat());
+		return glm::mat4_cast(rotation);
+	}
 
-			delta = fmaxf(0.f, fminf(delta, 1.f));
+	glm::mat4 Skeleton::InterpolatePosition(float ticks, const AnimationNode_t& node, uint32_t& key) const
+	{
+		const glm::vec3 position = node.positions.Sample(ticks, key, glm::vec3(0.f));
+		return glm::translate(glm::mat4(), position);
+	}
 
-			rotation = glm::lerp(currFrame.rotation, nextFrame.rotation, delta);
+	void Skeleton::SampleAnimation(size_t animation, float time, AnimationCursor& cursor, eastl::vector<glm::mat4>& transforms) const
+	{
+		if (animation >= animations.size())
+			return;
 
+		const Animation_t* sampledAnimation = animations[animation];
+		if (cursor.animation != animation) {
+			cursor.animation = animation;
+			cursor.keys.assign(sampledAnimation->nodes.size() * 3, 0);
 		}
 
-		return glm::mat4_cast(rotation);
+		const float ticks = time * sampledAnimation->ticksPerSecond * speed;
+		for (size_t i = 0, size = sampledAnimation->nodes.size(); i < size; ++i) {
+			const AnimationNode_t& node = sampledAnimation->nodes[i];
+			transforms[node.bone->boneDataIndex] = InterpolatePosition(ticks, node, cursor.keys[i * 3]) *
+				InterpolateRotation(ticks, node, cursor.keys[i * 3 + 1]) *
+				InterpolateScale(ticks, node, cursor.keys[i * 3 + 2]);
+		}
 	}
-
-	glm::mat4 Skeleton::InterpolatePosition(float time, AnimationNode_t node)
+	
+	void Skeleton::SamplePose(size_t animation, float time, AnimationCursor& cursor, eastl::vector<BoneTransform>& pose, uint32_t maxBoneDepth) const
 	{
-		glm::vec3 position;
-
-		time *= currentAnimation->ticksPerSecond*speed;
+		pose.assign(defaultPose.begin(), defaultPose.end());
+		if (animation >= animations.size())
+			return;
 
-		if (node.positionKeys.size() == 1) {
-			position = node.positionKeys[0].position;
+		const Animation_t* sampledAnimation = animations[animation];
+		if (cursor.animation != animation) {
+			cursor.animation = animation;
+			cursor.keys.assign(sampledAnimation->nodes.size() * 3, 0);
 		}
-		else {
-			size_t frameIndex = 0;
-			for (size_t i = 0, size = node.positionKeys.size(); i < size - 1; ++i) {
-				if (time < node.positionKeys[i + 1].time) {
-					frameIndex = i;
-					break;
-				}
-			}
 
-			AnimationPositionKey_t currFrame = node.positionKeys[frameIndex];
-			AnimationPositionKey_t nextFrame;
-			if (frameIndex + 1 == node.positionKeys.size()) {
-				nextFrame = node.positionKeys[frameIndex];
-			}
-			else {
-				nextFrame = node.positionKeys[frameIndex + 1];
-			}
+		const float ticks = time * sampledAnimation->ticksPerSecond * speed;
+		for (size_t i = 0, size = sampledAnimation->nodes.size(); i < size; ++i) {
+			const AnimationNode_t& node = sampledAnimation->nodes[i];
+			if (boneDepths[node.bone->boneDataIndex] > maxBoneDepth)
+				continue;
 
-			float delta = (time - currFrame.time) / (nextFrame.time - currFrame.time);
+			BoneTransform& transform = pose[node.bone->boneDataIndex];
+			transform.position = node.positions.Sample(ticks, cursor.keys[i * 3], glm::vec3(0.f));
+			transform.rotation = node.rotations.Sample(ticks, cursor.keys[i * 3 + 1], glm::quat());
+			transform.scale = node.scales.Sample(ticks, cursor.keys[i * 3 + 2], glm::vec3(1.f));
+		}
+	}
 
-			delta = fmaxf(0.f, fminf(delta, 1.f));
+	const eastl::vector<BoneTransform>& Skeleton::GetDefaultPose() const
+	{
+		return defaultPose;
+	}
 
-			position = glm::mix(currFrame.position, nextFrame.position, delta);
-		}
-		return glm::translate(glm::mat4(), position);
+	int32_t Skeleton::GetBoneIndex(const eastl::string& name) const
+	{
+		eastl::map<eastl::string, Bone_t*>::const_iterator it = boneMap.find(name);
+		return it != boneMap.end() ? static_cast<int32_t>(it->second->boneDataIndex) : -1;
 	}
-	
+
 	float Skeleton::GetAnimationDuration(size_t animation)
 	{
 		if (animation < animations.size()) {
@@ -546,12 +394,19 @@ namespace Engine {
 
 		if (currentAnimation != nullptr) {
 
+			// The skeleton keeps its own cursor, the snapshots of an animation are sampled in order.
+			if (cursor.animation != currentAnimationIndex || cursor.keys.size() != currentAnimation->nodes.size() * 3) {
+				cursor.animation = currentAnimationIndex;
+				cursor.keys.assign(currentAnimation->nodes.size() * 3, 0);
+			}
+
+			const float ticks = time * currentAnimation->ticksPerSecond * speed;
 			for (size_t i = 0, size = currentAnimation->nodes.size(); i < size; ++i) {
-				Bone_t* bone = currentAnimation->nodes[i].bone;
+				const AnimationNode_t& node = currentAnimation->nodes[i];
 
-				bone->transform = InterpolatePosition(time, currentAnimation->nodes[i])*
-					InterpolateRotation(time, currentAnimation->nodes[i])*
-					InterpolateScale(time, currentAnimation->nodes[i]);
+				node.bone->transform = InterpolatePosition(ticks, node, cursor.keys[i * 3]) *
+					InterpolateRotation(ticks, node, cursor.keys[i * 3 + 1]) *
+					InterpolateScale(ticks, node, cursor.keys[i * 3 + 2]);
 			}
 
 		}
@@ -570,16 +425,6 @@ namespace Engine {
 		return animated;
 	}
 
-	Texture* Skeleton::GetAnimationData(size_t animation)
-	{
-		if (animation < animations.size()) {
-			return animations[animation]->texture.get();
-		}
-		else {
-			return nullptr;
-		}
-	}
-
 	size_t Skeleton::GetAnimationIndex(eastl::string animation)
 	{
 		eastl::map<eastl::string, size_t>::iterator it = animationMap.find(animation);
@@ -612,39 +457,39 @@ namespace Engine {
 		return rootBone;
 	}
 
-	void Skeleton::SetName(eastl::string name)
+	void Skeleton::EvaluatePose(size_t animation, float time, AnimationCursor& cursor, eastl::vector<glm::mat4>& localTransforms, eastl::vector<glm::mat4>& modelTransforms) const
 	{
-		this->name = name;
+		// Assigning to vectors of the same size doesn't allocate, so evaluating an instance every frame doesn't either.
+		localTransforms.assign(defaultTransforms.begin(), defaultTransforms.end());
+		modelTransforms.resize(bones.size());
+
+		SampleAnimation(animation, time, cursor, localTransforms);
+		LocalToModel(parentIndices.data(), localTransforms.data(), modelTransforms.data(), bones.size());
 	}
 
-	eastl::string Skeleton::GetName()
+	size_t Skeleton::GetBoneCount() const
 	{
-		return name;
+		return bones.size();
 	}
 
-	void Skeleton::ReadBones(Bone_t * bone, aiNode * node)
+	uint32_t Skeleton::GetMaxBoneDepth() const
 	{
-		bone->childBones.resize(static_cast<size_t>(node->mNumChildren));
-
-		bone->name = eastl::string(node->mName.C_Str());
-
-		bone->node = node;
-
-		bone->boneDataIndex = static_cast<int>(boneMap.size());
+		return maxBoneDepth;
+	}
 
-		boneData[bone->boneDataIndex].transform = TransformToMat4(node->mTransformation);
+	const eastl::vector<int32_t>& Skeleton::GetParentIndices() const
+	{
+		return parentIndices;
+	}
 
-		bone->transform = TransformToMat4(node->mTransformation);
-		bone->defaultTransform = bone->transform;
-		
-		boneMap[bone->name] = bone;
+	void Skeleton::SetName(eastl::string name)
+	{
+		this->name = name;
+	}
 
-		for (size_t i = 0, size = bone->childBones.size(); i < size; ++i) {
-			bone->childBones[i] = new Bone_t;
-			bone->childBones[i]->parent = bone;
-			bone->childBones[i]->boneDataIndex = -1;
-			ReadBones(bone->childBones[i], node->mChildren[i]);
-		}
+	eastl::string Skeleton::GetName()
+	{
+		return name;
 	}
 
 	void Skeleton::DestroyBone(Bone_t * bone)
@@ -668,25 +513,4 @@ namespace Engine {
 		bone->transform = transform;
 	}
 
-	void Skeleton::UpdateBoneTransformData(Bone_t * bone)
-	{
-		if (bone->parent != nullptr) {
-			boneData[bone->boneDataIndex].transform = boneData[bone->parent->boneDataIndex].transform * bone->transform;
-		}
-		else {
-			boneData[bone->boneDataIndex].transform = bone->transform;
-		}
-
-		for (size_t i = 0, size = bone->childBones.size(); i < size; ++i) {
-			UpdateBoneTransformData(bone->childBones[i]);
-		}
-	}
-
-	glm::mat4 Skeleton::TransformToMat4(aiMatrix4x4 transform) {
-		return glm::mat4(transform.a1, transform.b1, transform.c1, transform.d1,
-			transform.a2, transform.b2, transform.c2, transform.d2,
-			transform.a3, transform.b3, transform.c3, transform.d3,
-			transform.a4, transform.b4, transform.c4, transform.d4);
-	}
-
 }
\ No newline at end of file
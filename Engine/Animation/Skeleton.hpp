@@ -10,7 +10,9 @@
 #include <ThirdParty/EASTL-master/include/EASTL/vector.h>
 #include <ThirdParty/EASTL-master/include/EASTL/map.h>
 
-#include "Engine/Texture/Texture.hpp"
+#include "Engine/Animation/AnimationTrack.hpp"
+#include "Engine/Animation/Pose.hpp"
+#include "Engine/Animation/SkeletonData.hpp"
 
 namespace Engine {
 
@@ -27,6 +29,20 @@ namespace Engine {
 		/// <param name="scene">scene containing the model skeleton and animation data.</param>
 		Skeleton(const aiScene* scene);
 
+		/// <summary>
+		/// Creates a new animation data object from skeleton data that has been read before, like the skeleton stored in a model cache.
+		/// </summary>
+		/// <param name="skeletonData">The bones and animations of the skeleton.</param>
+		explicit Skeleton(const SkeletonData& skeletonData);
+
+		/// <summary>
+		/// Reads the bones and animations of a scene, compressing the animation keys. Doesn't create any GPU resources, so it is safe to call from any thread.
+		/// Scenes without animations are left empty, like the skeleton created from them.
+		/// </summary>
+		/// <param name="scene">The scene containing the model skeleton and animation data.</param>
+		/// <param name="skeletonData">Filled with the bones and animations of the scene.</param>
+		static void ReadSkeletonData(const aiScene* scene, SkeletonData& skeletonData);
+
 		/// <summary>
 		/// Loads in animation data form the provided scene.
 		/// If the animation data does not match the skeleton of the model (using bone names that are not in the skeleton)
@@ -69,17 +85,10 @@ namespace Engine {
 		bool HasAnimations();
 
 		/// <summary>
-		/// Returns a texture containing the animation snapshots for the current animation.
+		/// Returns the index of the animation with the given name.
 		/// </summary>
-		/// <param name="animation">The animation to get the data for.</param>
-		/// <returns>A shared pointer to a texture containing the data.</returns>
-		Texture* GetAnimationData(size_t animation);
-
-		/// <summary>
-		/// Returns a texture containing the animation snapshots for the current animation.
-		/// </summary>
-		/// <param name="animation">The name of the animation to get the data for.</param>
-		/// <returns>A shared pointer to a texture containing the data.</returns>
+		/// <param name="animation">The name of the animation.</param>
+		/// <returns>The index of the animation, or -1 if the skeleton has no animation with that name.</returns>
 		size_t GetAnimationIndex(eastl::string animation);
 
 		/// <summary>
@@ -90,6 +99,74 @@ namespace Engine {
 		/// <returns>The number of ticks per second as a float.</returns>
 		float GetAnimationTicksPerSecond(size_t animation);
 
+		/// <summary>
+		/// Remembers the keys an animation was last sampled at. Every animated instance keeps its own cursor,
+		/// when the animation plays forward the next keys are found without searching.
+		/// </summary>
+		struct AnimationCursor {
+			size_t animation = size_t(-1);
+			eastl::vector<uint32_t> keys; // The position, rotation and scale key of every animation node
+		};
+
+		/// <summary>
+		/// Samples the local transform of every animated bone of an animation. Doesn't change the skeleton, so instances can be sampled from any thread.
+		/// </summary>
+		/// <param name="animation">The index of the animation to sample.</param>
+		/// <param name="time">The time in the animation in seconds.</param>
+		/// <param name="cursor">The cursor of the sampled instance, reset when it was last used for another animation.</param>
+		/// <param name="transforms">The local transform of every bone by bone data index. Only the transforms of the animated bones are written.</param>
+		void SampleAnimation(size_t animation, float time, AnimationCursor& cursor, eastl::vector<glm::mat4>& transforms) const;
+
+		/// <summary>
+		/// Evaluates the pose of an animation on the CPU, for attachments, hitboxes and skinning without the GPU.
+		/// Samples the animated bones, uses the default transform for the others, and converts the transforms to model space with LocalToModel.
+		/// Doesn't change the skeleton, so instances can be evaluated from any thread.
+		/// </summary>
+		/// <param name="animation">The index of the animation to evaluate, an invalid index evaluates the default pose.</param>
+		/// <param name="time">The time in the animation in seconds.</param>
+		/// <param name="cursor">The cursor of the evaluated instance.</param>
+		/// <param name="localTransforms">Filled with the transform of every bone relative to its parent, by bone data index.</param>
+		/// <param name="modelTransforms">Filled with the transform of every bone relative to the model, by bone data index.</param>
+		void EvaluatePose(size_t animation, float time, AnimationCursor& cursor, eastl::vector<glm::mat4>& localTransforms, eastl::vector<glm::mat4>& modelTransforms) const;
+
+		/// <summary>
+		/// Samples an animation into a pose that can be blended, see BlendPoses. The bones that aren't animated get their default transform.
+		/// Doesn't change the skeleton, so instances can be sampled from any thread.
+		/// </summary>
+		/// <param name="animation">The index of the animation to sample, an invalid index samples the default pose.</param>
+		/// <param name="time">The time in the animation in seconds.</param>
+		/// <param name="cursor">The cursor of the sampled instance.</param>
+		/// <param name="pose">Filled with the transform of every bone relative to its parent, by bone data index.</param>
+		/// <param name="maxBoneDepth">Bones deeper in the skeleton than this keep their default transform, the root has a depth of 0. Used to animate distant instances with fewer bones.</param>
+		void SamplePose(size_t animation, float time, AnimationCursor& cursor, eastl::vector<BoneTransform>& pose, uint32_t maxBoneDepth = UINT32_MAX) const;
+
+		/// <summary>
+		/// Returns the default transform of every bone relative to its parent, by bone data index.
+		/// </summary>
+		const eastl::vector<BoneTransform>& GetDefaultPose() const;
+
+		/// <summary>
+		/// Returns the bone data index of the bone with the given name.
+		/// </summary>
+		/// <param name="name">The name of the bone.</param>
+		/// <returns>The index of the bone, -1 if the skeleton doesn't contain a bone with the given name.</returns>
+		int32_t GetBoneIndex(const eastl::string& name) const;
+
+		/// <summary>
+		/// Returns the amount of bones in the skeleton.
+		/// </summary>
+		size_t GetBoneCount() const;
+
+		/// <summary>
+		/// Returns the depth of the deepest bone in the skeleton, the root has a depth of 0.
+		/// </summary>
+		uint32_t GetMaxBoneDepth() const;
+
+		/// <summary>
+		/// Returns the index of the parent of every bone by bone data index, -1 for the root. Every parent comes before its children.
+		/// </summary>
+		const eastl::vector<int32_t>& GetParentIndices() const;
+
 		/// <summary>
 		/// A structure containing information a bone.
 		/// </summary>
@@ -137,40 +214,29 @@ namespace Engine {
 			eastl::vector<struct AnimationNode> nodes;
 			float duration; // In ticks
 			float ticksPerSecond;
-			eastl::shared_ptr<Texture> texture;
 		}Animation_t;
 
-		typedef struct {
-			glm::mat4 transform;
-		}BoneData_t;
-
-		typedef struct {
-			float time;
-			glm::vec3 position;
-		}AnimationPositionKey_t;
-
-		typedef struct {
-			float time;
-			glm::quat rotation;
-		}AnimationRotationKey_t;
-
-		typedef struct {
-			float time;
-			glm::vec3 scale;
-		}AnimationScalingKey_t;
-
 		typedef struct AnimationNode {
 			Bone_t* bone;
-			eastl::vector<AnimationPositionKey_t> positionKeys;
-			eastl::vector<AnimationRotationKey_t> rotationKeys;
-			eastl::vector<AnimationScalingKey_t>	scalingKeys;
+			VectorTrack positions;
+			RotationTrack rotations;
+			VectorTrack scales;
 			aiAnimBehaviour preAnimBehaviour;
 			aiAnimBehaviour postAnimBehaviour;
 		}AnimationNode_t;
 
 		Bone_t * rootBone;
 
-		eastl::vector<BoneData_t> boneData;
+		eastl::vector<glm::mat4> boneData; // The model transform of every bone, by bone data index
+
+		// The bones as flat arrays by bone data index, every parent comes before its children.
+		eastl::vector<Bone_t*> bones;
+		eastl::vector<int32_t> parentIndices;
+		eastl::vector<uint32_t> boneDepths;
+		uint32_t maxBoneDepth;
+		eastl::vector<glm::mat4> defaultTransforms;
+		eastl::vector<BoneTransform> defaultPose;
+		eastl::vector<glm::mat4> localTransforms;
 
 		eastl::map<eastl::string, size_t> animationMap;
 
@@ -194,7 +260,16 @@ namespace Engine {
 
 		eastl::string name;
 
-		void ReadBones(Bone_t* bone, aiNode* node);
+		AnimationCursor cursor;
+
+		void Initialize(const SkeletonData& skeletonData);
+
+		void CreateBones(const SkeletonData& skeletonData);
+
+		/// <summary>
+		/// Adds an animation. The keys are kept as compressed tracks and sampled on the CPU, see SamplePose.
+		/// </summary>
+		void AddAnimation(const SkeletonData::Animation& animationData);
 
 		void DestroyBone(Bone_t* bone);
 
@@ -202,19 +277,15 @@ namespace Engine {
 
 		void SetBoneTransform(Bone_t* bone, glm::mat4 transform);
 
-		void UpdateBoneTransformData(Bone_t* bone);
-
 		void UpdateBoneTreeTransformData();
 
 		void Update(float deltaTime);
 
 		virtual void UpdateBoneBuffers();
 
-		glm::mat4 InterpolateScale(float time, AnimationNode_t node);
-		glm::mat4 InterpolateRotation(float time, AnimationNode_t node);
-		glm::mat4 InterpolatePosition(float time, AnimationNode_t node);
-
-		glm::mat4 TransformToMat4(aiMatrix4x4 transform);
+		glm::mat4 InterpolateScale(float ticks, const AnimationNode_t& node, uint32_t& key) const;
+		glm::mat4 InterpolateRotation(float ticks, const AnimationNode_t& node, uint32_t& key) const;
+		glm::mat4 InterpolatePosition(float ticks, const AnimationNode_t& node, uint32_t& key) const;
 	};
 
 }
\ No newline at end of file
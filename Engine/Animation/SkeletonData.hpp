@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Engine/api.hpp"
+#include "Engine/Animation/AnimationTrack.hpp"
+#include "Engine/Animation/Pose.hpp"
+
+#include <ThirdParty/glm/glm/glm.hpp>
+
+#include <ThirdParty/EASTL-master/include/EASTL/string.h>
+#include <ThirdParty/EASTL-master/include/EASTL/vector.h>
+
+namespace Engine
+{
+	/// <summary>
+	/// Everything a skeleton is created from, without any Assimp types. Read from a model file or from its baked cache, see ModelCache.
+	/// </summary>
+	struct SkeletonData
+	{
+		struct Bone
+		{
+			eastl::string name;
+			int32_t parentIndex;			/// -1 for the root
+			glm::mat4 transform;			/// The default transform relative to the parent
+			BoneTransform defaultPose;		/// The same transform split up into its parts
+		};
+
+		struct AnimationNode
+		{
+			uint32_t bone;					/// The index of the animated bone
+			uint32_t preState;				/// The aiAnimBehaviour before the first key
+			uint32_t postState;				/// The aiAnimBehaviour after the last key
+			VectorTrack positions;
+			RotationTrack rotations;
+			VectorTrack scales;
+		};
+
+		struct Animation
+		{
+			eastl::string name;
+			float duration;					/// In ticks
+			float ticksPerSecond;
+			eastl::vector<AnimationNode> nodes;
+		};
+
+		eastl::vector<Bone> bones;			/// Every parent comes before its children
+		eastl::vector<Animation> animations;
+	};
+} // namespace Engine
\ No newline at end of file
@@ -1,33 +1,68 @@
 #include "Engine/Collision/CollisionCallback.hpp"
 
-#include "Engine/engine.hpp"
+#include "Engine/Components/CollisionComponent.hpp"
 
 namespace Engine {
 
 	void EntityContact::BeginContact(b2Contact* contact)
 	{
-		GetEntities(contact);
-
-		entityA_.lock()->OnBeginContact(entityB_);
-		entityB_.lock()->OnBeginContact(entityA_);
+		CollisionComponent* componentA = static_cast<CollisionComponent*>(contact->GetFixtureA()->GetUserData());
+		CollisionComponent* componentB = static_cast<CollisionComponent*>(contact->GetFixtureB()->GetUserData());
+		contacts_.push_back(ContactEvent{ componentA, componentB, true });
 	}
 
 	void EntityContact::EndContact(b2Contact* contact)
 	{
-		GetEntities(contact);
-
-		entityA_.lock()->OnEndContact(entityB_);
-		entityB_.lock()->OnEndContact(entityA_);
+		CollisionComponent* componentA = static_cast<CollisionComponent*>(contact->GetFixtureA()->GetUserData());
+		CollisionComponent* componentB = static_cast<CollisionComponent*>(contact->GetFixtureB()->GetUserData());
+		contacts_.push_back(ContactEvent{ componentA, componentB, false });
 	}
 
-	void EntityContact::GetEntities(b2Contact* contact)
+	void EntityContact::DispatchContacts()
 	{
-		eastl::weak_ptr<EntitySystem> entitySystem = Engine::GetEngine().lock()->GetEntitySystem();
+		// Contacts buffered by the callbacks are picked up by the loop below.
+		if (isDispatching_)
+			return;
+
+		isDispatching_ = true;
+
+		// The callbacks can add contacts, so the contact is copied and the size is checked every iteration.
+		for (size_t i = 0; i < contacts_.size(); ++i)
+		{
+			const ContactEvent contactEvent = contacts_[i];
 
-		const uint64_t entityIdA = uint64_t(contact->GetFixtureA()->GetUserData());
-		const uint64_t entityIdB = uint64_t(contact->GetFixtureB()->GetUserData());
+			// Holding on to both entities keeps them alive while the callbacks run.
+			const eastl::shared_ptr<Entity> entityA = contactEvent.componentA != nullptr ? contactEvent.componentA->GetOwner().lock() : nullptr;
+			const eastl::shared_ptr<Entity> entityB = contactEvent.componentB != nullptr ? contactEvent.componentB->GetOwner().lock() : nullptr;
 
-		entityA_ = entitySystem.lock()->GetEntity(entityIdA);
-		entityB_ = entitySystem.lock()->GetEntity(entityIdB);
+			if (contactEvent.isBeginContact)
+			{
+				if (entityA != nullptr && entityA->HasContactListeners())
+					entityA->OnBeginContact(entityB);
+				if (entityB != nullptr && entityB->HasContactListeners())
+					entityB->OnBeginContact(entityA);
+			}
+			else
+			{
+				if (entityA != nullptr && entityA->HasContactListeners())
+					entityA->OnEndContact(entityB);
+				if (entityB != nullptr && entityB->HasContactListeners())
+					entityB->OnEndContact(entityA);
+			}
+		}
+
+		contacts_.clear();
+		isDispatching_ = false;
+	}
+
+	void EntityContact::RemoveComponent(const CollisionComponent* component)
+	{
+		for (size_t i = 0, size = contacts_.size(); i < size; ++i)
+		{
+			if (contacts_[i].componentA == component)
+				contacts_[i].componentA = nullptr;
+			if (contacts_[i].componentB == component)
+				contacts_[i].componentB = nullptr;
+		}
 	}
 } // namespace Engine
\ No newline at end of file
@@ -3,20 +3,47 @@
 #include "Engine/Entity/Entity.hpp"
 
 #include <ThirdParty/Box2D/Box2D/Box2D.h>
+#include <ThirdParty/EASTL-master/include/EASTL/vector.h>
 
 namespace Engine
 {
 	class CollisionSystem;
+	class CollisionComponent;
 
+	/// <summary>
+	/// Buffers the contacts Box2D reports during a step of the collision world, the collision system dispatches them after the step.
+	/// The fixtures store their collision component, so no entity has to be looked up while Box2D is stepping.
+	/// </summary>
 	class EntityContact : public b2ContactListener
 	{
+		friend class CollisionSystem;
+
 		void BeginContact(b2Contact* contact) override;
 
 		void EndContact(b2Contact* contact) override;
 
-		void GetEntities(b2Contact* contact);
+		/// <summary>
+		/// Calls OnBeginContact and OnEndContact on the entities of every buffered contact, then empties the buffer.
+		/// NOTE: Contacts buffered by the callbacks themselves are dispatched in the same call.
+		/// </summary>
+		void DispatchContacts();
+
+		/// <summary>
+		/// Removes the given component from the buffered contacts, needs to be called when its collision-body is destroyed.
+		/// </summary>
+		void RemoveComponent(const CollisionComponent* component);
+
+		/// <summary>
+		/// A contact that has started or ended during the last step.
+		/// </summary>
+		struct ContactEvent
+		{
+			CollisionComponent* componentA;
+			CollisionComponent* componentB;
+			bool isBeginContact;
+		};
 
-		eastl::weak_ptr<Entity> entityA_;
-		eastl::weak_ptr<Entity> entityB_;
+		eastl::vector<ContactEvent> contacts_;
+		bool isDispatching_ = false;
 	};
 } // namespace Engine
\ No newline at end of file
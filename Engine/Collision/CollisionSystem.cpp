@@ -4,15 +4,23 @@
 #include "Engine/Components/TransformComponent.hpp"
 #include "Engine/Collision/CollisionCallback.hpp"
 
-// To cast the int to void* without getting compiler warnings
-#define INT_TO_VOID_PTR(val) ((void*)(size_t) val)
+#include <ThirdParty/EASTL-master/include/EASTL/algorithm.h>
+
+#include <assert.h>
+#include <cmath>
 
 namespace Engine
 {
 
-	CollisionSystem::CollisionSystem() : world_(b2Vec2(0, 0)), isRunning_(false)
+	constexpr int32 CollisionSystem::VelocityIterations;
+	constexpr int32 CollisionSystem::PositionIterations;
+	constexpr size_t CollisionSystem::RayQueryBatchSize;
+	constexpr size_t CollisionSystem::DefaultHitCapacity;
+
+	CollisionSystem::CollisionSystem() : world_(b2Vec2(0, 0)), isRunning_(false), fixedTimeStep_(1.0f / 60.0f), maxSubSteps_(8), accumulator_(0.0f)
 	{
-		world_.SetAllowSleeping(false);
+		// The callback lives as long as the world, so it only has to be registered once.
+		world_.SetContactListener(&entityContactCallback_);
 	}
 
 	CollisionSystem::~CollisionSystem()
@@ -21,29 +29,83 @@ namespace Engine
 
 	void CollisionSystem::AddCollisionComponent(eastl::weak_ptr<CollisionComponent> componentToAdd)
 	{
-		collisionComponents_.push_back(componentToAdd);
+		const eastl::shared_ptr<CollisionComponent> component = componentToAdd.lock();
+		component->bodyIndex = uint32_t(bodies_.size());
+
+		CollisionBody collisionBody;
+		collisionBody.body = nullptr;
+		collisionBody.transform = nullptr;
+		collisionBody.component = component.get();
+		collisionBody.syncedPosition = b2Vec2(0, 0);
+		SetBodyTransform(collisionBody, component->GetTransformComponent().lock().get());
+		bodies_.push_back(collisionBody);
 
 		// Generate a Collision Body
-		componentToAdd.lock()->body = world_.CreateBody(&(componentToAdd.lock()->bodyDef));
-		componentToAdd.lock()->body->CreateFixture(&(componentToAdd.lock()->fixtureDef));
-		componentToAdd.lock()->body->GetFixtureList()->SetUserData(INT_TO_VOID_PTR(componentToAdd.lock()->GetOwner().lock()->GetID()));
+		CreateBody(bodies_.size() - 1);
 	}
 
 	void CollisionSystem::RemoveCollisionComponent(CollisionComponent*  componentToRemove)
 	{
-		if (world_.GetBodyCount() == 0)
-			return;
 		if (componentToRemove == nullptr)
 			return;
-		if (componentToRemove->body == nullptr)
+		if (componentToRemove->bodyIndex >= bodies_.size())
 			return;
 
-		world_.DestroyBody(componentToRemove->body);
+		// Destroying the body ends its contacts, the component can't be reached anymore once they are dispatched.
+		if (componentToRemove->body != nullptr)
+			world_.DestroyBody(componentToRemove->body);
+		componentToRemove->body = nullptr;
+		entityContactCallback_.RemoveComponent(componentToRemove);
+
+		// Swap the last body into the freed position so the array stays packed.
+		const size_t bodyIndex = componentToRemove->bodyIndex;
+		SetBodyTransform(bodies_[bodyIndex], nullptr);
+		if (bodyIndex != bodies_.size() - 1)
+		{
+			bodies_[bodyIndex] = bodies_.back();
+			bodies_[bodyIndex].component->bodyIndex = uint32_t(bodyIndex);
+		}
+
+		bodies_.pop_back();
+		componentToRemove->bodyIndex = CollisionComponent::InvalidBodyIndex;
+	}
+
+	void CollisionSystem::SetTransformComponent(CollisionComponent* component, TransformComponent* transform)
+	{
+		if (component->bodyIndex >= bodies_.size())
+			return;
+
+		SetBodyTransform(bodies_[component->bodyIndex], transform);
+	}
+
+	void CollisionSystem::RemoveTransformComponent(TransformComponent* transformToRemove)
+	{
+		for (size_t i = 0, size = bodies_.size(); i < size && transformToRemove->collisionBodyCount > 0; ++i)
+		{
+			if (bodies_[i].transform == transformToRemove)
+				SetBodyTransform(bodies_[i], nullptr);
+		}
+
+		if (transformToRemove->isQueuedForTeleport)
+		{
+			movedTransforms_.erase(eastl::find(movedTransforms_.begin(), movedTransforms_.end(), transformToRemove));
+			transformToRemove->isQueuedForTeleport = false;
+		}
+	}
+
+	void CollisionSystem::SetBodyTransform(CollisionBody& collisionBody, TransformComponent* transform)
+	{
+		if (collisionBody.transform != nullptr)
+			--collisionBody.transform->collisionBodyCount;
+		if (transform != nullptr)
+			++transform->collisionBodyCount;
+
+		collisionBody.transform = transform;
 	}
 
 	void CollisionSystem::OnLevelLoaded()
 	{
-		if (collisionComponents_.size() > 0)
+		if (bodies_.size() > 0)
 			Start();
 	}
 
@@ -53,7 +115,13 @@ namespace Engine
 			return;
 
 		Stop();
-		collisionComponents_.clear();
+
+		for (size_t i = 0, size = bodies_.size(); i < size; ++i)
+		{
+			SetBodyTransform(bodies_[i], nullptr);
+			bodies_[i].component->bodyIndex = CollisionComponent::InvalidBodyIndex;
+		}
+		bodies_.clear();
 	}
 
 	void CollisionSystem::Stop()
@@ -65,7 +133,16 @@ namespace Engine
 	void CollisionSystem::Start()
 	{
 		ClearWorld();
+		accumulator_ = 0.0f;
 		isRunning_ = true;
+
+		// The bodies start at the position of their transform, so there is nothing left to teleport.
+		for (size_t i = 0, size = movedTransforms_.size(); i < size; ++i)
+			movedTransforms_[i]->isQueuedForTeleport = false;
+		movedTransforms_.clear();
+
+		for (size_t i = 0, size = bodies_.size(); i < size; ++i)
+			CreateBody(i);
 	}
 
 	void CollisionSystem::Update()
@@ -74,36 +151,83 @@ namespace Engine
 		if (isRunning_ == false) 
 			return; // Call CollisionSystem::Start() before calling CollisionSystem::Update()!
 
-		world_.SetContactListener(&entityContactCallback_);
+		TeleportMovedBodies();
 
-		// Update World Positions with Transform Components positions
-		for (auto colComp : collisionComponents_)
-		{
-			eastl::weak_ptr<TransformComponent> transform = colComp.lock()->GetTransformComponent();
-			if (transform.expired() == false) // Collision Component Requires Transform!
-				continue;
+		// Update World, the frame time is simulated in fixed steps so the simulation doesn't depend on the frame rate.
+		accumulator_ += Engine::GetEngine().lock()->GetTime().lock()->GetDeltaTime();
 
-			const glm::vec3 position = transform.lock()->GetPosition();
-			colComp.lock()->body->SetTransform(b2Vec2(position.x, position.y), colComp.lock()->body->GetAngle());
+		size_t stepCount = size_t(accumulator_ / fixedTimeStep_);
+		if (stepCount > maxSubSteps_)
+		{
+			// Drop the time that doesn't fit in the maximum amount of steps, catching up would only make the next frame slower.
+			stepCount = maxSubSteps_;
+			accumulator_ = fixedTimeStep_ * float(maxSubSteps_) + fmodf(accumulator_, fixedTimeStep_);
 		}
 
-		// Update World
-		const float deltaTime = Engine::GetEngine().lock()->GetTime().lock()->GetDeltaTime();
-		world_.Step(deltaTime, 8, 4);
+		for (size_t i = 0; i < stepCount; ++i)
+		{
+			world_.Step(fixedTimeStep_, VelocityIterations, PositionIterations);
+			accumulator_ -= fixedTimeStep_;
+
+			// The world is unlocked again, so the callbacks are allowed to change collision components.
+			entityContactCallback_.DispatchContacts();
+		}
 
-		// Update Transform Positions with World Positions
-		for (auto colComp : collisionComponents_)
+		// Update Transform Positions with World Positions, interpolated between the last two steps.
+		// A step moves a body by its velocity times the time step, so the position before the last step is found by stepping back along the velocity.
+		const float timeBehind = (1.0f - GetInterpolationAlpha()) * fixedTimeStep_;
+		for (size_t i = 0, size = bodies_.size(); i < size; ++i)
 		{
-			eastl::weak_ptr<TransformComponent> transform = colComp.lock()->GetTransformComponent();
-			if (transform.expired() == false) // Collision Component Requires Transform!
+			CollisionBody& collisionBody = bodies_[i];
+			if (collisionBody.transform == nullptr || collisionBody.body == nullptr) // Collision Component Requires Transform!
 				continue;
 
-			const glm::vec3 oldPosition = transform.lock()->GetPosition();
-			const b2Vec2& position = colComp.lock()->body->GetPosition();
+			// Resting bodies are skipped once their transform has caught up with their final position, falling asleep clears the velocity.
+			const b2Vec2& position = collisionBody.body->GetPosition();
+			if (collisionBody.body->IsAwake() == false && collisionBody.syncedPosition == position)
+				continue;
+
+			const b2Vec2 interpolatedPosition = position - timeBehind * collisionBody.body->GetLinearVelocity();
 
-			transform.lock()->SetPosition(glm::vec3(position.x, position.y, oldPosition.z));
+			// Written directly, going through SetPosition would queue the body to be teleported.
+			TransformComponent* transform = collisionBody.transform;
+			if (transform->isStatic == false)
+			{
+				transform->position = glm::vec3(interpolatedPosition.x, interpolatedPosition.y, transform->position.z);
+				transform->UpdateModelMatrix();
+			}
+			collisionBody.syncedPosition = interpolatedPosition;
 		}
-		entityContactCallback_ = EntityContact();
+	}
+
+	void CollisionSystem::TeleportMovedBodies()
+	{
+		for (size_t i = 0, size = movedTransforms_.size(); i < size; ++i)
+		{
+			TransformComponent* transform = movedTransforms_[i];
+			transform->isQueuedForTeleport = false;
+
+			const eastl::shared_ptr<Entity> owner = transform->GetOwner().lock();
+			if (owner == nullptr)
+				continue;
+
+			const b2Vec2 transformPosition(transform->position.x, transform->position.y);
+			const eastl::vector<eastl::weak_ptr<CollisionComponent>> components = owner->GetComponents<CollisionComponent>();
+			for (size_t j = 0, componentCount = components.size(); j < componentCount; ++j)
+			{
+				const uint32_t bodyIndex = components[j].lock()->bodyIndex;
+				if (bodyIndex >= bodies_.size() || bodies_[bodyIndex].transform != transform || bodies_[bodyIndex].body == nullptr)
+					continue;
+
+				// The body is teleported, so there is nothing to interpolate from.
+				CollisionBody& collisionBody = bodies_[bodyIndex];
+				collisionBody.body->SetTransform(transformPosition, collisionBody.body->GetAngle());
+				collisionBody.body->SetAwake(true);
+				collisionBody.syncedPosition = transformPosition;
+			}
+		}
+
+		movedTransforms_.clear();
 	}
 
 	eastl::weak_ptr<Entity> CollisionSystem::RayQueryFirstHit(const glm::vec2& start, const glm::vec2& end, CollisionLayer detectionLayers) const
@@ -122,10 +246,79 @@ namespace Engine
 		return callback.entity;
 	}
 
-	// TODO - Implementation
-	eastl::weak_ptr<Entity> CollisionSystem::RayQueryAllHit(const glm::vec2& start, const glm::vec2& end) const
+	eastl::vector<eastl::weak_ptr<Entity>> CollisionSystem::RayQueryAllHit(const glm::vec2& start, const glm::vec2& end, CollisionLayer detectionLayers) const
 	{
-		return eastl::weak_ptr<Entity>();
+		eastl::vector<eastl::weak_ptr<Entity>> entities;
+
+		eastl::vector<RayHit> hits(DefaultHitCapacity);
+		const RayQuery ray = { start, end };
+		size_t hitCount = 0;
+		RayQueryAllHit(&ray, 1, detectionLayers, hits.data(), hits.size(), &hitCount);
+
+		// Cast the ray again in the rare case it hit more bodies than were reserved.
+		if (hitCount > hits.size())
+		{
+			hits.resize(hitCount);
+			RayQueryAllHit(&ray, 1, detectionLayers, hits.data(), hits.size(), &hitCount);
+		}
+
+		entities.reserve(hitCount);
+		for (size_t i = 0; i < hitCount; ++i)
+			entities.push_back(hits[i].component->GetOwner());
+
+		return entities;
+	}
+
+	void CollisionSystem::RayQueryAllHit(const RayQuery* rays, size_t rayCount, CollisionLayer detectionLayers, RayHit* hits, size_t maxHitsPerRay, size_t* hitCounts) const
+	{
+		// Box2D only reads from the world while casting rays, so the rays can be cast from multiple threads at once.
+		Engine::GetEngine().lock()->GetJobSystem().lock()->ParallelFor(rayCount, RayQueryBatchSize, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				hitCounts[i] = 0;
+
+				// Raycast of 0 distance causes assert error in Box2D
+				if (rays[i].start == rays[i].end)
+					continue;
+
+				RayCastMultipleCallback callback(detectionLayers, hits + i * maxHitsPerRay, maxHitsPerRay);
+				world_.RayCast(&callback, b2Vec2(rays[i].start.x, rays[i].start.y), b2Vec2(rays[i].end.x, rays[i].end.y));
+				hitCounts[i] = callback.GetTotalCount();
+			}
+		});
+	}
+
+	void CollisionSystem::SetFixedTimeStep(float fixedTimeStep)
+	{
+		assert(fixedTimeStep > 0.0f); // The time step has to be larger than 0!
+		fixedTimeStep_ = fixedTimeStep;
+	}
+
+	float CollisionSystem::GetFixedTimeStep() const
+	{
+		return fixedTimeStep_;
+	}
+
+	void CollisionSystem::SetMaxSubSteps(size_t maxSubSteps)
+	{
+		maxSubSteps_ = maxSubSteps;
+	}
+
+	size_t CollisionSystem::GetMaxSubSteps() const
+	{
+		return maxSubSteps_;
+	}
+
+	float CollisionSystem::GetInterpolationAlpha() const
+	{
+		const float alpha = accumulator_ / fixedTimeStep_;
+		return alpha < 1.0f ? alpha : 1.0f;
+	}
+
+	SpatialGrid& CollisionSystem::GetSpatialGrid()
+	{
+		return spatialGrid_;
 	}
 
 	bool CollisionSystem::IsRunning() const
@@ -135,7 +328,13 @@ namespace Engine
 
 	eastl::vector<eastl::weak_ptr<CollisionComponent>> CollisionSystem::GetActiveCollisionComponents() const
 	{
-		return collisionComponents_;
+		eastl::vector<eastl::weak_ptr<CollisionComponent>> components;
+		components.reserve(bodies_.size());
+
+		for (size_t i = 0, size = bodies_.size(); i < size; ++i)
+			components.push_back(bodies_[i].component->GetPointerRefence<CollisionComponent>());
+
+		return components;
 	}
 
 	void CollisionSystem::ClearWorld()
@@ -148,6 +347,35 @@ namespace Engine
 			world_.DestroyBody(body);
 			body = nextBody;
 		}
+
+		for (size_t i = 0, size = bodies_.size(); i < size; ++i)
+		{
+			bodies_[i].body = nullptr;
+			bodies_[i].component->body = nullptr;
+		}
+
+		// Let the entities know their contacts have ended.
+		entityContactCallback_.DispatchContacts();
+	}
+
+	void CollisionSystem::CreateBody(size_t bodyIndex)
+	{
+		CollisionBody& collisionBody = bodies_[bodyIndex];
+		CollisionComponent* component = collisionBody.component;
+
+		// Start at the position of the transform, so the body doesn't have to be teleported during the next update.
+		if (collisionBody.transform != nullptr)
+		{
+			const glm::vec3 position = collisionBody.transform->GetPosition();
+			component->bodyDef.position.Set(position.x, position.y);
+		}
+
+		component->body = world_.CreateBody(&component->bodyDef);
+		component->body->CreateFixture(&component->fixtureDef);
+		component->body->GetFixtureList()->SetUserData(component);
+
+		collisionBody.body = component->body;
+		collisionBody.syncedPosition = component->body->GetPosition();
 	}
 
 }
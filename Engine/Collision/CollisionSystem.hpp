@@ -3,6 +3,7 @@
 #include "Engine/Collision/CollisionTypes.hpp"
 #include "Engine/Collision/RaycastCallback.hpp"
 #include "Engine/Collision/CollisionCallback.hpp"
+#include "Engine/Collision/SpatialGrid.hpp"
 #include "Engine/Components/CollisionComponent.hpp"
 #include "Engine/api.hpp"
 
@@ -30,8 +31,11 @@ namespace Engine
 	private:
 
 		friend class CollisionComponent;
+		friend class TransformComponent;
 		void AddCollisionComponent(eastl::weak_ptr<CollisionComponent> componentToAdd);
 		void RemoveCollisionComponent(CollisionComponent* componentToRemove);
+		void SetTransformComponent(CollisionComponent* component, TransformComponent* transform);
+		void RemoveTransformComponent(TransformComponent* transformToRemove);
 
 		void OnLevelLoaded();
 		void OnLevelUnloaded();
@@ -51,10 +55,39 @@ namespace Engine
 
 		/// <summary>
 		/// Updates the collision world.
-		/// Takes transform data of collision components, changes it, and replaces the old transform data with the new data.
+		/// Collision-bodies of transforms that have been moved since the last update are teleported, after which the world is stepped.
+		/// The world is stepped with a fixed time step, the positions written back to the transforms are interpolated between the last two steps.
 		/// </summary>
 		void Update();
 
+		/// <summary>
+		/// Sets the amount of time simulated by a single step of the collision world. 1/60th of a second by default.
+		/// </summary>
+		/// <param name="fixedTimeStep">The time step in seconds, has to be larger than 0.</param>
+		void SetFixedTimeStep(float fixedTimeStep);
+
+		/// <summary>
+		/// Returns the amount of time simulated by a single step of the collision world.
+		/// </summary>
+		float GetFixedTimeStep() const;
+
+		/// <summary>
+		/// Sets the maximum amount of steps taken during a single update. 8 by default.
+		/// When a frame takes longer than this amount of steps the remaining time is dropped, so a slow frame can't cause even slower frames.
+		/// </summary>
+		/// <param name="maxSubSteps">The maximum amount of steps per update.</param>
+		void SetMaxSubSteps(size_t maxSubSteps);
+
+		/// <summary>
+		/// Returns the maximum amount of steps taken during a single update.
+		/// </summary>
+		size_t GetMaxSubSteps() const;
+
+		/// <summary>
+		/// Returns how far the current frame is between the last two steps of the collision world, ranging from 0 to 1.
+		/// </summary>
+		float GetInterpolationAlpha() const;
+
 		/// <summary>
 		/// Returns the first collision-body hit by the ray. TODO - Implementation
 		/// </summary>
@@ -65,12 +98,33 @@ namespace Engine
 		eastl::weak_ptr<Entity>	RayQueryFirstHit(const glm::vec2& start, const glm::vec2& end, CollisionLayer detectionLayers) const;
 
 		/// <summary>
-		/// Returns all collision-objects hit by the ray. TODO - Implementation
+		/// Returns all collision-objects hit by the ray, sorted from closest to furthest.
 		/// </summary>
 		/// <param name="start">The start position of the ray.</param>
 		/// <param name="end">The end position of the ray.</param>
-		/// <returns>vector of shared_ptr of CollisionComponent of all collision-bodies hit by the ray</returns>
-		eastl::weak_ptr<Entity>	RayQueryAllHit(const glm::vec2& start, const glm::vec2& end) const; // TODO - Implementation
+		/// <param name="detectionLayers">The collision layers you want to use.</param>
+		/// <returns>vector of weak_ptr of all entities hit by the ray</returns>
+		eastl::vector<eastl::weak_ptr<Entity>> RayQueryAllHit(const glm::vec2& start, const glm::vec2& end, CollisionLayer detectionLayers) const;
+
+		/// <summary>
+		/// Casts a batch of rays and writes all of their hits to the given buffer, the rays are spread over the job system.
+		/// Every ray gets its own slice of maxHitsPerRay hits in the buffer, starting at rayIndex * maxHitsPerRay. The hits in a slice are sorted from closest to furthest.
+		/// When a ray hits more collision-bodies than fit in its slice, only the closest hits are kept. The hit count of that ray still contains every hit.
+		/// NOTE: Doesn't allocate, the buffers are owned by the caller. Don't change the collision world while the query runs.
+		/// </summary>
+		/// <param name="rays">The rays to cast.</param>
+		/// <param name="rayCount">The amount of rays to cast.</param>
+		/// <param name="detectionLayers">The collision layers you want to use.</param>
+		/// <param name="hits">The buffer the hits are written to, needs room for rayCount * maxHitsPerRay hits.</param>
+		/// <param name="maxHitsPerRay">The amount of hits stored per ray.</param>
+		/// <param name="hitCounts">The buffer the total amount of hits of every ray is written to, needs room for rayCount values.</param>
+		void RayQueryAllHit(const RayQuery* rays, size_t rayCount, CollisionLayer detectionLayers, RayHit* hits, size_t maxHitsPerRay, size_t* hitCounts) const;
+
+		/// <summary>
+		/// Returns the spatial grid containing the world positions of all transform components, use it for proximity queries on entities that don't need a collision-body.
+		/// </summary>
+		/// <returns>The spatial grid of the collision system.</returns>
+		SpatialGrid& GetSpatialGrid();
 
 		/// <summary>
 		/// Returns true if the Collision system is running
@@ -90,9 +144,54 @@ namespace Engine
 		/// </summary>
 		void ClearWorld();
 
-		eastl::vector<eastl::weak_ptr<CollisionComponent>> collisionComponents_;	/// All the components related to the currently active collision-bodies in m_world
+		/// <summary>
+		/// Creates the collision-body of the given entry in the collision-world
+		/// </summary>
+		void CreateBody(size_t bodyIndex);
+
+		/// <summary>
+		/// Moves the collision-bodies of the transforms that have been moved outside of the collision system to the position of their transform.
+		/// </summary>
+		void TeleportMovedBodies();
+
+		/// <summary>
+		/// The data needed to synchronize a collision-body with its transform, stored densely so the sync stage doesn't have to go through the components.
+		/// </summary>
+		struct CollisionBody
+		{
+			b2Body* body;
+			// Raw pointers are safe here, the collision component keeps them up to date and removes its entry when it is destroyed, a destroyed transform clears itself.
+			TransformComponent* transform;
+			CollisionComponent* component;
+			b2Vec2 syncedPosition;		/// The position last written to the transform by the collision system
+		};
+
+		/// <summary>
+		/// Sets the transform of the given entry in the dense body array, keeping the collision-body count of the transforms up to date.
+		/// </summary>
+		void SetBodyTransform(CollisionBody& collisionBody, TransformComponent* transform);
+
+		static constexpr int32 VelocityIterations = 8;
+		static constexpr int32 PositionIterations = 4;
+
+		/// <summary>
+		/// The amount of rays cast by a single job.
+		/// </summary>
+		static constexpr size_t RayQueryBatchSize = 32;
+
+		/// <summary>
+		/// The amount of hits RayQueryAllHit reserves for a single ray before it has to cast the ray again.
+		/// </summary>
+		static constexpr size_t DefaultHitCapacity = 16;
+
+		eastl::vector<CollisionBody> bodies_;	/// All the collision-bodies of the collision components in m_world
+		eastl::vector<TransformComponent*> movedTransforms_;	/// Transforms with collision-bodies that have been moved since the last update
 		b2World world_;					/// The collision-world running the "physics" simulation.
 		bool isRunning_;				/// Set to true to allow for calls to Update()
-		EntityContact entityContactCallback_; /// Callback that calls OnBeginContact() and OnEndContact() on enemies
+		EntityContact entityContactCallback_; /// Callback that buffers the contacts of a step, dispatched to OnBeginContact() and OnEndContact() after the step
+		float fixedTimeStep_;			/// The time simulated by a single step of m_world
+		size_t maxSubSteps_;			/// The maximum amount of steps per update
+		float accumulator_;				/// The time that has passed but has not been simulated yet
+		SpatialGrid spatialGrid_;		/// The world positions of all transform components, maintained by the transform hierarchy
 	};
 } // namespace Engine
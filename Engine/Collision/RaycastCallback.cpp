@@ -1,5 +1,5 @@
 #include "Engine/Collision/RaycastCallback.hpp"
-#include "Engine/engine.hpp"
+#include "Engine/Components/CollisionComponent.hpp"
 
 namespace Engine
 {
@@ -23,8 +23,7 @@ namespace Engine
 		this->normal = normal;
 
 		// Record Hit Entity
-		const uint64_t entityID = uint64_t(fixture->GetUserData());
-		entity = Engine::GetEngine().lock()->GetEntitySystem().lock()->GetEntity(entityID);
+		entity = static_cast<CollisionComponent*>(fixture->GetUserData())->GetOwner();
 
 		// BOX2D Comment - By returning the current fraction, we instruct the calling code to clip the ray and
 		// continue the ray-cast to the next fixture. WARNING: do not assume that fixtures
@@ -32,35 +31,53 @@ namespace Engine
 		return fraction;
 	}
 
-	RayCastMultipleCallback::RayCastMultipleCallback() : detectionLayers(CollisionLayer::SOLID), count(0)
+	RayCastMultipleCallback::RayCastMultipleCallback(const CollisionLayer detectLayers, RayHit* hits, size_t capacity)
+		: hits(hits), capacity(capacity), count(0), totalCount(0), detectionLayers(detectLayers)
 	{
 	}
 
-	RayCastMultipleCallback::RayCastMultipleCallback(const CollisionLayer detectLayers)	: detectionLayers(detectLayers), count(0)
-	{
-	}
-
-	float32 RayCastMultipleCallback::ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float32)
+	float32 RayCastMultipleCallback::ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float32 fraction)
 	{
 		const bool isDetectable = uint16(detectionLayers) & fixture->GetFilterData().categoryBits;
 		if (isDetectable == false)
 			return 1.0f;
 
-		b2Assert(count < MAX_COUNT);
+		++totalCount;
 
-		// Record hit data
-		points[count] = point;
-		normals[count] = normal;
-		++count;
+		// When the buffer is full the hit replaces the furthest hit, if it is closer.
+		size_t index = count;
+		if (count < capacity)
+			++count;
+		else if (count == 0 || fraction >= hits[count - 1].fraction)
+			return 1.0f;
+		else
+			index = count - 1;
 
-		if (count == MAX_COUNT)
+		// Box2D doesn't report the fixtures in order, so keep the buffer sorted by moving the further hits back.
+		while (index > 0 && hits[index - 1].fraction > fraction)
 		{
-			// At this point the buffer is full.
-			// By returning 0, we instruct the calling code to terminate the ray-cast.
-			return 0.0f;
+			hits[index] = hits[index - 1];
+			--index;
 		}
 
+		// Record hit data
+		RayHit& hit = hits[index];
+		hit.component = static_cast<CollisionComponent*>(fixture->GetUserData());
+		hit.point = glm::vec2(point.x, point.y);
+		hit.normal = glm::vec2(normal.x, normal.y);
+		hit.fraction = fraction;
+
 		// By returning 1, we instruct the caller to continue without clipping the ray.
 		return 1.0f;
 	}
+
+	size_t RayCastMultipleCallback::GetCount() const
+	{
+		return count;
+	}
+
+	size_t RayCastMultipleCallback::GetTotalCount() const
+	{
+		return totalCount;
+	}
 } // namespace Engine
\ No newline at end of file
@@ -4,10 +4,32 @@
 #include "Engine/Collision/CollisionTypes.hpp"
 
 #include <ThirdParty/Box2D/Box2D/Box2D.h>
+#include <ThirdParty/glm/glm/glm.hpp>
 
 namespace Engine
 {
 	class CollisionSystem;
+	class CollisionComponent;
+
+	/// <summary>
+	/// A single ray of a batched ray query.
+	/// </summary>
+	struct RayQuery
+	{
+		glm::vec2 start;
+		glm::vec2 end;
+	};
+
+	/// <summary>
+	/// A single hit of a ray query.
+	/// </summary>
+	struct RayHit
+	{
+		CollisionComponent* component;	/// The collision component that has been hit, use GetOwner() to get the entity
+		glm::vec2 point;	/// The point where the ray hit the collision-body
+		glm::vec2 normal;	/// The normal of the surface that has been hit
+		float fraction;		/// The distance along the ray, ranging from 0 at the start to 1 at the end
+	};
 
 	/// <summary>
 	/// Gets the first entity hit by the ray
@@ -44,21 +66,17 @@ namespace Engine
 	/// <summary>
 	/// Gets the all entities hit by the ray
 	/// Callback class used to get collision data from ray queries
-	/// NOTE: Gets up to MAX_COUNT amount of entities, MAX_COUNT being defined inside of RaycastCallback.hpp
+	/// NOTE: The hits are written to a buffer owned by the caller. When the buffer is full only the closest hits are kept, the total amount of hits is still counted.
 	/// </summary>
 	class RayCastMultipleCallback : public b2RayCastCallback
 	{
 		friend class CollisionSystem;
 	public:
-		enum
-		{
-			MAX_COUNT = 5
-		};
-
 		// Structors
-		RayCastMultipleCallback();
 		/// <param name="detectLayers">The layers the ray will be checking for</param>
-		RayCastMultipleCallback(const CollisionLayer detectLayers);
+		/// <param name="hits">The buffer to write the hits to, the hits are sorted from closest to furthest</param>
+		/// <param name="capacity">The amount of hits that fit in the buffer</param>
+		RayCastMultipleCallback(const CollisionLayer detectLayers, RayHit* hits, size_t capacity);
 
 		/// <summary>
 		/// Function used by Box2D to tell the Callback class that the ray has collided with a fixture.
@@ -69,11 +87,21 @@ namespace Engine
 		/// <returns>Number determines the query behaviour of the ray, 1 continue, 0 stop and return fraction parameter to get the closest</returns>
 		float32 ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float32) override;
 
+		/// <summary>
+		/// Returns the amount of hits stored in the buffer.
+		/// </summary>
+		size_t GetCount() const;
+
+		/// <summary>
+		/// Returns the amount of hits found by the ray, this can be larger than the capacity of the buffer.
+		/// </summary>
+		size_t GetTotalCount() const;
+
 	private:
-		std::weak_ptr<Entity> entities;
-		b2Vec2 points[MAX_COUNT];
-		b2Vec2 normals[MAX_COUNT];
+		RayHit* hits;
+		size_t capacity;
+		size_t count;
+		size_t totalCount;
 		CollisionLayer detectionLayers;
-		int32 count;
 	};
 } //namespace Engine
\ No newline at end of file
@@ -0,0 +1,324 @@
+#include "Engine/Collision/SpatialGrid.hpp"
+
+#include "Engine/Components/TransformComponent.hpp"
+
+#include <ThirdParty/EASTL-master/include/EASTL/heap.h>
+#include <ThirdParty/EASTL-master/include/EASTL/sort.h>
+
+#include <assert.h>
+#include <cmath>
+
+namespace Engine
+{
+	constexpr uint32_t SpatialGrid::InvalidProxy;
+
+	namespace
+	{
+		// Cell coordinates are clamped to this range, so positions far outside of the world can't overflow the coordinates of their cell.
+		constexpr float MaxCellCoordinate = float(1 << 30);
+	}
+
+	SpatialGrid::SpatialGrid() : firstFreeProxy(InvalidProxy), count(0), cellSize(4.0f), inverseCellSize(1.0f / 4.0f)
+	{
+	}
+
+	SpatialGrid::~SpatialGrid()
+	{
+		// Transforms can outlive the grid, make sure they no longer refer to it.
+		for (size_t i = 0, size = proxies.size(); i < size; ++i)
+		{
+			if (proxies[i].transform == nullptr)
+				continue;
+
+			proxies[i].transform->spatialGrid = nullptr;
+			proxies[i].transform->spatialProxy = InvalidProxy;
+		}
+	}
+
+	void SpatialGrid::SetCellSize(float cellSize)
+	{
+		assert(cellSize > 0.0f); // The cell size has to be larger than 0!
+		this->cellSize = cellSize;
+		inverseCellSize = 1.0f / cellSize;
+
+		cells.clear();
+		for (uint32_t i = 0, size = uint32_t(proxies.size()); i < size; ++i)
+		{
+			if (proxies[i].transform != nullptr)
+				Link(i, GetCellKey(proxies[i].position));
+		}
+	}
+
+	float SpatialGrid::GetCellSize() const
+	{
+		return cellSize;
+	}
+
+	size_t SpatialGrid::GetCount() const
+	{
+		return count;
+	}
+
+	void SpatialGrid::QueryOverlap(const glm::vec2& min, const glm::vec2& max, eastl::vector<TransformComponent*>& results) const
+	{
+		results.clear();
+		QueryCells(min, max, [&](const glm::vec2& position)
+		{
+			return position.x >= min.x && position.x <= max.x && position.y >= min.y && position.y <= max.y;
+		}, results);
+	}
+
+	void SpatialGrid::QueryRadius(const glm::vec2& center, float radius, eastl::vector<TransformComponent*>& results) const
+	{
+		results.clear();
+		if (radius < 0.0f)
+			return;
+
+		const float radiusSquared = radius * radius;
+		QueryCells(center - glm::vec2(radius), center + glm::vec2(radius), [&](const glm::vec2& position)
+		{
+			const glm::vec2 offset = position - center;
+			return glm::dot(offset, offset) <= radiusSquared;
+		}, results);
+	}
+
+	void SpatialGrid::QueryNearest(const glm::vec2& center, size_t count, eastl::vector<TransformComponent*>& results) const
+	{
+		results.clear();
+		if (count > this->count)
+			count = this->count;
+		if (count == 0)
+			return;
+
+		eastl::vector<Candidate> candidates;
+		candidates.reserve(count);
+
+		const int32_t centerX = GetCellCoordinate(center.x);
+		const int32_t centerY = GetCellCoordinate(center.y);
+		for (int32_t ring = 0; ; ++ring)
+		{
+			// Once a ring contains more cells than there are occupied cells, visiting the occupied cells directly is cheaper.
+			if (size_t(ring) * 8 > cells.size())
+			{
+				candidates.clear();
+				for (auto it = cells.begin(); it != cells.end(); ++it)
+					GatherNearest(it->second, center, count, candidates);
+				break;
+			}
+
+			if (ring == 0)
+			{
+				const auto it = cells.find(GetCellKey(centerX, centerY));
+				if (it != cells.end())
+					GatherNearest(it->second, center, count, candidates);
+			}
+			else
+			{
+				// The top and bottom rows of the ring, followed by the columns in between.
+				for (int32_t x = centerX - ring; x <= centerX + ring; ++x)
+				{
+					const int32_t rows[2] = { centerY - ring, centerY + ring };
+					for (size_t i = 0; i < 2; ++i)
+					{
+						const auto it = cells.find(GetCellKey(x, rows[i]));
+						if (it != cells.end())
+							GatherNearest(it->second, center, count, candidates);
+					}
+				}
+				for (int32_t y = centerY - ring + 1; y <= centerY + ring - 1; ++y)
+				{
+					const int32_t columns[2] = { centerX - ring, centerX + ring };
+					for (size_t i = 0; i < 2; ++i)
+					{
+						const auto it = cells.find(GetCellKey(columns[i], y));
+						if (it != cells.end())
+							GatherNearest(it->second, center, count, candidates);
+					}
+				}
+			}
+
+			// Every cell outside of the visited rings is at least this far away from the center, so none of them can contain a closer transform.
+			const float minDistance = float(ring) * cellSize;
+			if (candidates.size() == count && candidates.front().distanceSquared <= minDistance * minDistance)
+				break;
+		}
+
+		eastl::sort_heap(candidates.begin(), candidates.end());
+
+		results.reserve(candidates.size());
+		for (size_t i = 0, size = candidates.size(); i < size; ++i)
+			results.push_back(proxies[candidates[i].proxy].transform);
+	}
+
+	bool SpatialGrid::Candidate::operator<(const Candidate& other) const
+	{
+		return distanceSquared < other.distanceSquared;
+	}
+
+	uint32_t SpatialGrid::Insert(TransformComponent* transform, const glm::vec2& position)
+	{
+		uint32_t proxy = firstFreeProxy;
+		if (proxy != InvalidProxy)
+		{
+			firstFreeProxy = proxies[proxy].next;
+		}
+		else
+		{
+			proxy = uint32_t(proxies.size());
+			proxies.push_back(Proxy());
+		}
+
+		proxies[proxy].transform = transform;
+		proxies[proxy].position = position;
+		Link(proxy, GetCellKey(position));
+		++count;
+
+		return proxy;
+	}
+
+	void SpatialGrid::Move(uint32_t proxy, const glm::vec2& position)
+	{
+		proxies[proxy].position = position;
+
+		const uint64_t cellKey = GetCellKey(position);
+		if (cellKey == proxies[proxy].cellKey)
+			return;
+
+		Unlink(proxy);
+		Link(proxy, cellKey);
+	}
+
+	void SpatialGrid::Remove(uint32_t proxy)
+	{
+		Unlink(proxy);
+		proxies[proxy].transform = nullptr;
+		proxies[proxy].next = firstFreeProxy;
+		firstFreeProxy = proxy;
+		--count;
+	}
+
+	int32_t SpatialGrid::GetCellCoordinate(float value) const
+	{
+		const float coordinate = floorf(value * inverseCellSize);
+		if (coordinate >= -MaxCellCoordinate && coordinate <= MaxCellCoordinate)
+			return int32_t(coordinate);
+
+		// NaN ends up in the lowest cell.
+		return coordinate > 0.0f ? int32_t(MaxCellCoordinate) : -int32_t(MaxCellCoordinate);
+	}
+
+	uint64_t SpatialGrid::GetCellKey(const glm::vec2& position) const
+	{
+		return GetCellKey(GetCellCoordinate(position.x), GetCellCoordinate(position.y));
+	}
+
+	uint64_t SpatialGrid::GetCellKey(int32_t x, int32_t y)
+	{
+		return (uint64_t(uint32_t(x)) << 32) | uint64_t(uint32_t(y));
+	}
+
+	template<typename Predicate>
+	void SpatialGrid::QueryCells(const glm::vec2& min, const glm::vec2& max, Predicate predicate, eastl::vector<TransformComponent*>& results) const
+	{
+		const int32_t minX = GetCellCoordinate(min.x);
+		const int32_t minY = GetCellCoordinate(min.y);
+		const int32_t maxX = GetCellCoordinate(max.x);
+		const int32_t maxY = GetCellCoordinate(max.y);
+		if (minX > maxX || minY > maxY)
+			return;
+
+		// Large boxes cover more cells than there are occupied cells, visiting the occupied cells directly is cheaper in that case.
+		const uint64_t cellCount = uint64_t(int64_t(maxX) - minX + 1) * uint64_t(int64_t(maxY) - minY + 1);
+		if (cellCount > cells.size())
+		{
+			for (auto it = cells.begin(); it != cells.end(); ++it)
+			{
+				for (uint32_t proxy = it->second; proxy != InvalidProxy; proxy = proxies[proxy].next)
+				{
+					if (predicate(proxies[proxy].position))
+						results.push_back(proxies[proxy].transform);
+				}
+			}
+			return;
+		}
+
+		for (int32_t x = minX; x <= maxX; ++x)
+		{
+			for (int32_t y = minY; y <= maxY; ++y)
+			{
+				const auto it = cells.find(GetCellKey(x, y));
+				if (it == cells.end())
+					continue;
+
+				for (uint32_t proxy = it->second; proxy != InvalidProxy; proxy = proxies[proxy].next)
+				{
+					if (predicate(proxies[proxy].position))
+						results.push_back(proxies[proxy].transform);
+				}
+			}
+		}
+	}
+
+	void SpatialGrid::Link(uint32_t proxy, uint64_t cellKey)
+	{
+		Proxy& linkedProxy = proxies[proxy];
+		linkedProxy.cellKey = cellKey;
+		linkedProxy.previous = InvalidProxy;
+
+		const auto result = cells.insert(eastl::make_pair(cellKey, proxy));
+		if (result.second)
+		{
+			linkedProxy.next = InvalidProxy;
+			return;
+		}
+
+		// The cell already exists, the proxy becomes the new front of its list.
+		uint32_t& firstProxy = result.first->second;
+		linkedProxy.next = firstProxy;
+		proxies[firstProxy].previous = proxy;
+		firstProxy = proxy;
+	}
+
+	void SpatialGrid::Unlink(uint32_t proxy)
+	{
+		const Proxy& unlinkedProxy = proxies[proxy];
+
+		if (unlinkedProxy.next != InvalidProxy)
+			proxies[unlinkedProxy.next].previous = unlinkedProxy.previous;
+
+		if (unlinkedProxy.previous != InvalidProxy)
+		{
+			proxies[unlinkedProxy.previous].next = unlinkedProxy.next;
+		}
+		else if (unlinkedProxy.next != InvalidProxy)
+		{
+			cells[unlinkedProxy.cellKey] = unlinkedProxy.next;
+		}
+		else
+		{
+			cells.erase(unlinkedProxy.cellKey);
+		}
+	}
+
+	void SpatialGrid::GatherNearest(uint32_t firstProxy, const glm::vec2& center, size_t count, eastl::vector<Candidate>& candidates) const
+	{
+		for (uint32_t proxy = firstProxy; proxy != InvalidProxy; proxy = proxies[proxy].next)
+		{
+			const glm::vec2 offset = proxies[proxy].position - center;
+			const Candidate candidate = { glm::dot(offset, offset), proxy };
+
+			if (candidates.size() < count)
+			{
+				candidates.push_back(candidate);
+				eastl::push_heap(candidates.begin(), candidates.end());
+			}
+			else if (candidate < candidates.front())
+			{
+				// Replace the furthest candidate.
+				eastl::pop_heap(candidates.begin(), candidates.end());
+				candidates.back() = candidate;
+				eastl::push_heap(candidates.begin(), candidates.end());
+			}
+		}
+	}
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "Engine/api.hpp"
+
+#include <ThirdParty/EASTL-master/include/EASTL/hash_map.h>
+#include <ThirdParty/EASTL-master/include/EASTL/vector.h>
+#include <ThirdParty/glm/glm/glm.hpp>
+
+namespace Engine
+{
+	class TransformComponent;
+
+	/// <summary>
+	/// A spatial hash grid containing the position of every transform component on the x and y axes, used for proximity queries that don't need collision-bodies.
+	/// Every transform is stored in the cell containing its world position, only the occupied cells are stored.
+	/// The transform hierarchy moves the transforms whose world matrix changed, a transform only changes cells when it crosses a cell border.
+	/// NOTE: This object is owned by the CollisionSystem and maintained by the transform components, gameplay code can only query it.
+	/// </summary>
+	class ENGINE_API SpatialGrid
+	{
+		friend class CollisionSystem;
+		friend class TransformComponent;
+		friend class TransformHierarchy;
+
+		SpatialGrid();
+	public:
+		~SpatialGrid();
+
+		/// <summary>
+		/// The proxy index used for transforms that are not stored in the grid.
+		/// </summary>
+		static constexpr uint32_t InvalidProxy = uint32_t(-1);
+
+		/// <summary>
+		/// Changes the size of the cells and moves all transforms to their new cells.
+		/// The cell size should be about the size of the common query radius. 4 by default.
+		/// </summary>
+		/// <param name="cellSize">The width and height of a single cell, has to be larger than 0.</param>
+		void SetCellSize(float cellSize);
+
+		/// <summary>
+		/// Returns the width and height of a single cell.
+		/// </summary>
+		float GetCellSize() const;
+
+		/// <summary>
+		/// Returns the amount of transforms stored in the grid.
+		/// </summary>
+		size_t GetCount() const;
+
+		/// <summary>
+		/// Finds all transforms inside of the given box, including its edges.
+		/// </summary>
+		/// <param name="min">The lower corner of the box.</param>
+		/// <param name="max">The upper corner of the box.</param>
+		/// <param name="results">Cleared and filled with the transforms inside of the box, in no particular order.</param>
+		void QueryOverlap(const glm::vec2& min, const glm::vec2& max, eastl::vector<TransformComponent*>& results) const;
+
+		/// <summary>
+		/// Finds all transforms within the given distance of the given point.
+		/// </summary>
+		/// <param name="center">The point to search around.</param>
+		/// <param name="radius">The maximum distance to the point.</param>
+		/// <param name="results">Cleared and filled with the transforms within the radius, in no particular order.</param>
+		void QueryRadius(const glm::vec2& center, float radius, eastl::vector<TransformComponent*>& results) const;
+
+		/// <summary>
+		/// Finds the given amount of transforms closest to the given point.
+		/// The search starts in the cell of the point and moves outwards one ring of cells at a time, until no unvisited cell can contain a closer transform.
+		/// </summary>
+		/// <param name="center">The point to search around.</param>
+		/// <param name="count">The maximum amount of transforms to find.</param>
+		/// <param name="results">Cleared and filled with the closest transforms, sorted from closest to furthest.</param>
+		void QueryNearest(const glm::vec2& center, size_t count, eastl::vector<TransformComponent*>& results) const;
+
+	private:
+		/// <summary>
+		/// A transform stored in the grid. The proxies in a cell are linked together, so moving a proxy between cells doesn't allocate.
+		/// </summary>
+		struct Proxy
+		{
+			TransformComponent* transform;	/// The stored transform, nullptr if this proxy is free
+			glm::vec2 position;				/// The position the proxy was last moved to
+			uint64_t cellKey;				/// The key of the cell containing the proxy
+			uint32_t previous;				/// The previous proxy in the same cell
+			uint32_t next;					/// The next proxy in the same cell, or the next free proxy
+		};
+
+		/// <summary>
+		/// A proxy found by a nearest query, ordered by distance.
+		/// </summary>
+		struct Candidate
+		{
+			float distanceSquared;
+			uint32_t proxy;
+
+			bool operator<(const Candidate& other) const;
+		};
+
+		/// <summary>
+		/// Adds the given transform at the given position.
+		/// </summary>
+		/// <returns>Returns the proxy index of the transform, used to move and remove it.</returns>
+		uint32_t Insert(TransformComponent* transform, const glm::vec2& position);
+
+		/// <summary>
+		/// Moves the given proxy to the given position.
+		/// </summary>
+		void Move(uint32_t proxy, const glm::vec2& position);
+
+		/// <summary>
+		/// Removes the given proxy from the grid.
+		/// </summary>
+		void Remove(uint32_t proxy);
+
+		/// <summary>
+		/// Returns the coordinate of the cell containing the given value along a single axis.
+		/// </summary>
+		int32_t GetCellCoordinate(float value) const;
+
+		/// <summary>
+		/// Returns the key of the cell containing the given position.
+		/// </summary>
+		uint64_t GetCellKey(const glm::vec2& position) const;
+
+		static uint64_t GetCellKey(int32_t x, int32_t y);
+
+		template<typename Predicate>
+		/// <summary>
+		/// Adds every proxy in the cells overlapping the given box that passes the given predicate to the results.
+		/// </summary>
+		void QueryCells(const glm::vec2& min, const glm::vec2& max, Predicate predicate, eastl::vector<TransformComponent*>& results) const;
+
+		/// <summary>
+		/// Adds the given proxy to the front of the list of the given cell.
+		/// </summary>
+		void Link(uint32_t proxy, uint64_t cellKey);
+
+		/// <summary>
+		/// Removes the given proxy from the list of its cell, the cell is removed when it becomes empty.
+		/// </summary>
+		void Unlink(uint32_t proxy);
+
+		/// <summary>
+		/// Adds the proxies in the list starting at the given proxy to the candidates of a nearest query, only the closest count candidates are kept.
+		/// The candidates are stored as a heap with the furthest candidate in front.
+		/// </summary>
+		void GatherNearest(uint32_t firstProxy, const glm::vec2& center, size_t count, eastl::vector<Candidate>& candidates) const;
+
+		eastl::vector<Proxy> proxies;
+		eastl::hash_map<uint64_t, uint32_t> cells;	/// The first proxy of every occupied cell
+		uint32_t firstFreeProxy;
+		size_t count;
+		float cellSize;
+		float inverseCellSize;
+	};
+} // namespace Engine
\ No newline at end of file
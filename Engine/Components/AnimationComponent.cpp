@@ -1,8 +1,33 @@
 #include "Engine/Components/AnimationComponent.hpp"
+#include "Engine/Components/TransformComponent.hpp"
 #include "Engine/Entity/Entity.hpp"
 #include "Engine/engine.hpp"
 
+#include <cfloat>
+#include <cmath>
+
 namespace Engine {
+
+	namespace
+	{
+		/// <summary>
+		/// How the models of an entity are animated beyond a multiple of the LOD distance of its animation component.
+		/// </summary>
+		struct AnimationLodLevel
+		{
+			float distanceFactor;
+			uint32_t updateInterval;
+			float boneDepthFactor;	/// The part of the depth of the skeleton that is animated, the deepest bones like fingers and toes are dropped first
+		};
+
+		constexpr AnimationLodLevel AnimationLodLevels[] = {
+			{ 1.f, 2, 1.f },
+			{ 2.f, 4, 0.75f },
+			{ 4.f, 8, 0.5f }
+		};
+
+		constexpr size_t NoAnimationLod = size_t(-1);
+	}
 	
 	AnimationComponent::~AnimationComponent()
 	{
@@ -236,31 +261,78 @@ namespace Engine {
 		return 0.0f;
 	}
 
-	AnimationComponent::AnimationComponent() noexcept
+	void AnimationComponent::SetLodDistance(float distance)
+	{
+		lodDistance = distance;
+	}
+
+	float AnimationComponent::GetLodDistance() const
+	{
+		return lodDistance;
+	}
+
+	AnimationComponent::AnimationComponent() noexcept : lodDistance(FLT_MAX)
 	{
 	}
 
 	void AnimationComponent::InitializeComponent()
 	{
 		isEnabled = true;
+		// Update only writes to the models it claims, everything else it reads is not changed during the parallel update.
+		canUpdateInParallel = true;
 	}
 
 	void AnimationComponent::Update()
 	{
+		// Pick the animation LOD level from the distance between the entity and the camera, without LOD distance there is nothing to measure.
+		size_t lodLevel = NoAnimationLod;
+		if (lodDistance < FLT_MAX) {
+			const eastl::shared_ptr<TransformComponent> transform = transformComponent.lock();
+			if (transform != nullptr) {
+				const glm::vec3 position = glm::vec3(transform->GetModelMatrix()[3]);
+				const float distance = glm::distance(position, Engine::GetEngine().lock()->GetCamera().lock()->GetPosition());
+
+				for (size_t i = 0, size = sizeof(AnimationLodLevels) / sizeof(AnimationLodLevels[0]); i < size; ++i) {
+					if (distance < lodDistance * AnimationLodLevels[i].distanceFactor)
+						break;
+
+					lodLevel = i;
+				}
+			}
+		}
+
+		const float deltaTime = Engine::GetEngine().lock()->GetTime().lock()->GetDeltaTime();
+
 		for (size_t i = 0, size = entityModels.size(); i < size; ++i) {
-			if (entityModels[i].expired())
+			const eastl::shared_ptr<ModelComponent> modelComponent = entityModels[i].lock();
+			if (modelComponent == nullptr || !modelComponent->isEnabled)
 				continue;
 
-			if (!entityModels[i].lock()->isEnabled)
+			// Animation components are updated in parallel, and entities using the same file share the model.
+			const eastl::shared_ptr<Model> model = modelComponent->GetModel().lock();
+			if (!model->ClaimAnimationUpdate())
 				continue;
 
-			entityModels[i].lock()->GetModel().lock()->UpdateAnimation(
-				Engine::GetEngine().lock()->GetTime().lock()->GetDeltaTime());
+			if (lodLevel == NoAnimationLod || model->GetSkeleton() == nullptr) {
+				model->SetAnimationLod(1, UINT32_MAX);
+			}
+			else {
+				// The bone depth limit is relative to the skeleton, so shallow and deep skeletons both keep their upper levels.
+				const AnimationLodLevel& level = AnimationLodLevels[lodLevel];
+				const uint32_t maxBoneDepth = level.boneDepthFactor < 1.f ?
+					static_cast<uint32_t>(ceilf(model->GetSkeleton()->GetMaxBoneDepth() * level.boneDepthFactor)) : UINT32_MAX;
+				model->SetAnimationLod(level.updateInterval, maxBoneDepth);
+			}
+
+			model->UpdateAnimation(deltaTime);
 		}
 	}
 
 	void AnimationComponent::OnComponentAdded(eastl::weak_ptr<Component> addedComponent)
 	{
+		if (eastl::dynamic_pointer_cast<TransformComponent>(addedComponent.lock()) && transformComponent.expired())
+			transformComponent = eastl::static_pointer_cast<TransformComponent>(addedComponent.lock());
+
 		if (eastl::dynamic_pointer_cast<ModelComponent, Component>(addedComponent.lock())) {
 			if (eastl::dynamic_pointer_cast<ModelComponent, Component>(addedComponent.lock())->GetModel().lock()->HasAnimations())
 				entityModels.push_back(eastl::dynamic_pointer_cast<ModelComponent, Component>(addedComponent.lock()));
@@ -269,6 +341,11 @@ namespace Engine {
 
 	void AnimationComponent::OnComponentRemoved(eastl::weak_ptr<Component> removedComponent)
 	{
+		if (transformComponent.lock().get() == removedComponent.lock().get()) {
+			transformComponent.reset();
+			transformComponent = GetComponent<TransformComponent>();
+		}
+
 		if (eastl::dynamic_pointer_cast<ModelComponent, Component>(removedComponent.lock())) {
 			eastl::vector<eastl::weak_ptr<ModelComponent>>::iterator it;
 			for (it = entityModels.begin(); it != entityModels.end(); ++it) {
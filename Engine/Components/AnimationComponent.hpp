@@ -201,6 +201,20 @@ namespace Engine {
 		/// <returns>The speed of the animation.</returns>
 		float GetModelAnimationSpeed(size_t index);
 
+		/// <summary>
+		/// Sets the distance from the camera at which the models of this entity start to be animated with less detail.
+		/// Beyond this distance the pose the models are rendered with is updated less often, and further away it also leaves the deepest bones
+		/// of the skeleton in their default pose, see Model::SetAnimationLod. The levels are at 1, 2 and 4 times this distance.
+		/// Lower it for unimportant entities like crowds, raise it for important ones. Animation LOD is disabled by default.
+		/// </summary>
+		/// <param name="distance">The distance of the first animation LOD level.</param>
+		void SetLodDistance(float distance);
+
+		/// <summary>
+		/// Returns the distance from the camera at which the models of this entity start to be animated with less detail.
+		/// </summary>
+		/// <returns>The distance of the first animation LOD level.</returns>
+		float GetLodDistance() const;
 
 	private:
 		friend class Entity;
@@ -215,6 +229,8 @@ namespace Engine {
 		void OnComponentRemoved(eastl::weak_ptr<Component> removedComponent) override;
 
 		eastl::vector<eastl::weak_ptr<ModelComponent>> entityModels;
+		eastl::weak_ptr<TransformComponent> transformComponent;
+		float lodDistance;
 	};
 
 }
@@ -15,7 +15,9 @@ namespace Engine
 		, fixtureDef()
 		, circleShape()
 		, boxShape()
+		, body(nullptr)
 		, shapeType(shapeType)
+		, bodyIndex(InvalidBodyIndex)
 	{
 		// Set the Shape
 		if (shapeType == CollisionShapeType::CIRCLE)
@@ -51,6 +53,7 @@ namespace Engine
 		if (eastl::dynamic_pointer_cast<TransformComponent>(addedComponent.lock()) && transformComponent.expired())
 		{
 			transformComponent = eastl::static_pointer_cast<TransformComponent>(addedComponent.lock());
+			Engine::GetEngine().lock()->GetCollisionSystem().lock()->SetTransformComponent(this, transformComponent.lock().get());
 		}
 	}
 
@@ -61,6 +64,7 @@ namespace Engine
 
 		//In case we have multiple transformcomponents on this entity for some reason.
 		transformComponent = GetComponent<TransformComponent>();
+		Engine::GetEngine().lock()->GetCollisionSystem().lock()->SetTransformComponent(this, transformComponent.lock().get());
 	}
 
 	eastl::weak_ptr<TransformComponent> CollisionComponent::GetTransformComponent() const
@@ -81,6 +85,7 @@ namespace Engine
 		circleShape	= collisionComponent.circleShape;
 		shapeType		= collisionComponent.shapeType;
 		body			= nullptr;
+		bodyIndex		= InvalidBodyIndex;
 	}
 
 	void CollisionComponent::SetBodyType(b2BodyType bodyType)
@@ -148,6 +148,8 @@ namespace Engine
 		b2Body* body;				/// Points to collision body used in the b2World, only used when collision system has been started
 		CollisionShapeType shapeType;			/// The Shape Type, AABB or Circle
 		b2Vec2 boxSize;			/// Variable that is in use when the shape is a box
+		uint32_t bodyIndex;			/// The index of this component in the dense body array of the collision system
+		static constexpr uint32_t InvalidBodyIndex = uint32_t(-1);
 
 		eastl::weak_ptr<TransformComponent> transformComponent;
 	};
@@ -11,7 +11,12 @@ namespace Engine
 		return owner;
 	}
 
-	Component::Component() : isEnabled(true)
+	uint32_t Component::GetComponentTypeId() const
+	{
+		return componentTypeId;
+	}
+
+	Component::Component() : isEnabled(true), canUpdateInParallel(false), receivesContacts(false), componentTypeId(0)
 	{
 	}
 
@@ -23,10 +23,17 @@ namespace Engine
 		/// <returns>Returns the owner of this component.</returns>
 		eastl::weak_ptr<Entity> GetOwner() const;
 
+		/// <summary>
+		/// This method allows you to get the id of the type of this component.
+		/// </summary>
+		/// <returns>Returns the component type id of this component.</returns>
+		uint32_t GetComponentTypeId() const;
+
 		bool isEnabled;
 
 	protected:
 		friend class Entity;
+		friend class EntitySystem;
 		explicit Component();
 
 		/// <summary>
@@ -39,6 +46,20 @@ namespace Engine
 		/// </summary>
 		virtual void Update();
 
+		/// <summary>
+		/// Set this to true if the Update method of this component only touches data owned by this component.
+		/// The entity system will then update this component on the job system, in parallel with the components of other entities.
+		/// False by default.
+		/// </summary>
+		bool canUpdateInParallel;
+
+		/// <summary>
+		/// Set this to true in the constructor if this component wants to receive OnBeginContact and OnEndContact calls.
+		/// The collision system only dispatches contacts to the components that set this value.
+		/// False by default.
+		/// </summary>
+		bool receivesContacts;
+
 		/// <summary>
 		/// This method will be called whenever a component has been added to the entity.
 		/// </summary>
@@ -118,7 +139,18 @@ namespace Engine
 		template <typename archive>
 		void LoadBaseComponent(archive ar);
 
+		/// <summary>
+		/// This method will be called after the step in which the collision-body of this entity started touching another collision-body.
+		/// NOTE: Only called when receivesContacts is set to true.
+		/// </summary>
+		/// <param name="entity">The entity that is touched, empty if its collision component has been removed in the meantime.</param>
 		virtual void OnBeginContact(eastl::weak_ptr<Entity> entity);
+
+		/// <summary>
+		/// This method will be called after the step in which the collision-body of this entity stopped touching another collision-body.
+		/// NOTE: Only called when receivesContacts is set to true.
+		/// </summary>
+		/// <param name="entity">The entity that was touched, empty if its collision component has been removed in the meantime.</param>
 		virtual void OnEndContact(eastl::weak_ptr<Entity> entity);
 
 		/// <summary>
@@ -144,6 +176,7 @@ namespace Engine
 
 		eastl::weak_ptr<Entity> owner;
 		eastl::weak_ptr<Component> pointerReference;
+		uint32_t componentTypeId;
 
 	};
 
@@ -0,0 +1,317 @@
+#pragma once
+
+#include "Engine/api.hpp"
+#include "Engine/Components/Component.hpp"
+
+#include <ThirdParty/EASTL-master/include/EASTL/shared_ptr.h>
+#include <ThirdParty/EASTL-master/include/EASTL/unique_ptr.h>
+#include <ThirdParty/EASTL-master/include/EASTL/vector.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Engine
+{
+	/// <summary>
+	/// Returns the index of the lowest set bit of the given value. NOTE: The value may not be 0.
+	/// </summary>
+	inline size_t GetLowestBitIndex(uint64_t value)
+	{
+#if defined(_MSC_VER) && defined(_WIN64)
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return size_t(index);
+#elif defined(__GNUC__) || defined(__clang__)
+		return size_t(__builtin_ctzll(value));
+#else
+		size_t index = 0;
+		while ((value & 1) == 0)
+		{
+			value >>= 1;
+			++index;
+		}
+		return index;
+#endif
+	}
+
+	/// <summary>
+	/// Type erased base class of the component pools. This allows the entity system to own pools of every component type.
+	/// </summary>
+	class ComponentPoolBase
+	{
+	public:
+		virtual ~ComponentPoolBase() = default;
+
+		/// <summary>
+		/// Returns the amount of living components in this pool.
+		/// </summary>
+		virtual size_t GetCount() const = 0;
+
+		/// <summary>
+		/// Set once a component in this pool has been added with canUpdateInParallel set, the entity system skips the parallel update until then.
+		/// </summary>
+		bool hasParallelComponents = false;
+	};
+
+	template<typename ComponentType>
+	/// <summary>
+	/// This pool stores all components of a single type contiguously in fixed size chunks.
+	/// Chunks are never moved or released while the pool is alive, so the address of a component stays stable for its entire lifetime.
+	/// NOTE: The pool only hands out raw memory, constructing and destructing the components is up to the caller.
+	/// </summary>
+	class ComponentPool : public ComponentPoolBase
+	{
+		struct Chunk;
+
+	public:
+		/// <summary>
+		/// Iterates over the living components of a pool in memory order.
+		/// </summary>
+		class Iterator
+		{
+		public:
+			Iterator(const eastl::unique_ptr<Chunk>* chunk, const eastl::unique_ptr<Chunk>* chunkEnd);
+
+			ComponentType& operator*() const;
+			ComponentType* operator->() const;
+			Iterator& operator++();
+			bool operator==(const Iterator& other) const;
+			bool operator!=(const Iterator& other) const;
+
+		private:
+			/// <summary>
+			/// Moves to the first chunk that still has living components left and caches the index of that component.
+			/// </summary>
+			void SkipEmptyChunks();
+
+			const eastl::unique_ptr<Chunk>* chunk;
+			const eastl::unique_ptr<Chunk>* chunkEnd;
+			uint64_t remainingMask;
+			size_t indexInChunk;
+		};
+
+		/// <summary>
+		/// The amount of components stored in a single chunk. Matches the amount of bits in the alive mask of a chunk.
+		/// </summary>
+		static constexpr size_t ChunkCapacity = 64;
+
+		/// <summary>
+		/// Reserves the memory for a single component.
+		/// </summary>
+		/// <param name="slotIndex">Will be set to the slot index of the reserved memory, this index is required to free the memory again.</param>
+		/// <returns>Returns uninitialized memory large enough to construct a component of the given type in.</returns>
+		void* Allocate(uint32_t& slotIndex);
+
+		/// <summary>
+		/// Releases the memory of the given slot so it can be reused. NOTE: The component living in this slot should already be destructed.
+		/// </summary>
+		/// <param name="slotIndex">The slot index returned by Allocate.</param>
+		void Free(uint32_t slotIndex);
+
+		template<typename Function>
+		/// <summary>
+		/// Calls the given function for every living component in this pool, walking the chunks in memory order.
+		/// </summary>
+		/// <param name="function">The function to call, this function should accept a reference to the component type.</param>
+		void ForEach(Function function) const;
+
+		size_t GetCount() const override;
+
+		Iterator begin() const;
+		Iterator end() const;
+
+	private:
+		struct Chunk
+		{
+			alignas(ComponentType) unsigned char storage[ChunkCapacity * sizeof(ComponentType)];
+			uint64_t aliveMask = 0;
+		};
+
+		eastl::vector<eastl::unique_ptr<Chunk>> chunks;
+		eastl::vector<uint32_t> freeSlots;
+		size_t count = 0;
+	};
+
+	template<typename ComponentType>
+	/// <summary>
+	/// A non-owning view over all components of a single type. Iterating a view walks the component pool in memory order without allocating.
+	/// NOTE: Adding or removing components of this type while iterating invalidates the view.
+	/// </summary>
+	class ComponentView
+	{
+	public:
+		explicit ComponentView(const ComponentPool<ComponentType>* pool);
+
+		typename ComponentPool<ComponentType>::Iterator begin() const;
+		typename ComponentPool<ComponentType>::Iterator end() const;
+
+		/// <summary>
+		/// Returns the amount of components in this view.
+		/// </summary>
+		size_t GetCount() const;
+
+	private:
+		const ComponentPool<ComponentType>* pool;
+	};
+
+	template<typename ComponentType>
+	/// <summary>
+	/// The deleter used by the shared pointers of pooled components. Destructs the component and returns its memory to the pool.
+	/// NOTE: The deleter keeps the pool alive, so a component is allowed to outlive the entity system.
+	/// </summary>
+	struct ComponentPoolDeleter
+	{
+		eastl::shared_ptr<ComponentPool<ComponentType>> pool;
+		uint32_t slotIndex;
+
+		void operator()(ComponentType* component) const
+		{
+			// Destruct through the base class, some components do not expose their destructor.
+			static_cast<Component*>(component)->~Component();
+			pool->Free(slotIndex);
+		}
+	};
+
+	template <typename ComponentType>
+	void* ComponentPool<ComponentType>::Allocate(uint32_t& slotIndex)
+	{
+		if (freeSlots.empty())
+		{
+			const uint32_t firstSlot = uint32_t(chunks.size() * ChunkCapacity);
+			chunks.push_back(eastl::unique_ptr<Chunk>(new Chunk()));
+
+			// Push the slots in reverse so the lowest slot is handed out first.
+			for (uint32_t i = ChunkCapacity; i > 0; --i)
+				freeSlots.push_back(firstSlot + i - 1);
+		}
+
+		slotIndex = freeSlots.back();
+		freeSlots.pop_back();
+
+		Chunk* chunk = chunks[slotIndex / ChunkCapacity].get();
+		const size_t indexInChunk = slotIndex % ChunkCapacity;
+		chunk->aliveMask |= uint64_t(1) << indexInChunk;
+		++count;
+
+		return chunk->storage + indexInChunk * sizeof(ComponentType);
+	}
+
+	template <typename ComponentType>
+	void ComponentPool<ComponentType>::Free(uint32_t slotIndex)
+	{
+		Chunk* chunk = chunks[slotIndex / ChunkCapacity].get();
+		chunk->aliveMask &= ~(uint64_t(1) << (slotIndex % ChunkCapacity));
+		freeSlots.push_back(slotIndex);
+		--count;
+	}
+
+	template <typename ComponentType>
+	template <typename Function>
+	void ComponentPool<ComponentType>::ForEach(Function function) const
+	{
+		for (size_t i = 0, size = chunks.size(); i < size; ++i)
+		{
+			Chunk* chunk = chunks[i].get();
+			ComponentType* components = reinterpret_cast<ComponentType*>(chunk->storage);
+
+			// Clearing the lowest bit every step visits exactly the living components of this chunk.
+			for (uint64_t aliveMask = chunk->aliveMask; aliveMask != 0; aliveMask &= aliveMask - 1)
+				function(components[GetLowestBitIndex(aliveMask)]);
+		}
+	}
+
+	template <typename ComponentType>
+	size_t ComponentPool<ComponentType>::GetCount() const
+	{
+		return count;
+	}
+
+	template <typename ComponentType>
+	typename ComponentPool<ComponentType>::Iterator ComponentPool<ComponentType>::begin() const
+	{
+		return Iterator(chunks.begin(), chunks.end());
+	}
+
+	template <typename ComponentType>
+	typename ComponentPool<ComponentType>::Iterator ComponentPool<ComponentType>::end() const
+	{
+		return Iterator(chunks.end(), chunks.end());
+	}
+
+	template <typename ComponentType>
+	ComponentPool<ComponentType>::Iterator::Iterator(const eastl::unique_ptr<Chunk>* chunk, const eastl::unique_ptr<Chunk>* chunkEnd)
+		: chunk(chunk), chunkEnd(chunkEnd), remainingMask(chunk != chunkEnd ? (*chunk)->aliveMask : 0), indexInChunk(0)
+	{
+		SkipEmptyChunks();
+	}
+
+	template <typename ComponentType>
+	ComponentType& ComponentPool<ComponentType>::Iterator::operator*() const
+	{
+		return reinterpret_cast<ComponentType*>((*chunk)->storage)[indexInChunk];
+	}
+
+	template <typename ComponentType>
+	ComponentType* ComponentPool<ComponentType>::Iterator::operator->() const
+	{
+		return &**this;
+	}
+
+	template <typename ComponentType>
+	typename ComponentPool<ComponentType>::Iterator& ComponentPool<ComponentType>::Iterator::operator++()
+	{
+		remainingMask &= remainingMask - 1;
+		SkipEmptyChunks();
+		return *this;
+	}
+
+	template <typename ComponentType>
+	bool ComponentPool<ComponentType>::Iterator::operator==(const Iterator& other) const
+	{
+		return chunk == other.chunk && remainingMask == other.remainingMask;
+	}
+
+	template <typename ComponentType>
+	bool ComponentPool<ComponentType>::Iterator::operator!=(const Iterator& other) const
+	{
+		return !(*this == other);
+	}
+
+	template <typename ComponentType>
+	void ComponentPool<ComponentType>::Iterator::SkipEmptyChunks()
+	{
+		while (remainingMask == 0 && chunk != chunkEnd)
+		{
+			++chunk;
+			if (chunk != chunkEnd)
+				remainingMask = (*chunk)->aliveMask;
+		}
+
+		if (remainingMask != 0)
+			indexInChunk = GetLowestBitIndex(remainingMask);
+	}
+
+	template <typename ComponentType>
+	ComponentView<ComponentType>::ComponentView(const ComponentPool<ComponentType>* pool) : pool(pool)
+	{
+	}
+
+	template <typename ComponentType>
+	typename ComponentPool<ComponentType>::Iterator ComponentView<ComponentType>::begin() const
+	{
+		return pool->begin();
+	}
+
+	template <typename ComponentType>
+	typename ComponentPool<ComponentType>::Iterator ComponentView<ComponentType>::end() const
+	{
+		return pool->end();
+	}
+
+	template <typename ComponentType>
+	size_t ComponentView<ComponentType>::GetCount() const
+	{
+		return pool->GetCount();
+	}
+} // namespace Engine
\ No newline at end of file
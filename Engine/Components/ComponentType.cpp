@@ -0,0 +1,47 @@
+#include "Engine/Components/ComponentType.hpp"
+
+#include <ThirdParty/EASTL-master/include/EASTL/hash_map.h>
+#include <ThirdParty/EASTL-master/include/EASTL/string.h>
+
+#include <assert.h>
+#include <mutex>
+
+namespace Engine
+{
+	namespace
+	{
+		eastl::hash_map<eastl::string, uint32_t>& GetComponentTypeIds()
+		{
+			static eastl::hash_map<eastl::string, uint32_t> componentTypeIds;
+			return componentTypeIds;
+		}
+
+		std::mutex& GetComponentTypeIdsMutex()
+		{
+			static std::mutex componentTypeIdsMutex;
+			return componentTypeIdsMutex;
+		}
+	}
+
+	uint32_t ComponentTypeRegistry::RegisterComponentType(const char* componentTypeName)
+	{
+		std::lock_guard<std::mutex> lock(GetComponentTypeIdsMutex());
+		eastl::hash_map<eastl::string, uint32_t>& componentTypeIds = GetComponentTypeIds();
+
+		eastl::hash_map<eastl::string, uint32_t>::iterator it = componentTypeIds.find(eastl::string(componentTypeName));
+		if (it != componentTypeIds.end())
+			return it->second;
+
+		const uint32_t id = uint32_t(componentTypeIds.size());
+		assert(id < MaxComponentTypes); // Too many component types, increase MaxComponentTypes.
+
+		componentTypeIds.insert(eastl::make_pair(eastl::string(componentTypeName), id));
+		return id;
+	}
+
+	uint32_t ComponentTypeRegistry::GetComponentTypeCount()
+	{
+		std::lock_guard<std::mutex> lock(GetComponentTypeIdsMutex());
+		return uint32_t(GetComponentTypeIds().size());
+	}
+} // namespace Engine
\ No newline at end of file
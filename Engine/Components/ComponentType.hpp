@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Engine/api.hpp"
+
+#include <ThirdParty/EASTL-master/include/EASTL/bitset.h>
+
+#include <typeinfo>
+
+namespace Engine
+{
+	/// <summary>
+	/// This object hands out the ids of the component types. The ids are handed out by the engine library itself, 
+	/// which makes sure every module that uses a component type receives the same id for that type.
+	/// </summary>
+	class ENGINE_API ComponentTypeRegistry
+	{
+	public:
+		/// <summary>
+		/// The maximum amount of component types that can be registered. This is also the amount of bits in a component mask.
+		/// </summary>
+		static constexpr size_t MaxComponentTypes = 128;
+
+		/// <summary>
+		/// Returns the id of the component type with the given name. The type will be registered if it hasn't been registered yet.
+		/// NOTE: Use ComponentTypeId instead, which only calls this method once per component type.
+		/// </summary>
+		/// <param name="componentTypeName">The name of the component type as returned by typeid.</param>
+		/// <returns>Returns the id of the given component type.</returns>
+		static uint32_t RegisterComponentType(const char* componentTypeName);
+
+		/// <summary>
+		/// Returns the amount of component types that have been registered so far.
+		/// </summary>
+		static uint32_t GetComponentTypeCount();
+	};
+
+	/// <summary>
+	/// A bitmask with a bit for every component type id.
+	/// </summary>
+	typedef eastl::bitset<ComponentTypeRegistry::MaxComponentTypes> ComponentMask;
+
+	template<typename ComponentType>
+	/// <summary>
+	/// Allows you to get the id of the given component type. The id is resolved only once, after which it's a single static load.
+	/// </summary>
+	class ComponentTypeId
+	{
+	public:
+		static uint32_t Get()
+		{
+			static const uint32_t id = ComponentTypeRegistry::RegisterComponentType(typeid(ComponentType).name());
+			return id;
+		}
+	};
+} // namespace Engine
\ No newline at end of file
@@ -6,7 +6,7 @@ namespace Engine
 {
 	ModelComponent::ModelComponent(eastl::shared_ptr<Model> newModel) noexcept : Component()
 	{
-		model = newModel;
+		AssignModel(newModel);
 		isEnabled = true;
 	}
 
@@ -26,11 +26,12 @@ namespace Engine
 	ModelComponent::~ModelComponent()
 	{
 		Engine::GetEngine().lock()->GetRenderer().lock()->OnRender -= Sharp::EventHandler::Bind(&ModelComponent::Render, this);
+		AssignModel(nullptr);
 	}
 
 	void ModelComponent::SetModel(eastl::shared_ptr<Model> newModel)
 	{
-		model = newModel;
+		AssignModel(newModel);
 	}
 
 	void ModelComponent::SetModel(const eastl::string& path)
@@ -44,7 +45,7 @@ namespace Engine
 		if (model.expired() == false && model.lock().get() != nullptr)
 		{
 			this->path = path;
-			this->model = model;
+			AssignModel(model.lock());
 		}
 	}
 
@@ -72,7 +73,14 @@ namespace Engine
 		if (transformComponent.expired())
 			return;
 
-		Engine::GetEngine().lock()->GetRenderer().lock()->Render(transformComponent.lock()->GetModelMatrix(), Engine::GetEngine().lock()->GetResourceManager().lock()->GetModel(model.lock()->GetName()).lock());
+		// The model has been looked up when it was assigned, here it only has to be marked as used.
+		// A model that is being loaded again after its meshes were evicted is skipped until the load has finished.
+		const eastl::shared_ptr<Model> renderedModel = model.lock();
+		Engine::GetEngine().lock()->GetResourceManager().lock()->UseModel(renderedModel);
+		if (renderedModel->GetLoadState() != ModelLoadState::LOADED)
+			return;
+
+		Engine::GetEngine().lock()->GetRenderer().lock()->Render(transformComponent.lock()->GetModelMatrix(), renderedModel);
 	}
 
 	void ModelComponent::OnComponentAdded(eastl::weak_ptr<Component> addedComponent)
@@ -92,6 +100,20 @@ namespace Engine
 		transformComponent = GetComponent<TransformComponent>();
 	}
 
+	void ModelComponent::AssignModel(const eastl::shared_ptr<Model>& newModel)
+	{
+		const eastl::shared_ptr<Model> oldModel = model.lock();
+		if (oldModel == newModel)
+			return;
+
+		if (oldModel != nullptr)
+			--oldModel->componentCount;
+		if (newModel != nullptr)
+			++newModel->componentCount;
+
+		model = newModel;
+	}
+
 	template <typename archive>
 	void ModelComponent::SaveComponent(archive ar)
 	{
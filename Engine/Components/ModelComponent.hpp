@@ -73,6 +73,11 @@ namespace Engine
 		void OnComponentAdded(eastl::weak_ptr<Component> addedComponent) override;
 		void OnComponentRemoved(eastl::weak_ptr<Component> removedComponent) override;
 
+		/// <summary>
+		/// Replaces the model of this component and moves the hold on the model over to the new one, see ResourceManager::SetMemoryBudget.
+		/// </summary>
+		void AssignModel(const eastl::shared_ptr<Model>& newModel);
+
 		eastl::weak_ptr<Model> model;
 		eastl::weak_ptr<TransformComponent> transformComponent;
 		eastl::string path;
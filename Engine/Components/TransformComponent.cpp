@@ -1,6 +1,6 @@
 #include "Engine/Components/TransformComponent.hpp"
-#include <ThirdParty/glm/glm/gtc/matrix_transform.hpp>
-#include <ThirdParty/glm/glm/gtx/euler_angles.hpp>
+#include "Engine/Components/TransformHierarchy.hpp"
+#include "Engine/engine.hpp"
 
 namespace Engine
 {
@@ -32,9 +32,36 @@ namespace Engine
 	{
 	}
 
-	TransformComponent::TransformComponent(glm::vec3 position, glm::vec3 rotation, glm::vec3 scale, bool isStatic) noexcept : position(position), rotation(rotation), scale(scale), isStatic(isStatic)
+	TransformComponent::TransformComponent(glm::vec3 position, glm::vec3 rotation, glm::vec3 scale, bool isStatic) noexcept : position(position), rotation(EulerToQuaternion(rotation)), scale(scale), isStatic(isStatic)
 	{
-		UpdateModelMatrix();
+	}
+
+	TransformComponent::TransformComponent(const TransformComponent& other) noexcept : position(other.position), rotation(other.rotation), scale(other.scale), isStatic(other.isStatic)
+	{
+	}
+
+	TransformComponent::~TransformComponent()
+	{
+		if (hierarchy != nullptr)
+			hierarchy->RemoveNode(nodeIndex);
+		if (spatialGrid != nullptr)
+			spatialGrid->Remove(spatialProxy);
+		if (collisionSystem != nullptr && (collisionBodyCount > 0 || isQueuedForTeleport))
+			collisionSystem->RemoveTransformComponent(this);
+	}
+
+	void TransformComponent::InitializeComponent()
+	{
+		if (hierarchy != nullptr)
+			return;
+
+		hierarchy = Engine::GetEngine().lock()->GetEntitySystem().lock()->transformHierarchy.get();
+		nodeIndex = hierarchy->AddNode(this);
+
+		// The world position isn't known until the hierarchy has been updated, the node has been queued so the hierarchy moves it to its world position.
+		collisionSystem = Engine::GetEngine().lock()->GetCollisionSystem().lock().get();
+		spatialGrid = &collisionSystem->spatialGrid_;
+		spatialProxy = spatialGrid->Insert(this, glm::vec2(position));
 	}
 
 	void TransformComponent::SetPosition(glm::vec3 position) noexcept
@@ -42,7 +69,8 @@ namespace Engine
 		if (isStatic) return;
 
 		this->position = position;
-		shouldRecalculateModelMatrix = true;
+		QueueCollisionTeleport();
+		UpdateModelMatrix();
 	}
 
 	void TransformComponent::SetPosition(float x, float y, float z) noexcept
@@ -59,8 +87,8 @@ namespace Engine
 	{
 		if (isStatic) return;
 
-		this->rotation = rotation;
-		shouldRecalculateModelMatrix = true;
+		this->rotation = EulerToQuaternion(rotation);
+		UpdateModelMatrix();
 	}
 
 	void TransformComponent::SetRotation(float x, float y, float z) noexcept
@@ -68,7 +96,20 @@ namespace Engine
 		SetRotation(glm::vec3(x, y, z));
 	}
 
+	void TransformComponent::SetRotation(glm::quat rotation) noexcept
+	{
+		if (isStatic) return;
+
+		this->rotation = glm::normalize(rotation);
+		UpdateModelMatrix();
+	}
+
 	glm::vec3 TransformComponent::GetRotation() noexcept
+	{
+		return QuaternionToEuler(rotation);
+	}
+
+	glm::quat TransformComponent::GetRotationQuaternion() const noexcept
 	{
 		return rotation;
 	}
@@ -78,7 +119,7 @@ namespace Engine
 		if (isStatic) return;
 
 		this->scale = scale;
-		shouldRecalculateModelMatrix = true;
+		UpdateModelMatrix();
 	}
 
 	void TransformComponent::SetScale(float x, float y, float z) noexcept
@@ -95,8 +136,13 @@ namespace Engine
 	{
 		if (isStatic) return;
 
-		this->modelMatrix = modelMatrix;
-		shouldRecalculateModelMatrix = true;
+		// Split the matrix up into the position, rotation and scale it is built from.
+		scale = glm::vec3(glm::length(glm::vec3(modelMatrix[0])), glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2])));
+		position = glm::vec3(modelMatrix[3]);
+		rotation = glm::normalize(glm::quat_cast(glm::mat3x3(glm::vec3(modelMatrix[0]) / scale.x, glm::vec3(modelMatrix[1]) / scale.y, glm::vec3(modelMatrix[2]) / scale.z)));
+
+		QueueCollisionTeleport();
+		UpdateModelMatrix();
 	}
 
 	void TransformComponent::SetModelMatrix(float modelMatrix[16]) noexcept
@@ -115,9 +161,42 @@ namespace Engine
 			modelMatrix[3].x, modelMatrix[3].y, modelMatrix[3].z, modelMatrix[3].w));
 	}
 
-	glm::mat4x4 TransformComponent::GetModelMatrix() noexcept
+	glm::mat4x4 TransformComponent::GetModelMatrix() const noexcept
+	{
+		if (hierarchy == nullptr)
+			return CalculateLocalMatrix();
+
+		return hierarchy->worldMatrices[nodeIndex];
+	}
+
+	bool TransformComponent::SetParent(eastl::weak_ptr<TransformComponent> parent) noexcept
+	{
+		if (hierarchy == nullptr)
+			return false;
+
+		uint32_t parentIndex = TransformHierarchy::InvalidIndex;
+		if (parent.expired() == false)
+		{
+			const eastl::shared_ptr<TransformComponent> parentTransform = parent.lock();
+			if (parentTransform->hierarchy != hierarchy)
+				return false;
+
+			parentIndex = parentTransform->nodeIndex;
+		}
+
+		return hierarchy->SetParent(nodeIndex, parentIndex);
+	}
+
+	eastl::weak_ptr<TransformComponent> TransformComponent::GetParent() noexcept
 	{
-		return modelMatrix;
+		if (hierarchy == nullptr)
+			return eastl::weak_ptr<TransformComponent>();
+
+		TransformComponent* parent = hierarchy->GetParent(nodeIndex);
+		if (parent == nullptr)
+			return eastl::weak_ptr<TransformComponent>();
+
+		return eastl::static_pointer_cast<TransformComponent>(parent->GetPointerRefence().lock());
 	}
 
 	void TransformComponent::SetIsStatic(bool isStatic) noexcept
@@ -135,7 +214,8 @@ namespace Engine
 		if (isStatic) return;
 
 		position += positionToAdd;
-		shouldRecalculateModelMatrix = true;
+		QueueCollisionTeleport();
+		UpdateModelMatrix();
 	}
 
 	void TransformComponent::Translate(float x) noexcept
@@ -157,7 +237,8 @@ namespace Engine
 	{
 		if (isStatic) return;
 
-		rotation += rotationToAdd;
+		rotation = glm::normalize(rotation * EulerToQuaternion(rotationToAdd));
+		UpdateModelMatrix();
 	}
 
 	void TransformComponent::AddRotate(float x) noexcept
@@ -180,7 +261,7 @@ namespace Engine
 		if (isStatic) return;
 
 		scale += scaleToAdd;
-		shouldRecalculateModelMatrix = true;
+		UpdateModelMatrix();
 	}
 
 	void TransformComponent::AddScale(float x) noexcept
@@ -200,58 +281,106 @@ namespace Engine
 
 	glm::vec3 TransformComponent::GetRight() noexcept
 	{
-		return glm::normalize(glm::vec3(modelMatrix[0]));
+		return glm::normalize(glm::vec3(GetModelMatrix()[0]));
 	}
 
 	glm::vec3 TransformComponent::GetUp() noexcept
 	{
-		return glm::normalize(glm::vec3(modelMatrix[1]));
+		return glm::normalize(glm::vec3(GetModelMatrix()[1]));
 	}
 
 	glm::vec3 TransformComponent::GetForward() noexcept
 	{
-		return glm::normalize(glm::vec3(modelMatrix[2]));
+		return glm::normalize(glm::vec3(GetModelMatrix()[2]));
 	}
 
-	void TransformComponent::LookAt(TransformComponent target) noexcept
+	void TransformComponent::LookAt(const TransformComponent& target) noexcept
 	{
-		LookAt(target.position);
+		LookAt(glm::vec3(target.GetModelMatrix()[3]));
 	}
 
 	void TransformComponent::LookAt(glm::vec3 targetPosition) noexcept
 	{
 		if (isStatic) return;
 
-		modelMatrix *= glm::lookAt(position, targetPosition, GetUp());
-		shouldRecalculateModelMatrix = true;
+		const glm::vec3 direction = targetPosition - glm::vec3(GetModelMatrix()[3]);
+		if (glm::dot(direction, direction) <= 0.0f) return;
+
+		// Build the rotation that points the forward axis towards the target, keeping the right axis horizontal.
+		const glm::vec3 forward = glm::normalize(direction);
+		glm::vec3 right = glm::cross(glm::vec3(0, 1, 0), forward);
+		right = glm::dot(right, right) > 0.0f ? glm::normalize(right) : glm::vec3(1, 0, 0);
+		const glm::vec3 up = glm::cross(forward, right);
+		glm::mat3x3 rotationMatrix(right, up, forward);
+
+		// The rotation is stored relative to the parent.
+		const eastl::shared_ptr<TransformComponent> parent = GetParent().lock();
+		if (parent != nullptr)
+		{
+			const glm::mat4x4 parentMatrix = parent->GetModelMatrix();
+			const glm::mat3x3 parentRotation(glm::normalize(glm::vec3(parentMatrix[0])), glm::normalize(glm::vec3(parentMatrix[1])), glm::normalize(glm::vec3(parentMatrix[2])));
+			rotationMatrix = glm::transpose(parentRotation) * rotationMatrix;
+		}
+
+		rotation = glm::normalize(glm::quat_cast(rotationMatrix));
+		UpdateModelMatrix();
 	}
 
 	void TransformComponent::RotateAround(float angle, glm::vec3 axis) noexcept
 	{
 		if (isStatic) return;
 
-		glm::mat4x4 rotationMatrix;
-		glm::rotate(rotationMatrix, angle, axis);
-		modelMatrix *= rotationMatrix;
+		rotation = glm::normalize(rotation * glm::angleAxis(angle, glm::normalize(axis)));
+
+		UpdateModelMatrix();
+	}
+
+	void TransformComponent::UpdateModelMatrix() noexcept
+	{
+		// Already queued, the hierarchy will pick up every change until it recalculates the matrix.
+		if (shouldRecalculateModelMatrix) return;
 
 		shouldRecalculateModelMatrix = true;
+		if (hierarchy != nullptr)
+			hierarchy->QueueNode(nodeIndex);
 	}
 
-	void TransformComponent::Update()
+	void TransformComponent::QueueCollisionTeleport() noexcept
 	{
-		if (shouldRecalculateModelMatrix == false) return;
+		// Transforms without collision-bodies never have to be looked at by the collision system.
+		if (collisionBodyCount == 0 || isQueuedForTeleport) return;
 
-		UpdateModelMatrix();
+		isQueuedForTeleport = true;
+		collisionSystem->movedTransforms_.push_back(this);
 	}
 
-	void TransformComponent::UpdateModelMatrix() noexcept
+	glm::mat4x4 TransformComponent::CalculateLocalMatrix() const noexcept
+	{
+		glm::mat4x4 localMatrix = glm::mat4_cast(rotation);
+		localMatrix[0] *= scale.x;
+		localMatrix[1] *= scale.y;
+		localMatrix[2] *= scale.z;
+		localMatrix[3] = glm::vec4(position, 1);
+
+		return localMatrix;
+	}
+
+	glm::quat TransformComponent::EulerToQuaternion(glm::vec3 eulerAngles) noexcept
+	{
+		return glm::angleAxis(eulerAngles.y, glm::vec3(0, 1, 0)) * glm::angleAxis(eulerAngles.x, glm::vec3(1, 0, 0)) * glm::angleAxis(eulerAngles.z, glm::vec3(0, 0, 1));
+	}
+
+	glm::vec3 TransformComponent::QuaternionToEuler(const glm::quat& rotation) noexcept
 	{
-		glm::mat4x4 rotationMatrix = glm::eulerAngleYXZ(rotation.y, rotation.x, rotation.z);
-		glm::mat4x4 rotationScaleMatrix = rotationMatrix * glm::scale(rotationMatrix, scale);
-		rotationScaleMatrix[3] = glm::vec4(position, 1);
+		// Inverse of EulerToQuaternion, the rotation is applied around the y axis first, then the x axis and then the z axis.
+		const glm::mat3x3 rotationMatrix = glm::mat3_cast(rotation);
+		const float y = glm::atan(rotationMatrix[2][0], rotationMatrix[2][2]);
+		const float x = glm::atan(-rotationMatrix[2][1], glm::sqrt(rotationMatrix[0][1] * rotationMatrix[0][1] + rotationMatrix[1][1] * rotationMatrix[1][1]));
+		const float sinY = glm::sin(y);
+		const float cosY = glm::cos(y);
+		const float z = glm::atan(sinY * rotationMatrix[1][2] - cosY * rotationMatrix[1][0], cosY * rotationMatrix[0][0] - sinY * rotationMatrix[0][2]);
 
-		modelMatrix = rotationScaleMatrix;
-		shouldRecalculateModelMatrix = false;
+		return glm::vec3(x, y, z);
 	}
 
 	bool TransformComponent::operator!=(TransformComponent& other)
@@ -2,9 +2,19 @@
 
 #include "Engine/Components/Component.hpp"
 #include <ThirdParty/glm/glm/glm.hpp>
+#include <ThirdParty/glm/glm/gtc/quaternion.hpp>
 
 namespace Engine
 {
+	class TransformHierarchy;
+	class SpatialGrid;
+	class CollisionSystem;
+
+	/// <summary>
+	/// This component holds the position, rotation and scale of an entity relative to its parent transform.
+	/// The rotation is stored as a quaternion, the methods taking euler angles expect radians applied in the y, x, z order.
+	/// The model matrices of all transforms are stored in the transform hierarchy of the entity system, changes are applied once per frame after the entities have been updated.
+	/// </summary>
 	class ENGINE_API TransformComponent : public Component
 	{
 	public:
@@ -16,6 +26,12 @@ namespace Engine
 		explicit TransformComponent(glm::vec3 position, glm::vec3 rotation, bool isStatic) noexcept;
 		explicit TransformComponent(glm::vec3 position, glm::vec3 rotation, glm::vec3 scale) noexcept;
 		explicit TransformComponent(glm::vec3 position, glm::vec3 rotation, glm::vec3 scale, bool isStatic) noexcept;
+		/// <summary>
+		/// Copies the position, rotation and scale of the given transform. The copy is not part of the transform hierarchy.
+		/// </summary>
+		TransformComponent(const TransformComponent& other) noexcept;
+		TransformComponent& operator=(const TransformComponent& other) = delete;
+		~TransformComponent() override;
 
 		void SetPosition(glm::vec3 position) noexcept;
 		void SetPosition(float x, float y, float z) noexcept;
@@ -23,7 +39,12 @@ namespace Engine
 
 		void SetRotation(glm::vec3 rotation) noexcept;
 		void SetRotation(float x, float y, float z) noexcept;
+		void SetRotation(glm::quat rotation) noexcept;
+		/// <summary>
+		/// Returns the rotation as euler angles. NOTE: The angles are calculated from the stored quaternion, use GetRotationQuaternion when possible.
+		/// </summary>
 		glm::vec3 GetRotation() noexcept;
+		glm::quat GetRotationQuaternion() const noexcept;
 
 		void SetScale(glm::vec3 scale) noexcept;
 		void SetScale(float x, float y, float z) noexcept;
@@ -32,7 +53,25 @@ namespace Engine
 		void SetModelMatrix(glm::mat4x4 modelMatrix) noexcept;
 		void SetModelMatrix(float modelMatrix[16]) noexcept;
 		void SetModelMatrix(glm::vec4 modelMatrix[4]) noexcept;
-		glm::mat4x4 GetModelMatrix() noexcept;
+		/// <summary>
+		/// Returns the model matrix of this transform, this includes the transforms of all of its parents.
+		/// NOTE: Changes made during this frame are applied once the entity system has updated the transform hierarchy.
+		/// </summary>
+		glm::mat4x4 GetModelMatrix() const noexcept;
+
+		/// <summary>
+		/// This method allows you to attach this transform to another transform. The position, rotation and scale of this transform become relative to the parent.
+		/// Use an empty pointer to detach this transform from its parent.
+		/// NOTE: This only works once the component has been added to an entity. A transform can't become a child of its own children.
+		/// </summary>
+		/// <param name="parent">The new parent of this transform.</param>
+		/// <returns>Returns true if the parent has been changed.</returns>
+		bool SetParent(eastl::weak_ptr<TransformComponent> parent) noexcept;
+
+		/// <summary>
+		/// Returns the parent of this transform, or an empty pointer if this transform has no parent.
+		/// </summary>
+		eastl::weak_ptr<TransformComponent> GetParent() noexcept;
 
 		void SetIsStatic(bool isStatic) noexcept;
 		bool GetIsStatic() noexcept;
@@ -42,6 +81,9 @@ namespace Engine
 		void Translate(float x, float y) noexcept;
 		void Translate(float x, float y, float z) noexcept;
 
+		/// <summary>
+		/// Rotates this transform by the given euler angles, relative to its current rotation.
+		/// </summary>
 		void AddRotate(glm::vec3 rotationToAdd) noexcept;
 		void AddRotate(float x) noexcept;
 		void AddRotate(float x, float y) noexcept;
@@ -56,25 +98,57 @@ namespace Engine
 		glm::vec3 GetUp() noexcept;
 		glm::vec3 GetForward() noexcept;
 
-		void LookAt(TransformComponent target) noexcept;
+		void LookAt(const TransformComponent& target) noexcept;
 		void LookAt(glm::vec3 targetPosition) noexcept;
 		void RotateAround(float angle, glm::vec3 axis) noexcept;
 
-		void Update() override;
+		/// <summary>
+		/// Queues the model matrix of this transform and of all of its children for recalculation.
+		/// </summary>
 		void UpdateModelMatrix() noexcept;
 
 		bool operator!=(TransformComponent& other);
 		bool operator==(TransformComponent& other);
 
 
+	protected:
+		void InitializeComponent() override;
+
 	private:
+		friend class TransformHierarchy;
+		friend class SpatialGrid;
+		friend class CollisionSystem;
+
+		/// <summary>
+		/// Calculates the matrix of this transform relative to its parent.
+		/// </summary>
+		glm::mat4x4 CalculateLocalMatrix() const noexcept;
+
+		/// <summary>
+		/// Queues the collision-bodies of this transform to be teleported to its position during the next update of the collision system.
+		/// </summary>
+		void QueueCollisionTeleport() noexcept;
+
+		static glm::quat EulerToQuaternion(glm::vec3 eulerAngles) noexcept;
+		static glm::vec3 QuaternionToEuler(const glm::quat& rotation) noexcept;
 
 		glm::vec3 position;
-		glm::vec3 rotation;
+		glm::quat rotation;
 		glm::vec3 scale;
 		bool isStatic;
+		// Set while the model matrix of this transform is queued for recalculation in the transform hierarchy.
 		bool shouldRecalculateModelMatrix = false;
 
-		glm::mat4x4 modelMatrix;
+		TransformHierarchy* hierarchy = nullptr;
+		uint32_t nodeIndex = uint32_t(-1);
+
+		// The spatial grid of the collision system stores the world position of this transform for proximity queries.
+		SpatialGrid* spatialGrid = nullptr;
+		uint32_t spatialProxy = uint32_t(-1);
+
+		// Moving this transform from outside of the collision system teleports its collision-bodies, the collision system keeps the body count up to date.
+		CollisionSystem* collisionSystem = nullptr;
+		uint32_t collisionBodyCount = 0;
+		bool isQueuedForTeleport = false;
 	};
 } // namespace Engine
\ No newline at end of file
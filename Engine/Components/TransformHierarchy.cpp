@@ -0,0 +1,296 @@
+#include "Engine/Components/TransformHierarchy.hpp"
+#include "Engine/Components/TransformComponent.hpp"
+#include "Engine/Collision/SpatialGrid.hpp"
+#include "Engine/engine.hpp"
+#include "Engine/Utility/TransformBatch.hpp"
+
+#include <ThirdParty/EASTL-master/include/EASTL/sort.h>
+
+namespace Engine
+{
+	constexpr uint32_t TransformHierarchy::InvalidIndex;
+
+	TransformHierarchy::~TransformHierarchy()
+	{
+		// Components can outlive the hierarchy, make sure they no longer refer to it.
+		for (size_t i = 0, size = components.size(); i < size; ++i)
+		{
+			if (components[i] == nullptr)
+				continue;
+
+			components[i]->hierarchy = nullptr;
+			components[i]->nodeIndex = InvalidIndex;
+		}
+	}
+
+	size_t TransformHierarchy::GetNodeCount() const
+	{
+		return components.size();
+	}
+
+	uint32_t TransformHierarchy::AddNode(TransformComponent* component)
+	{
+		// A new root node can be appended without breaking the depth first order.
+		const uint32_t nodeIndex = uint32_t(components.size());
+		components.push_back(component);
+		parentIndices.push_back(InvalidIndex);
+		subtreeSizes.push_back(1);
+		localMatrices.push_back(glm::mat4x4(1));
+		worldMatrices.push_back(glm::mat4x4(1));
+
+		component->shouldRecalculateModelMatrix = true;
+		QueueNode(nodeIndex);
+
+		return nodeIndex;
+	}
+
+	void TransformHierarchy::RemoveNode(uint32_t nodeIndex)
+	{
+		// The node stays behind as an empty placeholder, so removing a lot of nodes in a single frame only compacts the arrays once.
+		components[nodeIndex] = nullptr;
+		isOrderDirty = true;
+	}
+
+	bool TransformHierarchy::SetParent(uint32_t nodeIndex, uint32_t parentIndex)
+	{
+		for (uint32_t ancestor = parentIndex; ancestor != InvalidIndex; ancestor = parentIndices[ancestor])
+		{
+			if (ancestor == nodeIndex)
+				return false;
+		}
+
+		if (parentIndices[nodeIndex] == parentIndex)
+			return true;
+
+		parentIndices[nodeIndex] = parentIndex;
+		isOrderDirty = true;
+
+		// The world matrix of the whole subtree depends on the new parent.
+		if (components[nodeIndex]->shouldRecalculateModelMatrix == false)
+		{
+			components[nodeIndex]->shouldRecalculateModelMatrix = true;
+			QueueNode(nodeIndex);
+		}
+
+		return true;
+	}
+
+	TransformComponent* TransformHierarchy::GetParent(uint32_t nodeIndex) const
+	{
+		uint32_t parentIndex = parentIndices[nodeIndex];
+		while (parentIndex != InvalidIndex && components[parentIndex] == nullptr)
+			parentIndex = parentIndices[parentIndex];
+
+		return parentIndex != InvalidIndex ? components[parentIndex] : nullptr;
+	}
+
+	void TransformHierarchy::QueueNode(uint32_t nodeIndex)
+	{
+		std::lock_guard<std::mutex> lock(dirtyNodesMutex);
+		dirtyNodes.push_back(nodeIndex);
+	}
+
+	void TransformHierarchy::Update()
+	{
+		if (isOrderDirty)
+			RebuildOrder();
+
+		if (dirtyNodes.empty())
+			return;
+
+		// Sorting the queued nodes makes every subtree start before the nodes it contains, which allows skipping nodes that are already covered.
+		eastl::sort(dirtyNodes.begin(), dirtyNodes.end());
+
+		// Every queued node has a changed local matrix, these are composed in batches first.
+		const eastl::shared_ptr<JobSystem> jobSystem = Engine::GetEngine().lock()->GetJobSystem().lock();
+		jobSystem->ParallelFor(dirtyNodes.size(), LocalMatrixBatchSize, [this](size_t begin, size_t end)
+		{
+			UpdateLocalMatrices(begin, end);
+		});
+
+		dirtyRanges.clear();
+		uint32_t rangeEnd = 0;
+		for (size_t i = 0, size = dirtyNodes.size(); i < size; ++i)
+		{
+			const uint32_t nodeIndex = dirtyNodes[i];
+			if (nodeIndex < rangeEnd)
+				continue;
+
+			rangeEnd = nodeIndex + subtreeSizes[nodeIndex];
+			dirtyRanges.push_back(NodeRange{ nodeIndex, rangeEnd });
+		}
+		dirtyNodes.clear();
+
+		// The ranges never overlap and their parents are up to date, so the ranges can be updated in parallel.
+		jobSystem->ParallelFor(dirtyRanges.size(), DirtyRangeBatchSize, [this](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+				UpdateRange(dirtyRanges[i].begin, dirtyRanges[i].end);
+		});
+
+		// Exactly the nodes in the ranges have a new world position, only those have to be moved in the spatial grid.
+		for (size_t i = 0, size = dirtyRanges.size(); i < size; ++i)
+		{
+			for (uint32_t nodeIndex = dirtyRanges[i].begin; nodeIndex < dirtyRanges[i].end; ++nodeIndex)
+			{
+				TransformComponent* component = components[nodeIndex];
+				if (component->spatialGrid != nullptr)
+					component->spatialGrid->Move(component->spatialProxy, glm::vec2(worldMatrices[nodeIndex][3]));
+			}
+		}
+	}
+
+	void TransformHierarchy::UpdateLocalMatrices(size_t begin, size_t end)
+	{
+		TransformBatch batch;
+		glm::mat4x4* outputs[TransformBatch::Capacity];
+		size_t batchCount = 0;
+
+		for (size_t i = begin; i < end; ++i)
+		{
+			const uint32_t nodeIndex = dirtyNodes[i];
+			TransformComponent* component = components[nodeIndex];
+
+			batch.SetTransform(batchCount, component->position, component->rotation, component->scale);
+			outputs[batchCount] = &localMatrices[nodeIndex];
+			component->shouldRecalculateModelMatrix = false;
+
+			if (++batchCount == TransformBatch::Capacity)
+			{
+				ComposeTransforms(batch, batchCount, outputs);
+				batchCount = 0;
+			}
+		}
+
+		if (batchCount > 0)
+			ComposeTransforms(batch, batchCount, outputs);
+	}
+
+	void TransformHierarchy::UpdateRange(uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			const uint32_t parentIndex = parentIndices[i];
+			worldMatrices[i] = parentIndex == InvalidIndex ? localMatrices[i] : worldMatrices[parentIndex] * localMatrices[i];
+		}
+	}
+
+	void TransformHierarchy::RebuildOrder()
+	{
+		const uint32_t nodeCount = uint32_t(components.size());
+
+		// Attach the children of removed nodes to their closest living ancestor.
+		for (uint32_t i = 0; i < nodeCount; ++i)
+		{
+			if (components[i] == nullptr)
+				continue;
+
+			uint32_t parentIndex = parentIndices[i];
+			if (parentIndex == InvalidIndex || components[parentIndex] != nullptr)
+				continue;
+
+			while (parentIndex != InvalidIndex && components[parentIndex] == nullptr)
+				parentIndex = parentIndices[parentIndex];
+
+			parentIndices[i] = parentIndex;
+			if (components[i]->shouldRecalculateModelMatrix == false)
+			{
+				components[i]->shouldRecalculateModelMatrix = true;
+				dirtyNodes.push_back(i);
+			}
+		}
+
+		// Link the children of every node, iterating backwards keeps the children in their current order.
+		eastl::vector<uint32_t> firstChildren(nodeCount, InvalidIndex);
+		eastl::vector<uint32_t> nextSiblings(nodeCount, InvalidIndex);
+		eastl::vector<uint32_t> stack;
+		for (uint32_t i = nodeCount; i > 0; --i)
+		{
+			const uint32_t nodeIndex = i - 1;
+			if (components[nodeIndex] == nullptr)
+				continue;
+
+			const uint32_t parentIndex = parentIndices[nodeIndex];
+			if (parentIndex != InvalidIndex)
+			{
+				nextSiblings[nodeIndex] = firstChildren[parentIndex];
+				firstChildren[parentIndex] = nodeIndex;
+			}
+			else
+			{
+				// The roots are visited last to first, so the stack pops them in their current order.
+				stack.push_back(nodeIndex);
+			}
+		}
+
+		// Walk the trees depth first, the new order contains the old index of every living node.
+		eastl::vector<uint32_t> newOrder;
+		newOrder.reserve(nodeCount);
+		eastl::vector<uint32_t> children;
+		while (stack.empty() == false)
+		{
+			const uint32_t nodeIndex = stack.back();
+			stack.pop_back();
+			newOrder.push_back(nodeIndex);
+
+			children.clear();
+			for (uint32_t child = firstChildren[nodeIndex]; child != InvalidIndex; child = nextSiblings[child])
+				children.push_back(child);
+
+			for (size_t i = children.size(); i > 0; --i)
+				stack.push_back(children[i - 1]);
+		}
+
+		Reorder(newOrder);
+		isOrderDirty = false;
+	}
+
+	void TransformHierarchy::Reorder(const eastl::vector<uint32_t>& newOrder)
+	{
+		const uint32_t newCount = uint32_t(newOrder.size());
+
+		eastl::vector<uint32_t> oldToNew(components.size(), InvalidIndex);
+		for (uint32_t i = 0; i < newCount; ++i)
+			oldToNew[newOrder[i]] = i;
+
+		eastl::vector<TransformComponent*> newComponents(newCount);
+		eastl::vector<uint32_t> newParentIndices(newCount);
+		eastl::vector<glm::mat4x4> newLocalMatrices(newCount);
+		eastl::vector<glm::mat4x4> newWorldMatrices(newCount);
+		for (uint32_t i = 0; i < newCount; ++i)
+		{
+			const uint32_t oldIndex = newOrder[i];
+			const uint32_t oldParentIndex = parentIndices[oldIndex];
+
+			newComponents[i] = components[oldIndex];
+			newParentIndices[i] = oldParentIndex != InvalidIndex ? oldToNew[oldParentIndex] : InvalidIndex;
+			newLocalMatrices[i] = localMatrices[oldIndex];
+			newWorldMatrices[i] = worldMatrices[oldIndex];
+			newComponents[i]->nodeIndex = i;
+		}
+
+		components.swap(newComponents);
+		parentIndices.swap(newParentIndices);
+		localMatrices.swap(newLocalMatrices);
+		worldMatrices.swap(newWorldMatrices);
+
+		// Children are stored after their parents, so a single backwards pass accumulates the size of every subtree.
+		subtreeSizes.assign(newCount, 1);
+		for (uint32_t i = newCount; i > 0; --i)
+		{
+			const uint32_t parentIndex = parentIndices[i - 1];
+			if (parentIndex != InvalidIndex)
+				subtreeSizes[parentIndex] += subtreeSizes[i - 1];
+		}
+
+		// Queued nodes move along, queued nodes that have been removed are dropped.
+		size_t dirtyCount = 0;
+		for (size_t i = 0, size = dirtyNodes.size(); i < size; ++i)
+		{
+			const uint32_t newIndex = oldToNew[dirtyNodes[i]];
+			if (newIndex != InvalidIndex)
+				dirtyNodes[dirtyCount++] = newIndex;
+		}
+		dirtyNodes.resize(dirtyCount);
+	}
+} // namespace Engine
\ No newline at end of file
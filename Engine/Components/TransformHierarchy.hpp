@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Engine/api.hpp"
+
+#include <ThirdParty/EASTL-master/include/EASTL/vector.h>
+#include <ThirdParty/glm/glm/glm.hpp>
+
+#include <mutex>
+
+namespace Engine
+{
+	class TransformComponent;
+
+	/// <summary>
+	/// This object stores the parent child relations of all transform components together with their local and world matrices.
+	/// The nodes are stored in depth first order in contiguous arrays, so every parent is stored before its children and every subtree occupies a single range.
+	/// Changing a transform only queues its own node. The update composes the local matrices of all queued nodes in SIMD batches,
+	/// then walks the queued subtrees once and recalculates exactly the world matrices that depend on the change. The changed world positions are passed on to the spatial grid.
+	/// NOTE: This object can only be created by the EntitySystem.
+	/// </summary>
+	class ENGINE_API TransformHierarchy
+	{
+		friend class EntitySystem;
+		friend class TransformComponent;
+
+		TransformHierarchy() = default;
+	public:
+		~TransformHierarchy();
+
+		/// <summary>
+		/// The node index used for nodes that don't have a parent.
+		/// </summary>
+		static constexpr uint32_t InvalidIndex = uint32_t(-1);
+
+		/// <summary>
+		/// Returns the amount of nodes in this hierarchy.
+		/// </summary>
+		size_t GetNodeCount() const;
+
+	private:
+		/// <summary>
+		/// A range of nodes that has to be recalculated, the range always contains a complete subtree.
+		/// </summary>
+		struct NodeRange
+		{
+			uint32_t begin;
+			uint32_t end;
+		};
+
+		/// <summary>
+		/// The amount of dirty subtrees updated by a single job.
+		/// </summary>
+		static constexpr size_t DirtyRangeBatchSize = 32;
+
+		/// <summary>
+		/// The amount of local matrices composed by a single job.
+		/// </summary>
+		static constexpr size_t LocalMatrixBatchSize = 1024;
+
+		/// <summary>
+		/// Adds the given transform as a root node and queues it for an update.
+		/// </summary>
+		/// <returns>Returns the index of the new node.</returns>
+		uint32_t AddNode(TransformComponent* component);
+
+		/// <summary>
+		/// Removes the given node. The children of the node are attached to the parent of the removed node.
+		/// NOTE: The node arrays are compacted during the next update.
+		/// </summary>
+		void RemoveNode(uint32_t nodeIndex);
+
+		/// <summary>
+		/// Changes the parent of the given node, use InvalidIndex to turn the node into a root node.
+		/// NOTE: The node arrays are reordered during the next update.
+		/// </summary>
+		/// <returns>Returns false if the new parent is part of the subtree of the node, the parent will not be changed in that case.</returns>
+		bool SetParent(uint32_t nodeIndex, uint32_t parentIndex);
+
+		/// <summary>
+		/// Returns the component of the closest living parent of the given node, or nullptr if the node is a root node.
+		/// </summary>
+		TransformComponent* GetParent(uint32_t nodeIndex) const;
+
+		/// <summary>
+		/// Queues the given node, its local matrix and the world matrices of its subtree will be recalculated during the next update.
+		/// This method can be called from multiple threads at the same time.
+		/// </summary>
+		void QueueNode(uint32_t nodeIndex);
+
+		/// <summary>
+		/// Restores the depth first order if needed and recalculates the matrices of all queued subtrees.
+		/// </summary>
+		void Update();
+
+		/// <summary>
+		/// Composes the local matrices of the queued nodes in the given range of the dirty node list.
+		/// </summary>
+		void UpdateLocalMatrices(size_t begin, size_t end);
+
+		/// <summary>
+		/// Recalculates the world matrices of the given range of nodes in order.
+		/// </summary>
+		void UpdateRange(uint32_t begin, uint32_t end);
+
+		/// <summary>
+		/// Drops the removed nodes and rebuilds the depth first order from the parent indices.
+		/// </summary>
+		void RebuildOrder();
+
+		/// <summary>
+		/// Moves every node to the position given by the new order, newOrder[newIndex] contains the old index of the node.
+		/// </summary>
+		void Reorder(const eastl::vector<uint32_t>& newOrder);
+
+		eastl::vector<TransformComponent*> components;
+		eastl::vector<uint32_t> parentIndices;
+		eastl::vector<uint32_t> subtreeSizes;
+		eastl::vector<glm::mat4x4> localMatrices;
+		eastl::vector<glm::mat4x4> worldMatrices;
+
+		eastl::vector<uint32_t> dirtyNodes;
+		eastl::vector<NodeRange> dirtyRanges;
+		std::mutex dirtyNodesMutex;
+
+		// Set when nodes have been removed or reparented, the depth first order has to be restored before the next update.
+		bool isOrderDirty = false;
+	};
+} // namespace Engine
\ No newline at end of file
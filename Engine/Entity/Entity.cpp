@@ -29,13 +29,63 @@ namespace Engine
 
 		for (size_t i = 0, size = components.size(); i < size; ++i)
 		{
-			if (components[i]->isEnabled == false)
+			if (components[i]->isEnabled == false || components[i]->canUpdateInParallel)
 				continue;
 
 			components[i]->Update();
 		}
 	}
 
+	void Entity::UpdateParallelComponents()
+	{
+		for (size_t i = 0, size = components.size(); i < size; ++i)
+		{
+			if (components[i]->isEnabled == false || components[i]->canUpdateInParallel == false)
+				continue;
+
+			components[i]->Update();
+		}
+	}
+
+	void Entity::RemoveComponents(uint32_t componentTypeId, size_t amountToRemove)
+	{
+		if (amountToRemove == 0 || componentTypeId >= ComponentTypeRegistry::MaxComponentTypes || componentMask.test(componentTypeId) == false)
+			return;
+
+		// Removing components while the entities are being updated would pull them out from under the update loop, so the removal waits for the command buffer.
+		const eastl::shared_ptr<EntitySystem> entitySystem = Engine::GetEngine().lock()->GetEntitySystem().lock();
+		if (entitySystem->isUpdating && entitySystem->IsValid(Id))
+		{
+			entitySystem->commandBuffer->RemoveComponents(Id, componentTypeId, amountToRemove);
+			return;
+		}
+
+		eastl::vector<eastl::shared_ptr<Component>> removedComponents;
+		for (size_t i = components.size() - 1; i != size_t(-1) && removedComponents.size() < amountToRemove; --i)
+		{
+			if (components[i]->componentTypeId == componentTypeId)
+				removedComponents.push_back(eastl::move(components[i]));
+		}
+
+		// Close the gaps left behind by the removed components in one go, instead of erasing them one at a time.
+		size_t remainingCount = 0;
+		for (size_t i = 0, size = components.size(); i < size; ++i)
+		{
+			if (components[i] != nullptr)
+				components[remainingCount++] = eastl::move(components[i]);
+		}
+		components.resize(remainingCount);
+		UpdateComponentTable();
+
+		for (size_t i = 0, size = removedComponents.size(); i < size; ++i)
+			OnComponentRemoved(removedComponents[i]);
+	}
+
+	const ComponentMask& Entity::GetComponentMask() const
+	{
+		return componentMask;
+	}
+
 	size_t Entity::ComponentCount() const
 	{
 		return components.size();
@@ -61,6 +111,36 @@ namespace Engine
 		this->Id = Id;
 	}
 
+	eastl::shared_ptr<ComponentPoolBase>& Entity::GetComponentPoolReference(uint32_t componentTypeId)
+	{
+		eastl::vector<eastl::shared_ptr<ComponentPoolBase>>& componentPools = Engine::GetEngine().lock()->GetEntitySystem().lock()->componentPools;
+		if (componentTypeId >= componentPools.size())
+			componentPools.resize(componentTypeId + 1);
+
+		return componentPools[componentTypeId];
+	}
+
+	void Entity::UpdateComponentTable()
+	{
+		componentMask.reset();
+		firstComponentIndices.resize(ComponentTypeRegistry::GetComponentTypeCount());
+		contactListeners.clear();
+
+		// Walk backwards so the index of the first component of every type is the one that remains.
+		for (size_t i = components.size() - 1; i != size_t(-1); --i)
+		{
+			const uint32_t componentTypeId = components[i]->componentTypeId;
+			componentMask.set(componentTypeId);
+			firstComponentIndices[componentTypeId] = uint32_t(i);
+		}
+
+		for (size_t i = 0, size = components.size(); i < size; ++i)
+		{
+			if (components[i]->receivesContacts)
+				contactListeners.push_back(components[i].get());
+		}
+	}
+
 	void Entity::OnComponentAdded(eastl::weak_ptr<Component> addedComponent)
 	{
 		// No need to inform the last added component that it just has been added.
@@ -74,15 +154,21 @@ namespace Engine
 			components[i]->OnComponentRemoved(removedComponent);
 	}
 
+	bool Entity::HasContactListeners() const
+	{
+		return contactListeners.empty() == false;
+	}
+
 	void Entity::OnBeginContact(eastl::weak_ptr<Entity> entity)
 	{
-		for (size_t i = 0, size = components.size(); i < size; ++i)
-			components[i]->OnBeginContact(entity);
+		// The listeners can change the components of this entity, which rebuilds the list, so its size is checked every iteration.
+		for (size_t i = 0; i < contactListeners.size(); ++i)
+			contactListeners[i]->OnBeginContact(entity);
 	}
 
 	void Entity::OnEndContact(eastl::weak_ptr<Entity> entity)
 	{
-		for (size_t i = 0, size = components.size(); i < size; ++i)
-			components[i]->OnEndContact(entity);
+		for (size_t i = 0; i < contactListeners.size(); ++i)
+			contactListeners[i]->OnEndContact(entity);
 	}
 } // namespace Engine
\ No newline at end of file
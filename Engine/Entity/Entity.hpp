@@ -2,9 +2,13 @@
 #include "Engine/api.hpp"
 #include "Engine/Utility/Logging.hpp"
 #include "Engine/Components/Component.hpp"
+#include "Engine/Components/ComponentPool.hpp"
+#include "Engine/Components/ComponentType.hpp"
 
 #include <ThirdParty/EASTL-master/include/EASTL/string.h>
 
+#include <new>
+
 namespace Engine
 {
 	/// <summary>
@@ -19,6 +23,7 @@ namespace Engine
 		template<typename ComponentType>
 		/// <summary>
 		/// This method allows you to get the first component of the given type.
+		/// NOTE: Components are looked up by their exact type, components deriving from the given type are not returned.
 		/// </summary>
 		/// <returns>Returns the first component of the given type as a weak pointer.</returns>
 		eastl::weak_ptr<ComponentType> GetComponent();
@@ -26,10 +31,24 @@ namespace Engine
 		template<typename ComponentType>
 		/// <summary>
 		/// This method allows you to get all of the components of the given type.
+		/// NOTE: Components are looked up by their exact type, components deriving from the given type are not returned.
 		/// </summary>
 		/// <returns>Returns the all of the components of the given type as a weak pointer.</returns>
 		eastl::vector<eastl::weak_ptr<ComponentType>> GetComponents();
 
+		template<typename ComponentType>
+		/// <summary>
+		/// This method allows you to check if this entity has a component of the given type.
+		/// </summary>
+		/// <returns>Returns true if this entity has at least one component of the given type.</returns>
+		bool HasComponent() const;
+
+		/// <summary>
+		/// Returns the mask of component types this entity has. Every bit represents the component type id of that index.
+		/// </summary>
+		/// <returns>Returns the component mask of this entity.</returns>
+		const ComponentMask& GetComponentMask() const;
+
 		/// <summary>
 		/// Returns all the components of this entity.
 		/// </summary>
@@ -59,6 +78,7 @@ namespace Engine
 		template <typename ComponentType>
 		/// <summary>
 		/// Allows X amount of components of the given type.
+		/// NOTE: Removals requested while the entities or the collision system are being updated are recorded in the command buffer and applied after the update.
 		/// </summary>
 		/// <param name="amountToRemove">Will remove 1 component by default, can be change optionally.</param>
 		void RemoveComponent(size_t amountToRemove = 1);
@@ -66,6 +86,7 @@ namespace Engine
 		template <typename ComponentType>
 		/// <summary>
 		/// Deletes all the components of the given type.
+		/// NOTE: Removals requested while the entities or the collision system are being updated are recorded in the command buffer and applied after the update.
 		/// </summary>
 		void RemoveAllComponents();
 
@@ -77,6 +98,7 @@ namespace Engine
 
 		/// <summary>
 		/// The general update method of the Entity class.
+		/// NOTE: Components that can update in parallel are not updated by this method, the entity system updates those on the job system before calling this method.
 		/// </summary>
 		virtual void Update();
 
@@ -121,11 +143,51 @@ namespace Engine
 
 		bool isActive;
 		void SetID(uint64_t Id);
+
+		/// <summary>
+		/// Updates all the components of this entity that can update in parallel. Called by the entity system from the job system.
+		/// </summary>
+		void UpdateParallelComponents();
+
+		template <class ComponentType, class... Args>
+		/// <summary>
+		/// Constructs a component of the given type inside of the component pool of that type and adds it to this entity.
+		/// </summary>
+		eastl::shared_ptr<Component> CreateComponent(Args&&... args);
+
+		template <typename ComponentType>
+		/// <summary>
+		/// Returns the component pool of the given type, the pool will be created if it doesn't exist yet.
+		/// </summary>
+		static eastl::shared_ptr<ComponentPool<ComponentType>> GetComponentPool();
+
+		/// <summary>
+		/// Returns a reference to the pool entry of the given component type in the entity system.
+		/// </summary>
+		static eastl::shared_ptr<ComponentPoolBase>& GetComponentPoolReference(uint32_t componentTypeId);
+
+		/// <summary>
+		/// Rebuilds the component mask and the first component index table from the components vector.
+		/// This needs to be called whenever the components vector has been changed.
+		/// </summary>
+		void UpdateComponentTable();
+
+		/// <summary>
+		/// Removes X amount of components with the given component type id, starting with the most recently added component.
+		/// The remaining components are compacted in a single pass, after which every component is informed of the removals.
+		/// </summary>
+		void RemoveComponents(uint32_t componentTypeId, size_t amountToRemove);
+		friend class EntityCommandBuffer;
+
+		ComponentMask componentMask;
+		eastl::vector<uint32_t> firstComponentIndices;
+		eastl::vector<Component*> contactListeners;	/// The components that receive contacts, rebuilt together with the component table
 		void OnComponentAdded(eastl::weak_ptr<Component> addedComponent);
 		void OnComponentRemoved(eastl::weak_ptr<Component> removedComponent);
 
 		// Allows use of OnBeginContact and OnEndContact by EntityContact Callback class
 		friend class EntityContact;
+		bool HasContactListeners() const;
 		void OnBeginContact(eastl::weak_ptr<Entity> entity);
 		void OnEndContact(eastl::weak_ptr<Entity> entity);
 	};
@@ -133,14 +195,11 @@ namespace Engine
 	template <typename ComponentType>
 	eastl::weak_ptr<ComponentType> Entity::GetComponent()
 	{
-		for (size_t i = 0, size = components.size(); i < size; ++i)
-		{
-			if (dynamic_cast<ComponentType*>(components[i].get()))
-			{
-				return eastl::dynamic_pointer_cast<ComponentType>(components[i]);
-			}
-		}
-		return eastl::weak_ptr<ComponentType>();
+		const uint32_t componentTypeId = ComponentTypeId<ComponentType>::Get();
+		if (componentMask.test(componentTypeId) == false)
+			return eastl::weak_ptr<ComponentType>();
+
+		return eastl::static_pointer_cast<ComponentType>(components[firstComponentIndices[componentTypeId]]);
 	}
 
 	template <typename ComponentType>
@@ -148,20 +207,55 @@ namespace Engine
 	{
 		eastl::vector<eastl::weak_ptr<ComponentType>> componentsToReturn;
 
-		for (size_t i = 0, size = components.size(); i < size; ++i)
+		const uint32_t componentTypeId = ComponentTypeId<ComponentType>::Get();
+		if (componentMask.test(componentTypeId) == false)
+			return componentsToReturn;
+
+		for (size_t i = firstComponentIndices[componentTypeId], size = components.size(); i < size; ++i)
 		{
-			if (dynamic_cast<ComponentType*>(components[i].get()))
-				componentsToReturn.push_back(eastl::dynamic_pointer_cast<ComponentType>(components[i]));
+			if (components[i]->componentTypeId == componentTypeId)
+				componentsToReturn.push_back(eastl::static_pointer_cast<ComponentType>(components[i]));
 		}
 
 		return componentsToReturn;
 	}
 
+	template <typename ComponentType>
+	bool Entity::HasComponent() const
+	{
+		return componentMask.test(ComponentTypeId<ComponentType>::Get());
+	}
+
 	template <class ComponentType, class... Args>
 	eastl::weak_ptr<ComponentType> Entity::AddComponent(Args&&... args)
 	{
-		eastl::shared_ptr<ComponentType> componentToAdd = eastl::shared_ptr<ComponentType>(new ComponentType(eastl::forward<Args>(args)...));
-		components.push_back(eastl::move(componentToAdd));
+		return eastl::static_pointer_cast<ComponentType>(CreateComponent<ComponentType>(eastl::forward<Args>(args)...));
+	}
+
+	template <class ComponentType, class... Args>
+	eastl::vector<eastl::weak_ptr<ComponentType>> Entity::AddComponents(size_t count, Args&&... args)
+	{
+		eastl::vector<eastl::weak_ptr<ComponentType>> componentsToReturn;
+		componentsToReturn.reserve(count);
+
+		for (size_t i = 0; i < count; ++i)
+			componentsToReturn.push_back(eastl::static_pointer_cast<ComponentType>(CreateComponent<ComponentType>(eastl::forward<Args>(args)...)));
+
+		return componentsToReturn;
+	}
+
+	template <class ComponentType, class... Args>
+	eastl::shared_ptr<Component> Entity::CreateComponent(Args&&... args)
+	{
+		eastl::shared_ptr<ComponentPool<ComponentType>> pool = GetComponentPool<ComponentType>();
+
+		uint32_t slotIndex;
+		void* memory = pool->Allocate(slotIndex);
+		ComponentType* component = new (memory) ComponentType(eastl::forward<Args>(args)...);
+		component->componentTypeId = ComponentTypeId<ComponentType>::Get();
+
+		components.push_back(eastl::shared_ptr<ComponentType>(component, ComponentPoolDeleter<ComponentType>{ pool, slotIndex }));
+		UpdateComponentTable();
 
 		eastl::shared_ptr<Component> componentToReturn = components.back();
 		componentToReturn->SetOwner(GetPointer());
@@ -173,65 +267,31 @@ namespace Engine
 
 		componentToReturn->InitializeComponent();
 
-		return eastl::static_pointer_cast<ComponentType>(componentToReturn);
+		if (componentToReturn->canUpdateInParallel)
+			pool->hasParallelComponents = true;
+
+		return componentToReturn;
 	}
 
-	template <class ComponentType, class... Args>
-	eastl::vector<eastl::weak_ptr<ComponentType>> Entity::AddComponents(size_t count, Args&&... args)
+	template <typename ComponentType>
+	eastl::shared_ptr<ComponentPool<ComponentType>> Entity::GetComponentPool()
 	{
-		eastl::vector<eastl::weak_ptr<ComponentType>> componentsToReturn;
-
-		for (size_t i = 0; i < count; ++i)
-		{
-			eastl::shared_ptr<ComponentType> componentToAdd = eastl::shared_ptr<ComponentType>(new ComponentType(eastl::forward<Args>(args)...));
-			components.push_back(eastl::move(componentToAdd));
-
-			eastl::shared_ptr<Component> componentToReturn = components.back();
-			componentToReturn->SetOwner(GetPointer());
-			componentToReturn->SetPointerReference(componentToReturn);
-			OnComponentAdded(componentToReturn);
-
-			for (size_t j = 0, size = components.size(); j < size; ++j)
-				componentToReturn->OnComponentAdded(components[j]);
+		eastl::shared_ptr<ComponentPoolBase>& pool = GetComponentPoolReference(ComponentTypeId<ComponentType>::Get());
+		if (pool == nullptr)
+			pool = eastl::shared_ptr<ComponentPoolBase>(new ComponentPool<ComponentType>());
 
-			componentToReturn->InitializeComponent();
-
-			componentsToReturn.push_back(eastl::static_pointer_cast<ComponentType>(componentToReturn));
-		}
-		return componentsToReturn;
+		return eastl::static_pointer_cast<ComponentPool<ComponentType>>(pool);
 	}
 
 	template <typename ComponentType>
 	void Entity::RemoveComponent(size_t amountToRemove)
 	{
-		if (amountToRemove != 1 && amountToRemove > components.size())
-			amountToRemove = components.size();
-
-		for (size_t i = components.size() - 1; i != -1; --i)
-		{
-			if (dynamic_cast<ComponentType*>(components[i].get()))
-			{
-				eastl::weak_ptr<Component> componentToRemove = components[i];
-				components.erase(components.begin() + i);
-				OnComponentRemoved(componentToRemove);
-			}
-			amountToRemove--;
-			if (amountToRemove == 0)
-				break;
-		}
+		RemoveComponents(ComponentTypeId<ComponentType>::Get(), amountToRemove);
 	}
 
 	template <typename ComponentType>
 	void Entity::RemoveAllComponents()
 	{
-		for (size_t i = components.size() - 1; i != -1; --i)
-		{
-			if (dynamic_cast<ComponentType*>(components[i].get()))
-			{
-				eastl::weak_ptr<Component> componentToRemove = components[i];
-				components.erase(components.begin() + i);
-				OnComponentRemoved(componentToRemove);
-			}
-		}
+		RemoveComponents(ComponentTypeId<ComponentType>::Get(), size_t(-1));
 	}
-} // namespace Engine
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "Engine/Entity/EntityCommandBuffer.hpp"
+#include "Engine/Entity/EntitySystem.hpp"
+
+namespace Engine
+{
+	void EntityCommandBuffer::CreateEntity(eastl::string entityName, std::function<void(Entity&)> onCreated)
+	{
+		Command command;
+		command.type = CommandType::CreateEntity;
+		command.entityName = eastl::move(entityName);
+		command.function = eastl::move(onCreated);
+
+		Record(eastl::move(command));
+	}
+
+	void EntityCommandBuffer::DestroyEntity(uint64_t entityId)
+	{
+		Command command;
+		command.type = CommandType::DestroyEntity;
+		command.entityId = entityId;
+
+		Record(eastl::move(command));
+	}
+
+	void EntityCommandBuffer::RemoveComponents(uint64_t entityId, uint32_t componentTypeId, size_t amountToRemove)
+	{
+		Command command;
+		command.type = CommandType::RemoveComponents;
+		command.entityId = entityId;
+		command.componentTypeId = componentTypeId;
+		command.amount = amountToRemove;
+
+		Record(eastl::move(command));
+	}
+
+	bool EntityCommandBuffer::IsEmpty()
+	{
+		std::lock_guard<std::mutex> lock(commandsMutex);
+		return commands.empty();
+	}
+
+	void EntityCommandBuffer::Record(Command command)
+	{
+		std::lock_guard<std::mutex> lock(commandsMutex);
+		commands.push_back(eastl::move(command));
+	}
+
+	void EntityCommandBuffer::Apply(EntitySystem& entitySystem)
+	{
+		{
+			// Commands recorded while applying end up in the next batch.
+			std::lock_guard<std::mutex> lock(commandsMutex);
+			commandsToApply.swap(commands);
+		}
+
+		for (size_t i = 0, size = commandsToApply.size(); i < size; ++i)
+		{
+			Command& command = commandsToApply[i];
+
+			switch (command.type)
+			{
+			case CommandType::CreateEntity:
+			{
+				eastl::shared_ptr<Entity> entity = entitySystem.CreateEntity(command.entityName).lock();
+				if (command.function)
+					command.function(*entity);
+				break;
+			}
+			case CommandType::AddComponent:
+			{
+				eastl::shared_ptr<Entity> entity = entitySystem.GetEntity(command.entityId).lock();
+				if (entity != nullptr)
+					command.function(*entity);
+				break;
+			}
+			case CommandType::RemoveComponents:
+			{
+				eastl::shared_ptr<Entity> entity = entitySystem.GetEntity(command.entityId).lock();
+				if (entity != nullptr)
+					entity->RemoveComponents(command.componentTypeId, command.amount);
+				break;
+			}
+			case CommandType::DestroyEntity:
+				break;
+			}
+		}
+
+		// Every removal is a constant time swap with the last entity, so a mass despawn costs O(n) in total.
+		for (size_t i = 0, size = commandsToApply.size(); i < size; ++i)
+		{
+			if (commandsToApply[i].type != CommandType::DestroyEntity)
+				continue;
+
+			eastl::shared_ptr<Entity> entity = entitySystem.GetEntity(commandsToApply[i].entityId).lock();
+			if (entity != nullptr)
+				entitySystem.RemoveEntity(entity);
+		}
+
+		// Clearing keeps the capacity, so following batches don't need to allocate.
+		commandsToApply.clear();
+	}
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Engine/api.hpp"
+#include "Engine/Entity/Entity.hpp"
+#include "Engine/Components/ComponentType.hpp"
+
+#include <ThirdParty/EASTL-master/include/EASTL/string.h>
+#include <ThirdParty/EASTL-master/include/EASTL/vector.h>
+
+#include <functional>
+#include <mutex>
+
+namespace Engine
+{
+	class EntitySystem;
+
+	/// <summary>
+	/// This object records entity and component changes so they can be applied later on in a single batch.
+	/// The engine applies the commands of the entity system after the entity system and the collision system have been updated.
+	/// Recording commands is thread safe, which allows jobs to request changes without touching the entity system itself.
+	/// NOTE: Only the EntitySystem is allowed to create this object.
+	/// </summary>
+	class ENGINE_API EntityCommandBuffer
+	{
+	public:
+		~EntityCommandBuffer() = default;
+
+		/// <summary>
+		/// Records the creation of a new entity.
+		/// </summary>
+		/// <param name="entityName">The name of the entity you want to create.</param>
+		/// <param name="onCreated">Optional function that will be called with the entity once it has been created, use this to add components.</param>
+		void CreateEntity(eastl::string entityName = "", std::function<void(Entity&)> onCreated = nullptr);
+
+		/// <summary>
+		/// Records the removal of an entity from the entity system. Ids that are no longer valid by the time the commands are applied are ignored.
+		/// </summary>
+		/// <param name="entityId">The id of the entity you want to remove.</param>
+		void DestroyEntity(uint64_t entityId);
+
+		template <class ComponentType, class... Args>
+		/// <summary>
+		/// Records the addition of a component to an entity. The arguments are copied until the commands are applied.
+		/// </summary>
+		/// <param name="entityId">The id of the entity you want to add the component to.</param>
+		/// <param name="...args">The arguments required to initialize the component.</param>
+		void AddComponent(uint64_t entityId, Args... args);
+
+		template <typename ComponentType>
+		/// <summary>
+		/// Records the removal of X amount of components of the given type.
+		/// </summary>
+		/// <param name="entityId">The id of the entity you want to remove the components from.</param>
+		/// <param name="amountToRemove">Will remove 1 component by default, can be change optionally.</param>
+		void RemoveComponent(uint64_t entityId, size_t amountToRemove = 1);
+
+		template <typename ComponentType>
+		/// <summary>
+		/// Records the removal of all the components of the given type.
+		/// </summary>
+		/// <param name="entityId">The id of the entity you want to remove the components from.</param>
+		void RemoveAllComponents(uint64_t entityId);
+
+		/// <summary>
+		/// Records the removal of X amount of components with the given component type id.
+		/// </summary>
+		/// <param name="entityId">The id of the entity you want to remove the components from.</param>
+		/// <param name="componentTypeId">The id of the component type you want to remove.</param>
+		/// <param name="amountToRemove">The amount of components you want to remove.</param>
+		void RemoveComponents(uint64_t entityId, uint32_t componentTypeId, size_t amountToRemove);
+
+		/// <summary>
+		/// Returns true if there are no recorded commands.
+		/// </summary>
+		bool IsEmpty();
+
+	private:
+		friend class EntitySystem;
+		EntityCommandBuffer() = default;
+
+		enum class CommandType
+		{
+			CreateEntity,
+			DestroyEntity,
+			AddComponent,
+			RemoveComponents
+		};
+
+		struct Command
+		{
+			CommandType type = CommandType::CreateEntity;
+			uint64_t entityId = 0;
+			uint32_t componentTypeId = 0;
+			size_t amount = 0;
+			eastl::string entityName;
+			std::function<void(Entity&)> function;
+		};
+
+		void Record(Command command);
+
+		/// <summary>
+		/// Applies all the recorded commands in the order they were recorded and clears the buffer afterwards.
+		/// Entity removals are applied last, so commands on an entity that is destroyed in the same batch are still valid.
+		/// </summary>
+		void Apply(EntitySystem& entitySystem);
+
+		eastl::vector<Command> commands;
+		eastl::vector<Command> commandsToApply;
+		std::mutex commandsMutex;
+	};
+
+	template <class ComponentType, class ... Args>
+	void EntityCommandBuffer::AddComponent(uint64_t entityId, Args... args)
+	{
+		Command command;
+		command.type = CommandType::AddComponent;
+		command.entityId = entityId;
+		command.function = std::bind([](Entity& entity, const Args&... arguments)
+		{
+			entity.AddComponent<ComponentType>(arguments...);
+		}, std::placeholders::_1, eastl::move(args)...);
+
+		Record(eastl::move(command));
+	}
+
+	template <typename ComponentType>
+	void EntityCommandBuffer::RemoveComponent(uint64_t entityId, size_t amountToRemove)
+	{
+		RemoveComponents(entityId, ComponentTypeId<ComponentType>::Get(), amountToRemove);
+	}
+
+	template <typename ComponentType>
+	void EntityCommandBuffer::RemoveAllComponents(uint64_t entityId)
+	{
+		RemoveComponents(entityId, ComponentTypeId<ComponentType>::Get(), size_t(-1));
+	}
+} // namespace Engine
\ No newline at end of file
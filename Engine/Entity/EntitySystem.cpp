@@ -3,7 +3,9 @@
 
 namespace Engine
 {
-	size_t entityCount = 0;
+	EntitySystem::EntitySystem() : commandBuffer(new EntityCommandBuffer()), transformHierarchy(new TransformHierarchy())
+	{
+	}
 
 	EntitySystem::~EntitySystem()
 	{
@@ -12,8 +14,15 @@ namespace Engine
 
 	void EntitySystem::RemoveAllEntities()
 	{
+		// Keep the slots alive so ids of the removed entities can never resolve to a newly created entity.
+		for (size_t i = 0, size = denseToSlot.size(); i < size; ++i)
+		{
+			++slots[denseToSlot[i]].generation;
+			freeSlots.push_back(denseToSlot[i]);
+		}
+
 		system.clear();
-		entityCount = 0;
+		denseToSlot.clear();
 	}
 
 	eastl::weak_ptr<Entity> EntitySystem::CreateEntity(eastl::string entityName, int teamId)
@@ -26,50 +35,166 @@ namespace Engine
 
 	eastl::weak_ptr<Entity> EntitySystem::GetEntity(uint64_t Id)
 	{
-		for (size_t i = 0; i < entityCount; i++)
-		{
-			if (system[i]->GetID() == Id)
-				return system[i];
-		}
+		const size_t denseIndex = GetDenseIndex(Id);
+		if (denseIndex == size_t(-1))
+			return eastl::weak_ptr<Entity>();
 
-		return eastl::weak_ptr<Entity>();
+		return system[denseIndex];
+	}
+
+	bool EntitySystem::IsValid(uint64_t Id) const
+	{
+		return GetDenseIndex(Id) != size_t(-1);
 	}
 
 	void EntitySystem::Update()
 	{
-		for (size_t i = 0; i < entityCount; ++i)
+		isUpdating = true;
+
+		// Components that only touch their own data are updated in chunks of entities on the job system first.
+		if (HasParallelComponents())
+		{
+			Engine::GetEngine().lock()->GetJobSystem().lock()->ParallelFor(system.size(), EntityUpdateBatchSize, [this](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					if (system[i]->GetIsActive())
+						system[i]->UpdateParallelComponents();
+				}
+			});
+		}
+
+		for (size_t i = 0, size = system.size(); i < size; ++i)
 		{
 			if (system[i]->GetIsActive())
 				system[i]->Update();
 		}
+
+		// The collision system updates next, its contact callbacks are still part of the update, isUpdating is reset by ApplyCommands.
+	}
+
+	bool EntitySystem::HasParallelComponents() const
+	{
+		for (size_t i = 0, size = componentPools.size(); i < size; ++i)
+		{
+			if (componentPools[i] != nullptr && componentPools[i]->hasParallelComponents && componentPools[i]->GetCount() > 0)
+				return true;
+		}
+
+		return false;
 	}
 
 	void EntitySystem::AddEntity(eastl::shared_ptr<Entity> entityToAdd)
 	{
-		if (entityToAdd->GetID() == -1)
-			entityToAdd->SetID(entityCount);
+		if (entityToAdd == nullptr)
+			return;
+
+		// The entity is already part of this entity system.
+		const size_t currentIndex = GetDenseIndex(entityToAdd->GetID());
+		if (currentIndex != size_t(-1) && system[currentIndex] == entityToAdd)
+			return;
 
+		uint32_t slotIndex;
+		if (freeSlots.empty() == false)
+		{
+			slotIndex = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else
+		{
+			slotIndex = uint32_t(slots.size());
+			slots.push_back(EntitySlot());
+		}
+
+		EntitySlot& slot = slots[slotIndex];
+		slot.denseIndex = uint32_t(system.size());
+
+		entityToAdd->SetID(ComposeID(slotIndex, slot.generation));
 		system.push_back(eastl::move(entityToAdd));
-		entityCount++;
+		denseToSlot.push_back(slotIndex);
 	}
 
 	void EntitySystem::RemoveEntity(eastl::shared_ptr<Entity> entityToRemove)
 	{
-		if (system.size() == 0) return;
+		if (entityToRemove == nullptr)
+			return;
+
+		const size_t denseIndex = GetDenseIndex(entityToRemove->GetID());
+		if (denseIndex == size_t(-1) || system[denseIndex] != entityToRemove)
+			return;
 
-		eastl::shared_ptr<Entity>* it = eastl::find(system.begin(), system.end(), entityToRemove);
-		if (it != system.end())
+		// Swapping entities around while they are being updated would skip the swapped in entity, so the removal waits for the command buffer.
+		if (isUpdating)
 		{
-			it->reset();
-			system.erase(it);
+			commandBuffer->DestroyEntity(entityToRemove->GetID());
+			return;
 		}
 
-		system.shrink_to_fit();
-		entityCount--;
+		const uint32_t slotIndex = denseToSlot[denseIndex];
+		const size_t lastIndex = system.size() - 1;
+
+		// Swap the last entity into the freed dense position so the entity array stays packed.
+		if (denseIndex != lastIndex)
+		{
+			system[denseIndex] = eastl::move(system[lastIndex]);
+			denseToSlot[denseIndex] = denseToSlot[lastIndex];
+			slots[denseToSlot[denseIndex]].denseIndex = uint32_t(denseIndex);
+		}
+
+		system.pop_back();
+		denseToSlot.pop_back();
+
+		// Bumping the generation invalidates every id that still refers to this slot.
+		++slots[slotIndex].generation;
+		freeSlots.push_back(slotIndex);
+	}
+
+	eastl::weak_ptr<EntityCommandBuffer> EntitySystem::GetCommandBuffer() const
+	{
+		return commandBuffer;
+	}
+
+	void EntitySystem::ApplyCommands()
+	{
+		isUpdating = false;
+		commandBuffer->Apply(*this);
+	}
+
+	void EntitySystem::UpdateTransforms()
+	{
+		transformHierarchy->Update();
 	}
 
-	eastl::vector<eastl::shared_ptr<Entity>> EntitySystem::GetAllEntities() const
+	const eastl::vector<eastl::shared_ptr<Entity>>& EntitySystem::GetAllEntities() const
 	{
 		return system;
 	}
-} // namespace Engine
\ No newline at end of file
+
+	uint64_t EntitySystem::ComposeID(uint32_t slotIndex, uint32_t generation)
+	{
+		return (uint64_t(generation) << 32) | uint64_t(slotIndex);
+	}
+
+	uint32_t EntitySystem::GetSlotIndex(uint64_t Id)
+	{
+		return uint32_t(Id & 0xFFFFFFFF);
+	}
+
+	uint32_t EntitySystem::GetGeneration(uint64_t Id)
+	{
+		return uint32_t(Id >> 32);
+	}
+
+	size_t EntitySystem::GetDenseIndex(uint64_t Id) const
+	{
+		const uint32_t slotIndex = GetSlotIndex(Id);
+		if (slotIndex >= slots.size())
+			return size_t(-1);
+
+		const EntitySlot& slot = slots[slotIndex];
+		if (slot.generation != GetGeneration(Id) || slot.denseIndex >= system.size())
+			return size_t(-1);
+
+		return slot.denseIndex;
+	}
+} // namespace Engine
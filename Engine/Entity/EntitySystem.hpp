@@ -1,6 +1,9 @@
 #pragma once
 #include "Engine/api.hpp"
 #include "Engine/Entity/Entity.hpp"
+#include "Engine/Entity/EntityView.hpp"
+#include "Engine/Entity/EntityCommandBuffer.hpp"
+#include "Engine/Components/TransformHierarchy.hpp"
 
 #include <ThirdParty/EASTL-master/include/EASTL/shared_ptr.h>
 #include <ThirdParty/EASTL-master/include/EASTL/string.h>
@@ -56,26 +59,59 @@ namespace Engine
 		eastl::weak_ptr<EntityType> CreateEntity(eastl::string entityName = "", Args&&... args);
 
 		/// <summary>
-		/// Allows you to get the entity you want based on the id number.
-		/// NOTE: if you know the team id of the entity, it's often faster to call the method with the team id defined.
+		/// Allows you to get the entity you want based on the id number. This lookup is done in constant time.
+		/// NOTE: An id is a handle made up of a slot index and a generation, ids of removed entities will never resolve to a newer entity.
 		/// </summary>
 		/// <param name="Id">The entity you want to get.</param>
 		/// <returns>Will return the entity with the given id if found. Otherwise will return an empty weak pointer.</returns>
 		eastl::weak_ptr<Entity> GetEntity(uint64_t Id);
 
+		/// <summary>
+		/// This method allows you to check if the given id still refers to a living entity.
+		/// </summary>
+		/// <param name="Id">The id you want to validate.</param>
+		/// <returns>Returns true if the id refers to an entity that is still part of the entity system.</returns>
+		bool IsValid(uint64_t Id) const;
+
 		/// <summary>
 		/// This method will allow you to get all entities availible.
+		/// NOTE: The returned reference is invalidated when entities are added or removed.
 		/// </summary>
-		/// <returns>Returns a vector of all the entities availible.</returns>
-		eastl::vector<eastl::shared_ptr<Entity>> GetAllEntities() const;
+		/// <returns>Returns a reference to the vector of all the entities availible.</returns>
+		const eastl::vector<eastl::shared_ptr<Entity>>& GetAllEntities() const;
 
 		template<typename ComponentType>
 		/// <summary>
 		/// This method allows you to get a vector of weak pointers with the component type you are looking for.
+		/// NOTE: Components are stored per exact type, components deriving from the given type are not included.
 		/// </summary>
 		/// <returns>Returns a vector of weak pointers if any available entities have the components you are looking for. Otherwise returns an empty vector.</returns>
 		eastl::vector<eastl::weak_ptr<ComponentType>> GetAllComponents();
 
+		template<typename ComponentType, typename Function>
+		/// <summary>
+		/// This method allows you to call the given function for every component of the given type.
+		/// The components are visited in the order they are stored in memory, which makes this the fastest way to iterate over a component type.
+		/// NOTE: Components are stored per exact type, components deriving from the given type are not included.
+		/// </summary>
+		/// <param name="function">The function to call, this function should accept a reference to the component type.</param>
+		void ForEachComponent(Function function);
+
+		template<typename ComponentType>
+		/// <summary>
+		/// This method allows you to get a view over all the components of the given type. Iterating the view doesn't allocate.
+		/// NOTE: Components are stored per exact type, components deriving from the given type are not included.
+		/// </summary>
+		/// <returns>Returns a non-owning view over all components of the given type.</returns>
+		ComponentView<ComponentType> GetComponentView();
+
+		template<typename... ComponentTypes>
+		/// <summary>
+		/// This method allows you to get a view over all the entities that have every one of the given component types. Iterating the view doesn't allocate.
+		/// </summary>
+		/// <returns>Returns a non-owning view over the matching entities.</returns>
+		EntityView GetEntityView() const;
+
 		template<typename ComponentType>
 		/// <summary>
 		/// This method allows you to get a vector of weak pointer with entities that have the defined component attached to them.
@@ -91,21 +127,76 @@ namespace Engine
 
 		/// <summary>
 		/// This method allows you to remove a specific entity from the entity system
+		/// NOTE: Removals requested while the entities are being updated are recorded in the command buffer and applied after the update.
 		/// <param name="entityToRemove">The entity you want to remove from the entity system.</param>
 		/// </summary>
 		void RemoveEntity(eastl::shared_ptr<Entity> entityToRemove);
 
+		/// <summary>
+		/// This method allows you to get the command buffer of the entity system.
+		/// Changes recorded in the command buffer are applied in a single batch after the entity system and collision system have been updated.
+		/// </summary>
+		/// <returns>Returns a weak pointer of the command buffer.</returns>
+		eastl::weak_ptr<EntityCommandBuffer> GetCommandBuffer() const;
+
 	private:
+		/// <summary>
+		/// A slot of the entity handle table. Maps the index part of an entity id to the dense entity array.
+		/// </summary>
+		struct EntitySlot
+		{
+			uint32_t generation = 0;
+			uint32_t denseIndex = 0;
+		};
+
+		static uint64_t ComposeID(uint32_t slotIndex, uint32_t generation);
+		static uint32_t GetSlotIndex(uint64_t Id);
+		static uint32_t GetGeneration(uint64_t Id);
+
+		/// <summary>
+		/// Returns the dense index of the entity with the given id, or -1 if the id is no longer valid.
+		/// </summary>
+		size_t GetDenseIndex(uint64_t Id) const;
+
+		eastl::vector<eastl::shared_ptr<ComponentPoolBase>> componentPools;
 		eastl::vector<eastl::shared_ptr<Entity>> system;
+		eastl::vector<EntitySlot> slots;
+		eastl::vector<uint32_t> denseToSlot;
+		eastl::vector<uint32_t> freeSlots;
+		eastl::shared_ptr<EntityCommandBuffer> commandBuffer;
+		eastl::shared_ptr<TransformHierarchy> transformHierarchy;
+		bool isUpdating = false;	/// True from the start of the entity update until the commands are applied, this includes the update of the collision system
 
 		friend class Engine;
+		friend class Entity;
+		friend class TransformComponent;
 
-		EntitySystem() = default;
+		EntitySystem();
 	public:
 		~EntitySystem();
 	private:
 
+		/// <summary>
+		/// The amount of entities updated by a single job.
+		/// </summary>
+		static constexpr size_t EntityUpdateBatchSize = 256;
+
 		void Update();
+
+		/// <summary>
+		/// Returns true if any living component can update in parallel. Without those the parallel update pass is skipped entirely.
+		/// </summary>
+		bool HasParallelComponents() const;
+
+		/// <summary>
+		/// Ends the update started by Update() and applies all the changes recorded in the command buffer.
+		/// </summary>
+		void ApplyCommands();
+
+		/// <summary>
+		/// Recalculates the model matrices of all transforms that have been changed since the last call.
+		/// </summary>
+		void UpdateTransforms();
 	};
 
 	template <typename EntityType>
@@ -132,19 +223,41 @@ namespace Engine
 	template <typename ComponentType>
 	eastl::vector<eastl::weak_ptr<ComponentType>> EntitySystem::GetAllComponents()
 	{
+		eastl::shared_ptr<ComponentPool<ComponentType>> pool = Entity::GetComponentPool<ComponentType>();
+
 		eastl::vector<eastl::weak_ptr<ComponentType>> componentsToReturn = eastl::vector<eastl::weak_ptr<ComponentType>>();
+		componentsToReturn.reserve(pool->GetCount());
 
-		for (eastl::vector<eastl::shared_ptr<Entity>>::iterator it = system.begin(), end = system.end(); it != end; ++it)
+		pool->ForEach([&componentsToReturn](ComponentType& component)
 		{
-			eastl::vector<eastl::weak_ptr<ComponentType>> componentsToAdd = it->get()->GetComponents<ComponentType>();
-
-			componentsToReturn.reserve(componentsToReturn.size() + componentsToAdd.size());
-			componentsToReturn.insert(componentsToReturn.end(), componentsToAdd.begin(), componentsToAdd.end());
-		}
+			componentsToReturn.push_back(eastl::static_pointer_cast<ComponentType>(component.GetPointerRefence().lock()));
+		});
 
 		return componentsToReturn;
 	}
 
+	template <typename ComponentType, typename Function>
+	void EntitySystem::ForEachComponent(Function function)
+	{
+		Entity::GetComponentPool<ComponentType>()->ForEach(function);
+	}
+
+	template <typename ComponentType>
+	ComponentView<ComponentType> EntitySystem::GetComponentView()
+	{
+		return ComponentView<ComponentType>(Entity::GetComponentPool<ComponentType>().get());
+	}
+
+	template <typename... ComponentTypes>
+	EntityView EntitySystem::GetEntityView() const
+	{
+		ComponentMask requiredMask;
+		const int expander[] = { 0, (requiredMask.set(ComponentTypeId<ComponentTypes>::Get()), 0)... };
+		(void)expander;
+
+		return EntityView(system, requiredMask);
+	}
+
 	template <typename ComponentType>
 	eastl::vector<eastl::weak_ptr<Entity>> EntitySystem::GetAllEntitiesWithComponent()
 	{
@@ -152,7 +265,7 @@ namespace Engine
 
 		for (size_t i = 0, size = system.size(); i < size; ++i)
 		{
-			if (system[i].get()->GetComponent<ComponentType>().expired() != false)
+			if (system[i]->HasComponent<ComponentType>())
 				entitiesToReturn.push_back(system[i]);
 		}
 
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Engine/Entity/Entity.hpp"
+#include "Engine/Components/ComponentType.hpp"
+
+#include <ThirdParty/EASTL-master/include/EASTL/shared_ptr.h>
+#include <ThirdParty/EASTL-master/include/EASTL/vector.h>
+
+namespace Engine
+{
+	/// <summary>
+	/// A non-owning view over all entities that have every component of a component mask. Iterating a view doesn't allocate or copy any shared pointers.
+	/// NOTE: Adding or removing entities or components while iterating invalidates the view.
+	/// </summary>
+	class EntityView
+	{
+	public:
+		/// <summary>
+		/// Iterates over the entities that match the mask of the view.
+		/// </summary>
+		class Iterator
+		{
+		public:
+			Iterator(const eastl::shared_ptr<Entity>* current, const eastl::shared_ptr<Entity>* end, const ComponentMask* requiredMask);
+
+			Entity& operator*() const;
+			Entity* operator->() const;
+			Iterator& operator++();
+			bool operator==(const Iterator& other) const;
+			bool operator!=(const Iterator& other) const;
+
+		private:
+			/// <summary>
+			/// Moves to the first entity from the current position that matches the mask.
+			/// </summary>
+			void SkipMismatches();
+
+			const eastl::shared_ptr<Entity>* current;
+			const eastl::shared_ptr<Entity>* end;
+			const ComponentMask* requiredMask;
+		};
+
+		EntityView(const eastl::vector<eastl::shared_ptr<Entity>>& entities, const ComponentMask& requiredMask);
+
+		Iterator begin() const;
+		Iterator end() const;
+
+	private:
+		const eastl::vector<eastl::shared_ptr<Entity>>& entities;
+		ComponentMask requiredMask;
+	};
+
+	inline EntityView::Iterator::Iterator(const eastl::shared_ptr<Entity>* current, const eastl::shared_ptr<Entity>* end, const ComponentMask* requiredMask)
+		: current(current), end(end), requiredMask(requiredMask)
+	{
+		SkipMismatches();
+	}
+
+	inline Entity& EntityView::Iterator::operator*() const
+	{
+		return **current;
+	}
+
+	inline Entity* EntityView::Iterator::operator->() const
+	{
+		return current->get();
+	}
+
+	inline EntityView::Iterator& EntityView::Iterator::operator++()
+	{
+		++current;
+		SkipMismatches();
+		return *this;
+	}
+
+	inline bool EntityView::Iterator::operator==(const Iterator& other) const
+	{
+		return current == other.current;
+	}
+
+	inline bool EntityView::Iterator::operator!=(const Iterator& other) const
+	{
+		return current != other.current;
+	}
+
+	inline void EntityView::Iterator::SkipMismatches()
+	{
+		while (current != end && ((*current)->GetComponentMask() & *requiredMask) != *requiredMask)
+			++current;
+	}
+
+	inline EntityView::EntityView(const eastl::vector<eastl::shared_ptr<Entity>>& entities, const ComponentMask& requiredMask)
+		: entities(entities), requiredMask(requiredMask)
+	{
+	}
+
+	inline EntityView::Iterator EntityView::begin() const
+	{
+		return Iterator(entities.begin(), entities.end(), &requiredMask);
+	}
+
+	inline EntityView::Iterator EntityView::end() const
+	{
+		return Iterator(entities.end(), entities.end(), &requiredMask);
+	}
+} // namespace Engine
\ No newline at end of file
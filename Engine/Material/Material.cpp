@@ -1,16 +1,10 @@
 #include "Engine/Material/Material.hpp"
 #include "Engine/engine.hpp"
 
-#include <ThirdParty/stb/stb_image.h>
-
-
 namespace Engine {
 
-	Material::Material(const aiScene* scene, uint32_t materialIndex, eastl::string modelName)
+	Material::Material(const MaterialDescription& description, eastl::string modelName)
 	{
-		if (scene->mNumMaterials <= materialIndex)
-			return;
-
 		materialData_ = {};
 
 		this->modelName = modelName;
@@ -18,57 +12,26 @@ namespace Engine {
 		materialData_.diffuseTextureLoaded = 0;
 		materialData_.specularTextureLoaded = 0;
 
-		aiMaterial* material = scene->mMaterials[materialIndex];
-
-		diffuseTexture = LoadTexture(scene, material, aiTextureType_DIFFUSE);
+		diffuseTexture = LoadTexture(description.diffuseTexture);
 		defaultDiffuseTexture = diffuseTexture;
 		if (diffuseTexture.expired() == false)
 			materialData_.diffuseTextureLoaded = 1;
-		specularTexture = LoadTexture(scene, material, aiTextureType_SPECULAR);
+		specularTexture = LoadTexture(description.specularTexture);
 		defaultSpecularTexture = specularTexture;
 		if (specularTexture.expired() == false)
 			materialData_.specularTextureLoaded = 1;
 		
-		bumpMapTexture = LoadTexture(scene, material, aiTextureType_NORMALS);
+		bumpMapTexture = LoadTexture(description.bumpMapTexture);
 		defaultBumpMapTexture = bumpMapTexture;
 		if (bumpMapTexture.expired() == false)
 			materialData_.bumpMapLoaded = 1;
 
 		missingTexture = Engine::GetEngine().lock()->GetResourceManager().lock()->CreateTexture("default.png");
-		
-		aiMaterial* mat = scene->mMaterials[materialIndex];
-		aiColor3D color(0.f, 0.f, 0.f);
-		if (mat->Get(AI_MATKEY_COLOR_DIFFUSE, color) != AI_SUCCESS) 
-		{
-			// Couldn't find color, add failure code.
-		}
-		float transparency = 1.f;
-		if (mat->Get(AI_MATKEY_OPACITY, transparency) != AI_SUCCESS) 
-		{
-			// Couldn't find transparancy, add failure code.
-		}
-		materialData_.diffuseColor = glm::vec4(color.r, color.g, color.b, transparency);
-
-		color = aiColor3D(0.f, 0.f, 0.f);
-		if (mat->Get(AI_MATKEY_COLOR_SPECULAR, color) != AI_SUCCESS) 
-		{
-			// Couldn't find color, add failure code.
-		}
-		materialData_.specularColor = glm::vec4(color.r, color.g, color.b, 0.f);
 
-		float shiny = 0.f;
-		if (mat->Get(AI_MATKEY_SHININESS, shiny) != AI_SUCCESS) 
-		{
-
-		}
-		materialData_.specularExponent = shiny;
-
-		float specScale = 1.f;
-		if (mat->Get(AI_MATKEY_SHININESS_STRENGTH, specScale) != AI_SUCCESS) 
-		{
-
-		}
-		materialData_.specularScale = specScale;
+		materialData_.diffuseColor = description.diffuseColor;
+		materialData_.specularColor = description.specularColor;
+		materialData_.specularExponent = description.specularExponent;
+		materialData_.specularScale = description.specularScale;
 
 		defaultMaterialData_ = materialData_;
 
@@ -294,71 +257,16 @@ namespace Engine {
 	{
 	}
 
-	eastl::weak_ptr<Texture> Material::LoadTexture(const aiScene* scene, aiMaterial * material, aiTextureType textureType)
+	eastl::weak_ptr<Texture> Material::LoadTexture(const eastl::string& path)
 	{
-		if (material->GetTextureCount(textureType) > 0) { // Textures located
-			aiString path;
-			material->GetTexture(textureType, 0, &path);
-
-			if (path.data[0] == '*') { // Texture is an embedded texture
-
-				eastl::string name = modelName + eastl::string(path.C_Str());
-
-				eastl::weak_ptr<Texture> ret = Engine::GetEngine().lock()->
-					GetResourceManager().lock()->GetTexture(name);
-
-				if (ret.expired() == false)
-					return ret;
-
-				uint32_t index = atoi(path.C_Str() + 1);
-				if (index < scene->mNumTextures) 
-				{
-					aiTexture* texture = scene->mTextures[index];
-
-					stbi_uc* textureData;
-
-					int width, height, channels;
-
-					if (texture->mHeight == 0) 
-					{ // Compressed texture
-						char* data = (char*)malloc(sizeof(char)*texture->mWidth);
-						memcpy(data, texture->pcData, texture->mWidth);
-						textureData = stbi_load_from_memory((stbi_uc*)data, texture->mWidth, &width, &height, &channels, 4);
-					}
-					else 
-					{
-						textureData = (stbi_uc*)malloc(sizeof(stbi_uc)*texture->mWidth*texture->mHeight * 4);
-						for (size_t i = 0; i < texture->mWidth*texture->mHeight*4; i += 4) 
-						{
-							textureData[i] = texture->pcData->r;
-							textureData[i + 1] = texture->pcData->g;
-							textureData[i + 2] = texture->pcData->b;
-							textureData[i + 3] = texture->pcData->a;
-						}
-
-						width = texture->mWidth;
-						height = texture->mHeight;
-						channels = 4;					
-					}
-
-					return Engine::GetEngine().lock()->
-						GetResourceManager().lock()->CreateTexture(name, textureData, width, height);
-
-				}
-				else 
-				{
-					return eastl::shared_ptr<Texture>();
-				}
-			}
-			else 
-			{
-				return Engine::GetEngine().lock()->GetResourceManager().lock()->CreateTexture(eastl::string(path.C_Str()));
-			}
-		}
-		else 
-		{
+		if (path.empty())
 			return eastl::shared_ptr<Texture>();
-		}
+
+		// Embedded textures are decoded and added along with the model, they can't be loaded by name.
+		if (path[0] == '*')
+			return Engine::GetEngine().lock()->GetResourceManager().lock()->GetTexture(modelName + path);
+
+		return Engine::GetEngine().lock()->GetResourceManager().lock()->CreateTexture(path);
 	}
 
 } // namespace Engine
\ No newline at end of file
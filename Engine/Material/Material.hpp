@@ -16,20 +16,32 @@
 
 namespace Engine {
 
+	/// <summary>
+	/// The properties of a material as stored in a model file or its baked cache.
+	/// </summary>
+	struct MaterialDescription
+	{
+		glm::vec4 diffuseColor = glm::vec4(0.f, 0.f, 0.f, 1.f);	/// The alpha contains the opacity
+		glm::vec4 specularColor = glm::vec4(0.f);
+		float specularScale = 1.f;
+		float specularExponent = 0.f;
+		eastl::string diffuseTexture;		/// The path of the texture, embedded textures start with '*' followed by their index. Empty if there is no texture
+		eastl::string specularTexture;
+		eastl::string bumpMapTexture;
+	};
+
 	class Material
 	{
 	public:
 		Material() = default;
 
 		/// <summary>
-		/// Creates a new material from the material data stored in the scene at the given index. 
-		/// Doesn't load any data if the index is larger than the amount of materials contained in.
+		/// Creates a new material from the given description, read from a model file.
 		/// Use this function in the mesh loading code to create the meshes with the default materials for that mesh.
 		/// </summary>
-		/// <param name="scene">The scene (model) to load the material from.</param>
-		/// <param name="materialIndex">The specific material from the material array to load.</param>
+		/// <param name="description">The material to create.</param>
 		/// <param name="modelName">The name of the model. This is used for naming any embedded textures found in the file.</param>
-		Material(const aiScene* scene, uint32_t materialIndex, eastl::string modelName);
+		Material(const MaterialDescription& description, eastl::string modelName);
 		virtual ~Material();
 
 		/// <summary>
@@ -207,6 +219,9 @@ namespace Engine {
 		bool operator==(const Material& other) const;
 
 	protected:
+		// The resource manager keeps the textures of the materials of loaded models from being evicted.
+		friend class ResourceManager;
+
 		typedef struct MaterialData
 		{
 			int32_t diffuseTextureLoaded;
@@ -234,7 +249,7 @@ namespace Engine {
 
 		eastl::weak_ptr<Texture> missingTexture;
 
-		eastl::weak_ptr<Texture> LoadTexture(const aiScene* scene, aiMaterial* material, aiTextureType textureType);
+		eastl::weak_ptr<Texture> LoadTexture(const eastl::string& path);
 	};
 
 } // namespace Engine
\ No newline at end of file
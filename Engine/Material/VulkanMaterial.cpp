@@ -48,8 +48,8 @@ namespace Engine {
 		return layout;
 	}
 
-	VulkanMaterial::VulkanMaterial(const aiScene* scene, uint32_t materialIndex, eastl::string modelName) :
-		Material(scene, materialIndex, modelName)
+	VulkanMaterial::VulkanMaterial(const MaterialDescription& description, eastl::string modelName) :
+		Material(description, modelName)
 	{
 		materialDataBuffer_ = eastl::unique_ptr<VulkanBuffer>(new VulkanBuffer(device_, allocator_,
 			static_cast<uint32_t>(sizeof(MaterialData_t)), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, true, commandPool_));
@@ -28,7 +28,7 @@ namespace Engine {
 		/// <returns>A VkDescriptorSetLayout object.</returns>
 		static VkDescriptorSetLayout CreateMaterialDescriptorSetLayout(VulkanLogicalDevice* device);
 
-		VulkanMaterial(const aiScene* scene, uint32_t materialIndex, eastl::string modelName);
+		VulkanMaterial(const MaterialDescription& description, eastl::string modelName);
 		~VulkanMaterial();
 
 		/// <summary>
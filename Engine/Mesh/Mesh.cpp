@@ -1,13 +1,170 @@
 #include "Engine/Mesh/Mesh.hpp"
 #include "Engine/engine.hpp"
 
+#include <ThirdParty/EASTL-master/include/EASTL/map.h>
+#include <ThirdParty/EASTL-master/include/EASTL/tuple.h>
+
+#include <cstddef>
+#include <cstring>
+
 namespace Engine
 {
-	Mesh::Mesh(eastl::vector<Vertex> vertices, eastl::vector<unsigned> indices)
+	namespace
+	{
+		struct Edge
+		{
+			uint32_t indices[2];
+
+			Edge(uint32_t index1, uint32_t index2)
+			{
+				indices[0] = index1 > index2 ? index1 : index2;
+				indices[1] = index1 > index2 ? index2 : index1;
+			}
+
+			bool operator<(const Edge& right) const
+			{
+				return eastl::tie(indices[0], indices[1]) < eastl::tie(right.indices[0], right.indices[1]);
+			}
+		};
+
+		struct Face
+		{
+			uint32_t indices[3];
+
+			bool operator==(const Face& other) const
+			{
+				return indices[0] == other.indices[0] && indices[1] == other.indices[1] && indices[2] == other.indices[2];
+			}
+
+			uint32_t FindOpposingIndex(const Edge& edge) const
+			{
+				for (int i = 0; i < 3; ++i)
+				{
+					if (indices[i] != edge.indices[0] && indices[i] != edge.indices[1])
+						return indices[i];
+				}
+				return uint32_t(-1);
+			}
+		};
+
+		struct PositionLess
+		{
+			bool operator()(const glm::vec3& left, const glm::vec3& right) const
+			{
+				return eastl::tie(left.x, left.y, left.z) < eastl::tie(right.x, right.y, right.z);
+			}
+		};
+
+		// The position, normal and texture coordinates are the first 32 bytes of a vertex, which is exactly one stripe of the hash.
+		constexpr size_t HashStripeSize = 32;
+		static_assert(offsetof(Vertex, boneWeights) == HashStripeSize, "The geometry of a vertex has to fill a single hash stripe");
+
+		/// <summary>
+		/// Calculates the 64 bit xxHash of data that is passed in stripes of 32 bytes, followed by a shorter tail.
+		/// The stripes don't have to be contiguous, which allows hashing part of every vertex without copying the vertices.
+		/// </summary>
+		class StripeHasher
+		{
+		public:
+			explicit StripeHasher(uint64_t seed) : seed(seed), length(0)
+			{
+				lanes[0] = seed + Prime1 + Prime2;
+				lanes[1] = seed + Prime2;
+				lanes[2] = seed;
+				lanes[3] = seed - Prime1;
+			}
+
+			void AddStripe(const void* stripe)
+			{
+				const uint8_t* bytes = static_cast<const uint8_t*>(stripe);
+				for (size_t i = 0; i < 4; ++i)
+					lanes[i] = Round(lanes[i], Read64(bytes + i * 8));
+				length += HashStripeSize;
+			}
+
+			uint64_t Finish(const void* tail, size_t tailSize) const
+			{
+				uint64_t hash;
+				if (length > 0)
+				{
+					hash = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) + RotateLeft(lanes[2], 12) + RotateLeft(lanes[3], 18);
+					for (size_t i = 0; i < 4; ++i)
+					{
+						hash ^= Round(0, lanes[i]);
+						hash = hash * Prime1 + Prime4;
+					}
+				}
+				else
+				{
+					hash = seed + Prime5;
+				}
+				hash += length + tailSize;
+
+				const uint8_t* bytes = static_cast<const uint8_t*>(tail);
+				for (; tailSize >= 8; bytes += 8, tailSize -= 8)
+				{
+					hash ^= Round(0, Read64(bytes));
+					hash = RotateLeft(hash, 27) * Prime1 + Prime4;
+				}
+				if (tailSize >= 4)
+				{
+					uint32_t value;
+					memcpy(&value, bytes, sizeof(value));
+					hash ^= value * Prime1;
+					hash = RotateLeft(hash, 23) * Prime2 + Prime3;
+					bytes += 4;
+					tailSize -= 4;
+				}
+				for (; tailSize > 0; ++bytes, --tailSize)
+				{
+					hash ^= *bytes * Prime5;
+					hash = RotateLeft(hash, 11) * Prime1;
+				}
+
+				hash ^= hash >> 33;
+				hash *= Prime2;
+				hash ^= hash >> 29;
+				hash *= Prime3;
+				hash ^= hash >> 32;
+				return hash;
+			}
+
+		private:
+			static constexpr uint64_t Prime1 = 11400714785074694791ULL;
+			static constexpr uint64_t Prime2 = 14029467366897019727ULL;
+			static constexpr uint64_t Prime3 = 1609587929392839161ULL;
+			static constexpr uint64_t Prime4 = 9650029242287828579ULL;
+			static constexpr uint64_t Prime5 = 2870177450012600261ULL;
+
+			static uint64_t RotateLeft(uint64_t value, int bits)
+			{
+				return (value << bits) | (value >> (64 - bits));
+			}
+
+			static uint64_t Round(uint64_t accumulator, uint64_t input)
+			{
+				accumulator += input * Prime2;
+				return RotateLeft(accumulator, 31) * Prime1;
+			}
+
+			static uint64_t Read64(const uint8_t* bytes)
+			{
+				uint64_t value;
+				memcpy(&value, bytes, sizeof(value));
+				return value;
+			}
+
+			uint64_t lanes[4];
+			uint64_t seed;
+			uint64_t length;
+		};
+	}
+
+	Mesh::Mesh(eastl::vector<Vertex>&& vertices, eastl::vector<unsigned>&& indices)
 	{
 		//assign the relevant members
-		this->vertices = vertices;
-		this->indices = indices;
+		this->vertices = eastl::move(vertices);
+		this->indices = eastl::move(indices);
 
 		//set up the mesh - vbo, vao, ebo
 		Mesh::SetUpMesh();
@@ -71,6 +228,90 @@ namespace Engine
 		return true;
 	}
 
+	uint64_t Mesh::CalculateHash(const eastl::vector<Vertex>& vertices, const eastl::vector<unsigned>& indices)
+	{
+		StripeHasher vertexHasher(0);
+		for (size_t i = 0, size = vertices.size(); i < size; ++i)
+			vertexHasher.AddStripe(&vertices[i].position);
+
+		// The indices are hashed as a whole, seeded with the hash of the vertices.
+		StripeHasher indexHasher(vertexHasher.Finish(nullptr, 0));
+		const uint8_t* indexBytes = reinterpret_cast<const uint8_t*>(indices.data());
+		const size_t indexSize = indices.size() * sizeof(unsigned);
+		size_t offset = 0;
+		for (; indexSize - offset >= HashStripeSize; offset += HashStripeSize)
+			indexHasher.AddStripe(indexBytes + offset);
+
+		return indexHasher.Finish(indexBytes + offset, indexSize - offset);
+	}
+
+	bool Mesh::HasGeometry(const eastl::vector<Vertex>& vertices, const eastl::vector<unsigned>& indices) const
+	{
+		if (this->vertices.size() != vertices.size() || this->indices.size() != indices.size())
+			return false;
+
+		if (indices.empty() == false && memcmp(this->indices.data(), indices.data(), indices.size() * sizeof(unsigned)) != 0)
+			return false;
+
+		for (size_t i = 0, size = vertices.size(); i < size; ++i)
+		{
+			if (this->vertices[i].position != vertices[i].position) return false;
+			if (this->vertices[i].normal != vertices[i].normal) return false;
+			if (this->vertices[i].texCoords != vertices[i].texCoords) return false;
+		}
+
+		return true;
+	}
+
+	void Mesh::CalculateShadowIndices(const eastl::vector<Vertex>& vertices, const eastl::vector<unsigned>& indices, eastl::vector<uint32_t>& shadowIndices)
+	{
+		eastl::map<glm::vec3, uint32_t, PositionLess> positionMap;
+		eastl::map<Edge, eastl::vector<Face>> neighbors;
+
+		const size_t faceCount = indices.size() / 3;
+		eastl::vector<Face> uniqueFaces;
+		uniqueFaces.reserve(faceCount);
+
+		// Calculate adjacencies
+		for (size_t i = 0; i < faceCount; ++i)
+		{
+			Face unique;
+
+			for (size_t j = 0; j < 3; ++j)
+			{
+				const uint32_t index = static_cast<uint32_t>(indices[i * 3 + j]);
+				unique.indices[j] = positionMap.insert(eastl::make_pair(vertices[index].position, index)).first->second;
+			}
+
+			uniqueFaces.push_back(unique);
+
+			neighbors[Edge(unique.indices[0], unique.indices[1])].push_back(unique);
+			neighbors[Edge(unique.indices[1], unique.indices[2])].push_back(unique);
+			neighbors[Edge(unique.indices[2], unique.indices[0])].push_back(unique);
+		}
+
+		shadowIndices.resize(faceCount * 6);
+
+		for (size_t i = 0; i < faceCount; ++i)
+		{
+			const Face& face = uniqueFaces[i];
+
+			for (size_t j = 0; j < 3; ++j)
+			{
+				const Edge edge(face.indices[j], face.indices[(j + 1) % 3]);
+				const eastl::vector<Face>& edgeNeighbors = neighbors[edge];
+
+				shadowIndices[i * 6 + j * 2] = face.indices[j];
+
+				// Edges on the border of the mesh use the opposing corner of the face itself.
+				if (edgeNeighbors.size() < 2)
+					shadowIndices[i * 6 + j * 2 + 1] = face.indices[(j + 2) % 3];
+				else
+					shadowIndices[i * 6 + j * 2 + 1] = (edgeNeighbors[0] == face ? edgeNeighbors[1] : edgeNeighbors[0]).FindOpposingIndex(edge);
+			}
+		}
+	}
+
 	bool Mesh::operator!=(Mesh& other)
 	{
 		if (name != other.name) return true;
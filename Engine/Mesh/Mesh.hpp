@@ -8,6 +8,37 @@
 
 namespace Engine
 {
+	/// <summary>
+	/// The influence of a bone on a single vertex.
+	/// </summary>
+	struct VertexWeight
+	{
+		uint32_t vertexId;
+		float weight;
+	};
+
+	/// <summary>
+	/// A bone that deforms a mesh, the bone is found in the skeleton by its name.
+	/// </summary>
+	struct MeshBone
+	{
+		eastl::string name;
+		glm::mat4 offset;							/// Transforms from mesh space to the space of the bone
+		eastl::vector<VertexWeight> weights;
+	};
+
+	/// <summary>
+	/// The source data of a mesh, read from a model file or its baked cache. Contains no graphics API resources, so it can be filled in on any thread.
+	/// </summary>
+	struct MeshData
+	{
+		eastl::vector<Vertex> vertices;
+		eastl::vector<unsigned> indices;
+		eastl::vector<uint32_t> shadowIndices;		/// The triangles with adjacency used for shadow volumes, see Mesh::CalculateShadowIndices
+		eastl::vector<MeshBone> bones;
+		uint32_t materialIndex = 0;
+	};
+
 	/// <summary>
 	/// This object is used to store data regarding a mesh. NOTE: only the resource manager is allowed to create a mesh.
 	/// </summary>
@@ -89,6 +120,31 @@ namespace Engine
 		/// <returns>Returns true if the meshes are not equal.</returns>
 		bool operator!=(Mesh& other);
 
+		/// <summary>
+		/// Builds the triangle list with adjacency used to extrude shadow volumes. Vertices at the same position are treated as a single vertex,
+		/// so seams in the texture coordinates or normals don't break the adjacency.
+		/// Every triangle becomes six indices: each corner followed by the opposing corner of the neighbour across the next edge.
+		/// </summary>
+		/// <param name="vertices">The vertices of the mesh.</param>
+		/// <param name="indices">The triangle list of the mesh.</param>
+		/// <param name="shadowIndices">Replaced with the triangle list with adjacency.</param>
+		static void CalculateShadowIndices(const eastl::vector<Vertex>& vertices, const eastl::vector<unsigned>& indices, eastl::vector<uint32_t>& shadowIndices);
+
+		/// <summary>
+		/// Calculates a 64 bit xxHash of the geometry of a mesh, used to find meshes that have already been loaded.
+		/// Only the position, normal and texture coordinates of the vertices are hashed, the same values HasGeometry compares.
+		/// </summary>
+		/// <param name="vertices">The vertices of the mesh.</param>
+		/// <param name="indices">The indices of the mesh.</param>
+		/// <returns>Returns the hash of the geometry.</returns>
+		static uint64_t CalculateHash(const eastl::vector<Vertex>& vertices, const eastl::vector<unsigned>& indices);
+
+		/// <summary>
+		/// Compares the geometry of this mesh against the given vertices and indices. Bone data isn't compared, it's assigned by the skeleton.
+		/// </summary>
+		/// <returns>Returns true if the positions, normals, texture coordinates and indices are equal.</returns>
+		bool HasGeometry(const eastl::vector<Vertex>& vertices, const eastl::vector<unsigned>& indices) const;
+
 	private:
 
 		friend class ResourceManager;
@@ -100,9 +156,14 @@ namespace Engine
 #endif
 
 		Mesh() = delete;
-		Mesh(eastl::vector<Vertex> vertices, eastl::vector<unsigned> indices);
+		Mesh(eastl::vector<Vertex>&& vertices, eastl::vector<unsigned>&& indices);
 		virtual ~Mesh() noexcept;
 
+		// Kept by the resource manager, which evicts the least recently used meshes when they exceed its memory budget.
+		uint64_t hash = 0;
+		size_t memorySize = 0;
+		uint64_t lastUsedFrame = 0;
+
 		//render data
 		//TODO use this function to set up additional variables that you might need for the mesh
 		virtual void SetUpMesh();
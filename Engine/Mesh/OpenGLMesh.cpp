@@ -5,7 +5,7 @@
 
 namespace Engine
 {
-	OpenGLMesh::OpenGLMesh(eastl::vector<Vertex> vertices, eastl::vector<unsigned> indices) : Mesh(vertices, indices)
+	OpenGLMesh::OpenGLMesh(eastl::vector<Vertex>&& vertices, eastl::vector<unsigned>&& indices) : Mesh(eastl::move(vertices), eastl::move(indices))
 	{
 		OpenGLMesh::SetUpMesh();
 	}
@@ -15,7 +15,7 @@ namespace Engine
 		friend class ResourceManager;
 
 		OpenGLMesh() = delete;
-		OpenGLMesh(eastl::vector<Vertex> vertices, eastl::vector<unsigned> indices);
+		OpenGLMesh(eastl::vector<Vertex>&& vertices, eastl::vector<unsigned>&& indices);
 		OpenGLMesh(OpenGLMesh const &other) = default;
 		//OpenGLMesh(OpenGLMesh &&other) noexcept = default;
 	public:
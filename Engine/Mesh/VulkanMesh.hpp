@@ -3,8 +3,6 @@
 #ifdef USING_VULKAN
 #include "Engine/Mesh/Mesh.hpp"
 #include <ThirdParty/Vulkan/Include/vulkan/vulkan.h>
-#include <ThirdParty/assimp/include/assimp/Importer.hpp>
-#include <ThirdParty/assimp/include/assimp/scene.h>
 
 #include "Engine/Texture/VulkanTexture.hpp"
 #include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
@@ -89,13 +87,18 @@ namespace Engine
 		/// Returns VK_NULL_HANDLE of no descriptor is bound to the given combination.</returns>
 		VkDescriptorSet GetBoneOffsetDescriptorSet(size_t threadID, size_t pipelineID, size_t set);
 
+		/// <summary>
+		/// Returns the offset of every bone by bone data index, used with the bone transforms of a model to skin the mesh on the CPU. See SkinVertices.
+		/// </summary>
+		const eastl::vector<glm::mat4>& GetBoneOffsets() const;
+
 
 	private:
 
 		friend class ResourceManager;
 
 		VulkanMesh() = delete;
-		VulkanMesh(aiMesh* mesh, eastl::shared_ptr<Skeleton> skeleton, eastl::vector<Vertex> vertices, eastl::vector<unsigned> indices);
+		VulkanMesh(MeshData&& meshData, eastl::shared_ptr<Skeleton> skeleton);
 		VulkanMesh(VulkanMesh const &other) = default;
 	public:
 		~VulkanMesh();
@@ -103,44 +106,11 @@ namespace Engine
 
 		//eastl::vector<eastl::shared_ptr<Texture>> textures;
 
-		struct Edge {
-			uint32_t indices[2];
-
-			Edge(uint32_t index1, uint32_t index2) {
-				if (index1 > index2) {
-					indices[0] = index1;
-					indices[1] = index2;
-				}
-				else {
-					indices[0] = index2;
-					indices[1] = index1;
-				}
-			}
-
-			bool operator<(const Edge& right) const {
-				return eastl::tie(indices[0], indices[1]) <
-					eastl::tie(right.indices[0], right.indices[1]);
-			}
-
-		};
-
-		struct Face {
-			uint32_t indices[3];
-
-			bool operator==(const Face& other)const {
-				return (indices[0] == other.indices[0] &&
-					indices[1] == other.indices[1] &&
-					indices[2] == other.indices[2]);
-			}
-
-			uint32_t FindOpposingIndex(Edge edge) {
-				for (int i = 0; i < 3; ++i) {
-					if (indices[i] != edge.indices[0] && indices[i] != edge.indices[1])
-						return indices[i];
-				}
-				return -1;
-			}
-		};
+		/// <summary>
+		/// Stores the ids and weights of the given bones in the vertices, and their offsets in the bone offsets of this mesh.
+		/// A vertex keeps the four bones with the largest weights.
+		/// </summary>
+		void AssignBones(const eastl::vector<MeshBone>& bones);
 
 		eastl::shared_ptr<Skeleton> skeleton;
 
@@ -156,8 +126,7 @@ namespace Engine
 
 		eastl::shared_ptr<VulkanTexture> diffuseMissing;
 
-		const aiScene* scene;
-		aiMesh* mesh;
+		eastl::vector<uint32_t> shadowIndices;
 
 		static VulkanRenderer* renderer;
 		static VulkanLogicalDevice* device;
@@ -167,8 +136,6 @@ namespace Engine
 
 		bool animated;
 
-		uint32_t shadowIndicesCount;
-
 	};
 
 } //namespace Engine
@@ -3,18 +3,32 @@
 #include "Engine/engine.hpp"
 #include <ThirdParty/EASTL-master/include/EASTL/string.h>
 
+#include <atomic>
+
 namespace Engine
 {
+	namespace
+	{
+		std::atomic<uint32_t> nextAnimationPhase(0);
+	}
+
 	Model::Model(const aiScene* scene, eastl::string name)
 	{
 		if (name == "")
 			name = name + std::to_string(Engine::GetEngine().lock()->GetResourceManager().lock()->loadedModels_.size()).c_str();
 		this->name = name;
+		this->loadState = ModelLoadState::LOADED;
 		this->speed = 1.f;
 		this->paused = true;
 		this->time = 0.f;
 		this->looping = true;
 		this->currentAnimation = -1;
+		this->isPoseDirty = true;
+		this->animationUpdateInterval = 1;
+		this->framesUntilAnimationUpdate = 0;
+		this->animationPhase = nextAnimationPhase++;
+		this->skippedDeltaTime = 0.f;
+		this->animationUpdateFrame = UINT64_MAX;
 	}
 
 	eastl::vector<eastl::shared_ptr<Mesh>>& Model::GetModelMeshes()
@@ -22,13 +36,28 @@ namespace Engine
 		return meshes;
 	}
 
+	const eastl::vector<glm::mat4>& Model::GetMeshTransforms() const
+	{
+		return meshTransforms;
+	}
+
 	eastl::string Model::GetName()
 	{
 		return name;
 	}
 
+	ModelLoadState Model::GetLoadState() const
+	{
+		return loadState;
+	}
+
 	void Model::SetSkeleton(eastl::shared_ptr<Skeleton> skeleton)
 	{
+		// Models that are loaded again after an eviction get the same skeleton, their animation state is kept.
+		if (this->skeleton != skeleton) {
+			animationBlender.SetSkeleton(skeleton);
+			isPoseDirty = true;
+		}
 		this->skeleton = skeleton;
 	}
 
@@ -56,20 +85,42 @@ namespace Engine
 				if (resetTime) {
 					this->time = 0.f;
 				}
+
+				animationBlender.Play(0, index, 0.f, this->time);
+				isPoseDirty = true;
 			}
 
 		}
 	}
 
+	void Model::CrossFade(eastl::string animation, float duration)
+	{
+		if (skeleton != nullptr) {
+			size_t index = skeleton->GetAnimationIndex(animation);
+			if (index != -1) {
+				currentAnimation = index;
+				currentAnimationName = animation;
+				this->time = 0.f;
+
+				animationBlender.Play(0, index, duration);
+				isPoseDirty = true;
+			}
+		}
+	}
+
 	void Model::ResetAnimation()
 	{
 		currentAnimation = -1;
 		currentAnimationName = "";
+		animationBlender.Play(0, -1);
+		isPoseDirty = true;
 	}
 
 	void Model::SetAnimationTime(float time)
 	{
 		this->time = time;
+		animationBlender.SetTime(0, time);
+		isPoseDirty = true;
 	}
 
 	void Model::Update(float deltaTime)
@@ -79,6 +130,7 @@ namespace Engine
 
 	void Model::UpdateAnimation(float deltaTime)
 	{
+		// The reported animation time advances every call, also for throttled models.
 		if (!paused&&skeleton != nullptr && currentAnimation != -1) {
 			this->time += deltaTime * speed;
 			if (this->time > skeleton->GetAnimationDuration(currentAnimation)) {
@@ -88,6 +140,46 @@ namespace Engine
 					this->time = skeleton->GetAnimationDuration(currentAnimation);
 			}
 		}
+
+		// Throttled models collect the time of the calls they skip, and advance the rendered pose by all of it at once.
+		skippedDeltaTime += deltaTime;
+		if (framesUntilAnimationUpdate > 0) {
+			--framesUntilAnimationUpdate;
+			return;
+		}
+
+		framesUntilAnimationUpdate = animationUpdateInterval - 1;
+		deltaTime = skippedDeltaTime;
+		skippedDeltaTime = 0.f;
+
+		if (!paused) {
+			animationBlender.Update(deltaTime * speed);
+			isPoseDirty = true;
+		}
+
+		// Evaluate in the frame of the update, so the pose work of throttled models is spread over the frames as well.
+		EvaluatePose();
+	}
+
+	void Model::SetAnimationLod(uint32_t updateInterval, uint32_t maxBoneDepth)
+	{
+		updateInterval = updateInterval > 0 ? updateInterval : 1;
+		if (updateInterval != animationUpdateInterval) {
+			animationUpdateInterval = updateInterval;
+			framesUntilAnimationUpdate = animationPhase % updateInterval;
+		}
+
+		if (maxBoneDepth != animationBlender.GetMaxBoneDepth()) {
+			animationBlender.SetMaxBoneDepth(maxBoneDepth);
+			isPoseDirty = true;
+		}
+	}
+
+	bool Model::ClaimAnimationUpdate()
+	{
+		const uint64_t frame = Engine::GetEngine().lock()->GetResourceManager().lock()->frame_;
+		uint64_t claimedFrame = animationUpdateFrame.load();
+		return claimedFrame != frame && animationUpdateFrame.compare_exchange_strong(claimedFrame, frame);
 	}
 
 	float Model::GetAnimationTime() const
@@ -123,6 +215,7 @@ namespace Engine
 	void Model::SetLooping(bool looping)
 	{
 		this->looping = looping;
+		animationBlender.SetLooping(0, looping);
 	}
 
 	bool Model::IsLooping() const
@@ -150,6 +243,27 @@ namespace Engine
 		return currentAnimation;
 	}
 
+	AnimationBlender& Model::GetAnimationBlender()
+	{
+		// The blender can be changed through the returned reference.
+		isPoseDirty = true;
+		return animationBlender;
+	}
+
+	void Model::EvaluatePose()
+	{
+		if (!isPoseDirty)
+			return;
+
+		animationBlender.Evaluate();
+		isPoseDirty = false;
+	}
+
+	const eastl::vector<glm::mat4>& Model::GetBoneTransforms() const
+	{
+		return animationBlender.GetBoneTransforms();
+	}
+
 	eastl::shared_ptr<Material> Model::GetMeshMaterial(eastl::shared_ptr<Mesh> mesh)
 	{
 		if (meshMaterialMap.count(mesh) > 0)
@@ -211,8 +325,9 @@ namespace Engine
 		return false;
 	}
 
-	void Model::AddMesh(eastl::shared_ptr<Mesh> meshToAdd)
+	void Model::AddMesh(eastl::shared_ptr<Mesh> meshToAdd, const glm::mat4& transform)
 	{
 		meshes.push_back(meshToAdd);
+		meshTransforms.push_back(transform);
 	}
 } // namespace Engine
\ No newline at end of file
@@ -1,14 +1,28 @@
 #pragma once
 #include "Engine/api.hpp"
 #include "Engine/Mesh/Mesh.hpp"
+#include "Engine/Animation/AnimationBlender.hpp"
 #include "Engine/Animation/Skeleton.hpp"
 #include "Engine/Material/Material.hpp"
 
 #include <ThirdParty/EASTL-master/include/EASTL/string.h>
 #include <ThirdParty/EASTL-master/include/EASTL/vector.h>
 
+#include <atomic>
+
 namespace Engine
 {
+	/// <summary>
+	/// The state of the meshes of a model.
+	/// </summary>
+	enum class ModelLoadState
+	{
+		LOADING = 0,	/// The model is being loaded asynchronously, it doesn't contain any meshes yet
+		LOADED,			/// All meshes of the model have been loaded
+		FAILED,			/// The model file could not be read, the model stays empty
+		UNLOADED		/// The meshes have been evicted by the resource manager to stay within its memory budget, they are loaded again the next time the model is requested
+	};
+
 	/// <summary>
 	/// This object is a storage container for meshes.
 	/// </summary>
@@ -21,12 +35,25 @@ namespace Engine
 		/// <returns>Returns a shared pointer vector of the meshes bound to this model.</returns>
 		eastl::vector<eastl::shared_ptr<Mesh>>& GetModelMeshes();
 
+		/// <summary>
+		/// Returns the transform of every mesh relative to the model, in the same order as the meshes.
+		/// A mesh used by several nodes of the model file is in the model once for every node, each with the transform of its node.
+		/// </summary>
+		/// <returns>Returns the transforms of the meshes.</returns>
+		const eastl::vector<glm::mat4>& GetMeshTransforms() const;
+
 		/// <summary>
 		/// This method allows you to get the name of this model.
 		/// </summary>
 		/// <returns>Returns the name of this model as a eastl::string.</returns>
 		eastl::string GetName();
 
+		/// <summary>
+		/// This method allows you to check if the meshes of this model have been loaded.
+		/// </summary>
+		/// <returns>Returns the load state of this model, models created by ResourceManager::CreateModelAsync are loading until the frame after their load finished.</returns>
+		ModelLoadState GetLoadState() const;
+
 		void SetSkeleton(eastl::shared_ptr<Skeleton> skeleton);
 
 		/// <summary>
@@ -50,6 +77,14 @@ namespace Engine
 		/// <param name="resetTime">If the animation should be reset to the starting point.</param>
 		void SetAnimation(eastl::string animation, bool resetTime);
 
+		/// <summary>
+		/// Fades from the current animation to another animation over the given duration, and restarts the animation time.
+		/// The fade is part of the evaluated pose, so it is rendered as well, see EvaluatePose.
+		/// </summary>
+		/// <param name="animation">The name of the animation to fade to.</param>
+		/// <param name="duration">The duration of the fade in seconds.</param>
+		void CrossFade(eastl::string animation, float duration);
+
 		/// <summary>
 		/// Sets the current animation to 0, returning the model to the default pose.
 		/// </summary>
@@ -69,11 +104,28 @@ namespace Engine
 		void Update(float deltaTime);
 
 		/// <summary>
-		/// Updates animation related values, such as the progress of the animation.
+		/// Updates animation related values, such as the progress of the animation, and evaluates the pose. The animation time advances every call.
+		/// With an update interval above 1 the pose is only advanced and evaluated every few calls, by the time of all the calls it skipped.
 		/// </summary>
 		/// <param name="deltaTime">Time since last frame in seconds.</param>
 		void UpdateAnimation(float deltaTime);
 
+		/// <summary>
+		/// Sets the level of detail of the evaluated pose, used to spend less time on models that are far away or unimportant.
+		/// The renderer skins the model with the evaluated pose, so the rendered animation updates at the same rate.
+		/// Models with the same update interval are spread over the frames of the interval, so they don't all update in the same frame.
+		/// </summary>
+		/// <param name="updateInterval">The evaluated pose is updated once every this many calls to UpdateAnimation, 1 updates every call.</param>
+		/// <param name="maxBoneDepth">The depth of the deepest bone that is animated in the evaluated pose, see Skeleton::GetMaxBoneDepth and AnimationBlender::SetMaxBoneDepth.</param>
+		void SetAnimationLod(uint32_t updateInterval, uint32_t maxBoneDepth);
+
+		/// <summary>
+		/// Claims the animation update of this model for the current frame. A model is shared by every model component that uses the same file,
+		/// so only the first caller in a frame should update its animation. Can be called from several threads at once.
+		/// </summary>
+		/// <returns>True if the caller claimed the update and should call SetAnimationLod and UpdateAnimation this frame.</returns>
+		bool ClaimAnimationUpdate();
+
 		/// <summary>
 		/// Returns the current progress of the animation.
 		/// </summary>
@@ -140,6 +192,26 @@ namespace Engine
 		/// <returns>The index of the current animation as a size_t.</returns>
 		size_t GetCurrentAnimationIndex() const;
 
+		/// <summary>
+		/// Returns the blender that evaluates the pose of this model. Its first layer plays the current animation,
+		/// layers can be added on top of it to blend in other animations, for example on the upper body only.
+		/// </summary>
+		/// <returns>The animation blender of this model.</returns>
+		AnimationBlender& GetAnimationBlender();
+
+		/// <summary>
+		/// Evaluates the blended pose of the model on the CPU, see AnimationBlender::Evaluate. The renderer skins the model with this pose
+		/// and evaluates it before drawing, call it yourself when gameplay code needs the bones before the model is rendered, like attachments and hitboxes.
+		/// Without a current animation the default pose of the skeleton is evaluated. Does nothing when the animation hasn't changed since the last call.
+		/// </summary>
+		void EvaluatePose();
+
+		/// <summary>
+		/// Returns the transform of every bone relative to the model by bone data index, as evaluated by the last call to EvaluatePose.
+		/// </summary>
+		/// <returns>The bone transforms, empty if the pose hasn't been evaluated or the model has no skeleton.</returns>
+		const eastl::vector<glm::mat4>& GetBoneTransforms() const;
+
 		/// <summary>
 		/// Returns the material used by this model for the specified mesh.
 		/// If the model doesn't contain a material for the specified mesh a nullptr is returned.
@@ -173,7 +245,9 @@ namespace Engine
 		//Model data
 
 		eastl::string name;
+		ModelLoadState loadState;
 		friend class ResourceManager;
+		friend class ModelComponent;
 		explicit Model(const aiScene* scene, eastl::string name = "");
 	public:
 		~Model() = default;
@@ -181,11 +255,19 @@ namespace Engine
 
 		eastl::shared_ptr<Skeleton> skeleton;
 
-		void AddMesh(eastl::shared_ptr<Mesh> meshToAdd);
+		void AddMesh(eastl::shared_ptr<Mesh> meshToAdd, const glm::mat4& transform = glm::mat4(1));
 		eastl::vector<eastl::shared_ptr<Mesh>> meshes;
+		eastl::vector<glm::mat4> meshTransforms;
 
 		eastl::map<eastl::shared_ptr<Mesh>, eastl::shared_ptr<Material>> meshMaterialMap;
 
+		// The files the model was loaded from, used by the resource manager to load the model again after its meshes have been evicted.
+		eastl::string meshFile;
+		eastl::string skeletonFile;
+		uint64_t lastUsedFrame = 0;
+		// The amount of model components that hold this model, the meshes of a model that is held are never evicted.
+		uint32_t componentCount = 0;
+
 #pragma region AnimationData
 
 		float speed;
@@ -200,6 +282,23 @@ namespace Engine
 
 		eastl::string currentAnimationName;
 
+		// Every model keeps its own blender, so models sharing a skeleton can be evaluated independently.
+		AnimationBlender animationBlender;
+
+		bool isPoseDirty;
+
+		uint32_t animationUpdateInterval;
+
+		uint32_t framesUntilAnimationUpdate;
+
+		// Spreads models with the same update interval over the frames of the interval.
+		uint32_t animationPhase;
+
+		float skippedDeltaTime;
+
+		// The resource manager frame in which the animation update was last claimed.
+		std::atomic<uint64_t> animationUpdateFrame;
+
 #pragma endregion
 	};
 } // namespace Engine
\ No newline at end of file
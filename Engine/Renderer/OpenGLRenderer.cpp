@@ -47,14 +47,16 @@ namespace Engine {
 		if (model == nullptr)
 			return;
 
-		modelParam.lock()->SetValue(modelMatrix);
 		mainTextureColor.lock()->SetValue(mainColor);
 
 		eastl::vector<eastl::shared_ptr<Mesh>>& meshes = model->GetModelMeshes();
+		const eastl::vector<glm::mat4>& meshTransforms = model->GetMeshTransforms();
 		for (size_t i = 0, size = meshes.size(); i < size; ++i)
 		{
 			if (meshes[i] == nullptr) continue;
 
+			modelParam.lock()->SetValue(modelMatrix * meshTransforms[i]);
+
 			if (glIsBuffer(GLuint(meshes[i]->GetVBO())) != GL_TRUE)
 			{
 				_ASSERT("The vertex buffer is not a valid buffer (VBO).");
@@ -5,6 +5,7 @@
 #include "Engine/Renderer/VulkanRenderer.hpp"
 
 #include "Engine/Utility/Logging.hpp"
+#include "Engine/Utility/MappedFile.hpp"
 
 #include <stdio.h>
 
@@ -32,23 +33,18 @@ namespace Engine {
 	{
 		eastl::string path = "Resources/Shaders/Vulkan/Compiled/" + name;
 
-		FILE* file = fopen(path.c_str(), "rb");
-		if (!file) {
+		// The shader module is created straight from the mapped file, the mapping is page aligned as SPIR-V requires.
+		MappedFile file(path);
+		if (!file.IsOpen()) {
 			eastl::string s = "Opening shader file " + path + " failed";
 			debug_error("VulkanComputePipeline", "SetComputeShader", s);
 			return;
 		}
 
-		fseek(file, 0L, SEEK_END);
-		size_t fileSize = static_cast<size_t>(ftell(file));
-		computeShaderData_.resize(fileSize);
-		fseek(file, 0L, SEEK_SET);
-		fread(computeShaderData_.data(), sizeof(char), fileSize, file);
-
 		VkShaderModuleCreateInfo createInfo = {};
 		createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-		createInfo.codeSize = computeShaderData_.size();
-		createInfo.pCode = reinterpret_cast<const uint32_t*>(computeShaderData_.data());
+		createInfo.codeSize = file.GetSize();
+		createInfo.pCode = reinterpret_cast<const uint32_t*>(file.GetData());
 
 		vkCreateShaderModule(device_->GetDevice(), &createInfo, nullptr, &computeShader_);
 	}
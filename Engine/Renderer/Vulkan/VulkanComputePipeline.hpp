@@ -46,8 +46,6 @@ namespace Engine {
 			bool external;
 		};
 
-		eastl::vector<char> computeShaderData_;
-
 		VkShaderModule computeShader_;
 
 		VkPipeline pipeline_;
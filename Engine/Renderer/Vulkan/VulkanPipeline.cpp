@@ -3,6 +3,7 @@
 #ifdef USING_VULKAN
 #include "Engine/Renderer/Vulkan/VulkanLogicalDevice.hpp"
 #include "Engine/Renderer/VulkanRenderer.hpp"
+#include "Engine/Utility/MappedFile.hpp"
 #include <fstream>
 #include <iostream>
 #include <stdio.h>
@@ -19,6 +20,12 @@ namespace Engine {
 		this->device = device;
 		this->renderer = renderer;
 
+		vertexShaderModule = VK_NULL_HANDLE;
+		teslationEvaluationShaderModule = VK_NULL_HANDLE;
+		teslationControlShaderModule = VK_NULL_HANDLE;
+		geometryShaderModule = VK_NULL_HANDLE;
+		fragmentShaderModule = VK_NULL_HANDLE;
+
 		InputAssemblyStateCreateInfo = {};
 		InputAssemblyStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
 		InputAssemblyStateCreateInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
@@ -126,27 +133,22 @@ namespace Engine {
 
 		eastl::string path = "Resources/Shaders/Vulkan/Compiled/" + name;
 
-		FILE* file = fopen(path.c_str(), "rb");
+		// The shader module is created straight from the mapped file, the mapping is page aligned as SPIR-V requires.
+		MappedFile file(path);
 
-		if (!file) {
+		if (!file.IsOpen()) {
 			eastl::string s = "[ERROR] Opening shader file " + path + " failed";
 			std::cout << s.c_str() << std::endl;
 			return false;
 		}
-		fseek(file, 0L, SEEK_END);
-		size_t fileSize = static_cast<size_t>(ftell(file));
-		eastl::vector<char> buffer(fileSize);
-		fseek(file, 0L, SEEK_SET);
-		fread(buffer.data(), sizeof(char), fileSize, file);
 
 		int ret;
 
 		switch (type) {
 		case SHADER_TYPE::VERTEX_SHADER:
-			vertexShader = buffer;
-			ret = CompileShaderModule(buffer, &vertexShaderModule);
+			ret = CompileShaderModule(file, &vertexShaderModule);
 			if (ret != 0) {
-				vertexShader.clear();
+				vertexShaderModule = VK_NULL_HANDLE;
 			}
 			else {
 				VkPipelineShaderStageCreateInfo vertShaderStageInfo = {};
@@ -159,10 +161,9 @@ namespace Engine {
 
 			break;
 		case SHADER_TYPE::TESLATION_EVALUATION_SHADER:
-			teslationEvaluationShader = buffer;
-			ret = CompileShaderModule(buffer, &teslationEvaluationShaderModule);
+			ret = CompileShaderModule(file, &teslationEvaluationShaderModule);
 			if (ret != 0)
-				teslationEvaluationShader.clear();
+				teslationEvaluationShaderModule = VK_NULL_HANDLE;
 			else {
 				VkPipelineShaderStageCreateInfo tesEvalShaderStageInfo = {};
 				tesEvalShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -173,10 +174,9 @@ namespace Engine {
 			}
 			break;
 		case SHADER_TYPE::TESLATION_CONTROL_SHADER:
-			teslationControlShader = buffer;
-			ret = CompileShaderModule(buffer, &teslationControlShaderModule);
+			ret = CompileShaderModule(file, &teslationControlShaderModule);
 			if (ret != 0)
-				teslationControlShader.clear();
+				teslationControlShaderModule = VK_NULL_HANDLE;
 			else {
 				VkPipelineShaderStageCreateInfo tesCtrlShaderStageInfo = {};
 				tesCtrlShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -187,10 +187,9 @@ namespace Engine {
 			}
 			break;
 		case SHADER_TYPE::GEOMETRY_SHADER:
-			geometryShader = buffer;
-			ret = CompileShaderModule(buffer, &geometryShaderModule);
+			ret = CompileShaderModule(file, &geometryShaderModule);
 			if (ret != 0)
-				geometryShader.clear();
+				geometryShaderModule = VK_NULL_HANDLE;
 			else {
 				VkPipelineShaderStageCreateInfo geomShaderStageInfo = {};
 				geomShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -201,10 +200,9 @@ namespace Engine {
 			}
 			break;
 		case SHADER_TYPE::FRAGMENT_SHADER:
-			fragmentShader = buffer;
-			ret = CompileShaderModule(buffer, &fragmentShaderModule);
+			ret = CompileShaderModule(file, &fragmentShaderModule);
 			if (ret != 0)
-				fragmentShader.clear();
+				fragmentShaderModule = VK_NULL_HANDLE;
 			else {
 				VkPipelineShaderStageCreateInfo fragShaderStageInfo = {};
 				fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -216,7 +214,6 @@ namespace Engine {
 			break;
 		}
 
-		fclose(file);
 		if (ret != 0)
 			return false;
 		return true;
@@ -224,9 +221,9 @@ namespace Engine {
 
 	int VulkanPipeline::Compile()
 	{
-		if (vertexShader.size() == 0)
+		if (vertexShaderModule == VK_NULL_HANDLE)
 			return VULKAN_PIPELINE_COMPILE_MISSING_SHADER_VERTEX;
-		if (fragmentShader.size() == 0)
+		if (fragmentShaderModule == VK_NULL_HANDLE)
 			return VULKAN_PIPELINE_COMPILE_MISSING_SHADER_FRAGMENT;
 
 		VkPipelineViewportStateCreateInfo viewportCreateInfo = {};
@@ -591,12 +588,12 @@ namespace Engine {
 
 	}
 
-	int VulkanPipeline::CompileShaderModule(eastl::vector<char> code, VkShaderModule * shaderModule)
+	int VulkanPipeline::CompileShaderModule(const MappedFile& code, VkShaderModule * shaderModule)
 	{
 		VkShaderModuleCreateInfo createInfo = {};
 		createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-		createInfo.codeSize = code.size();
-		createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+		createInfo.codeSize = code.GetSize();
+		createInfo.pCode = reinterpret_cast<const uint32_t*>(code.GetData());
 
 		VkResult res = vkCreateShaderModule(device->GetDevice(), &createInfo, nullptr, shaderModule);
 		if (res != VK_SUCCESS) {
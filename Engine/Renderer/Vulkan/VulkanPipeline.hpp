@@ -10,6 +10,7 @@
 #define VULKAN_PIPELINE_COMPILE_MISSING_SHADER_FRAGMENT 2
 
 namespace Engine {
+	class MappedFile;
 	class VulkanLogicalDevice;
 	class VulkanRenderer;
 
@@ -88,12 +89,6 @@ namespace Engine {
 			bool external;
 		}DescriptorSet_t;
 
-		eastl::vector<char> vertexShader;
-		eastl::vector<char> teslationEvaluationShader;
-		eastl::vector<char> teslationControlShader;
-		eastl::vector<char> geometryShader;
-		eastl::vector<char> fragmentShader;
-
 		VkShaderModule vertexShaderModule;
 		VkShaderModule teslationEvaluationShaderModule;
 		VkShaderModule teslationControlShaderModule;
@@ -133,7 +128,7 @@ namespace Engine {
 
 		eastl::vector<VkPushConstantRange> pushConstantRanges;
 
-		int CompileShaderModule(eastl::vector<char> code, VkShaderModule* shaderModule);
+		int CompileShaderModule(const MappedFile& code, VkShaderModule* shaderModule);
 
 		VkPipelineShaderStageCreateInfo ShaderStageCreateInfo[5] = { {},{},{},{},{} };
 
@@ -35,7 +35,7 @@ namespace Engine {
 		skeletalMeshPipeline_->CreateDescriptorSet();
 
 		skeletalMeshPipeline_->AddDescriptorSetBinding(0, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_GEOMETRY_BIT, nullptr);
-		skeletalMeshPipeline_->AddDescriptorSetBinding(3, 0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr);
+		skeletalMeshPipeline_->AddDescriptorSetBinding(3, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr);
 		skeletalMeshPipeline_->AddDescriptorSetBinding(4, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr);
 
 		skeletalMeshPipeline_->AddPushConstantRange(VK_SHADER_STAGE_VERTEX_BIT, 0, static_cast<uint32_t>(sizeof(PushConstants_t)));
@@ -74,7 +74,7 @@ namespace Engine {
 		shadowPipeline_->CreateDescriptorSet();
 
 		shadowPipeline_->AddDescriptorSetBinding(0, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_GEOMETRY_BIT, nullptr);
-		shadowPipeline_->AddDescriptorSetBinding(3, 0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr);
+		shadowPipeline_->AddDescriptorSetBinding(3, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr);
 		shadowPipeline_->AddDescriptorSetBinding(4, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr);
 
 		shadowPipeline_->AddPushConstantRange(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_GEOMETRY_BIT, 
@@ -129,6 +129,25 @@ namespace Engine {
 				0, static_cast<VkDeviceSize>(sizeof(ubo_)), 0, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1);
 		}
 
+		const uint32_t paletteSize = static_cast<uint32_t>(sizeof(glm::mat4) * MAX_BONE_COUNT);
+
+		paletteBuffer_ = eastl::unique_ptr<VulkanBuffer>(new VulkanBuffer(device, renderer->GetVmaAllocator(),
+			paletteSize * MAX_INSTANCE_COUNT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, false, renderer->GetGraphicsCommandPool()));
+
+		palettes_.reserve(MAX_BONE_COUNT * MAX_INSTANCE_COUNT);
+		lastPaletteSource_ = nullptr;
+
+		paletteDescriptors_.resize(renderer_->GetThreadCount());
+
+		for (size_t i = 0, size = paletteDescriptors_.size(); i < size; ++i) {
+
+			VkDescriptorSetLayout layouts[] = { skeletalMeshPipeline_->GetDescriptorSetLayout(3) };
+			renderer_->GetDescriptorPool(i)->AllocateDescriptorSet(1, layouts, &paletteDescriptors_[i]);
+
+			renderer_->GetDescriptorPool(i)->DescriptorSetBindToBuffer(paletteDescriptors_[i], paletteBuffer_->GetBuffer(),
+				0, static_cast<VkDeviceSize>(paletteSize), 0, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1);
+		}
+
 		Engine::GetEngine().lock()->GetResourceManager().lock()->CreateTexture("default.png");
 		defaultTexture_ = eastl::dynamic_pointer_cast<VulkanTexture, Texture>(
 			Engine::GetEngine().lock()->GetResourceManager().lock()->GetTexture("default.png").lock());
@@ -138,6 +157,7 @@ namespace Engine {
 	VulkanSkeletalMeshRenderer::~VulkanSkeletalMeshRenderer()
 	{
 		uniformBuffer_.reset();
+		paletteBuffer_.reset();
 
 		skeletalMeshPipeline_.reset();
 	}
@@ -151,24 +171,31 @@ namespace Engine {
 		}
 
 		meshes.clear();
+		palettes_.clear();
+		lastPaletteSource_ = nullptr;
 	}
 
 	void VulkanSkeletalMeshRenderer::RenderMesh(const glm::mat4x4& modelMatrix, VulkanMesh* mesh,
-		VulkanMaterial* material, Skeleton* skeleton, size_t animation,
-		float time, float ticksPerSecond, float duration, bool looping, const glm::vec4 & mainColor)
-	{		
+		VulkanMaterial* material, const eastl::vector<glm::mat4>& boneTransforms, const glm::vec4 & mainColor)
+	{
+			// The meshes of a model are rendered one after another, so they can share the palette of the first mesh.
+			if (boneTransforms.data() != lastPaletteSource_ || palettes_.empty()) {
+				if (palettes_.size() >= static_cast<size_t>(MAX_BONE_COUNT * MAX_INSTANCE_COUNT))
+					return;
+
+				const size_t paletteStart = palettes_.size();
+				const size_t boneCount = eastl::min(boneTransforms.size(), static_cast<size_t>(MAX_BONE_COUNT));
+				palettes_.insert(palettes_.end(), boneTransforms.begin(), boneTransforms.begin() + boneCount);
+				palettes_.resize(paletteStart + MAX_BONE_COUNT, glm::mat4());
+				lastPaletteSource_ = boneTransforms.data();
+			}
+
 			MeshData data = {};
-			data.animation = animation;
-			data.skeleton = skeleton;
 			data.transform = modelMatrix;
 			data.material = material;
 			data.color = mainColor;
 			data.mesh = mesh;
-			data.time = time;
-			data.ticksPerSecond = ticksPerSecond;
-			data.duration = duration;
-			data.looping = looping;
-			data.boneData = static_cast<VulkanTexture*>(skeleton->GetAnimationData(animation));
+			data.paletteOffset = static_cast<uint32_t>((palettes_.size() - MAX_BONE_COUNT) * sizeof(glm::mat4));
 
 			meshes.push_back(data);
 	}
@@ -185,6 +212,10 @@ namespace Engine {
 /*
 		vkAllocateCommandBuffers(device->GetDevice(), &allocInfo, &commandBuffer);*/
 
+		// The shadows are recorded after this, so the palettes are uploaded once for both passes.
+		if (!palettes_.empty())
+			paletteBuffer_->UpdateBuffer(palettes_.data(), 0, static_cast<uint32_t>(sizeof(glm::mat4) * palettes_.size()));
+
 		renderer_->StartSecondaryCommandBufferRecording(commandBuffer,
 			VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
 			renderer_->GetGBufferRenderPass(), static_cast<int>(VulkanRenderer::GBufferSubPasses::G_BUFFER_PASS), VK_NULL_HANDLE);
@@ -206,10 +237,6 @@ namespace Engine {
 			PushConstants_t constants = {};
 			constants.model = meshes[i].transform;
 			constants.color = meshes[i].color;
-			constants.duration = meshes[i].duration;
-			constants.looping = meshes[i].looping;
-			constants.ticksPerSecond = meshes[i].ticksPerSecond;
-			constants.time = meshes[i].time;
 			
 
 			vkCmdPushConstants(commandBuffer, skeletalMeshPipeline_->GetPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0,
@@ -239,13 +266,8 @@ namespace Engine {
 					threadID, skeletalMeshPipeline_->GetPipelineId(),
 					4, skeletalMeshPipeline_->GetDescriptorSetLayout(4));
 
-			VkDescriptorSet boneDescriptor = meshes[i].boneData->GetDescriptorSet(threadID, skeletalMeshPipeline_->GetPipelineId(), 3);
-			if (boneDescriptor == VK_NULL_HANDLE)
-				boneDescriptor = meshes[i].boneData->CreateDescriptorSet(threadID, skeletalMeshPipeline_->GetPipelineId(), 
-					3, skeletalMeshPipeline_->GetDescriptorSetLayout(3));
-
-			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, skeletalMeshPipeline_->GetPipelineLayout(), 
-				3, 1, &(boneDescriptor), 0, nullptr);
+			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, skeletalMeshPipeline_->GetPipelineLayout(),
+				3, 1, &paletteDescriptors_[threadID], 1, &meshes[i].paletteOffset);
 
 			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, skeletalMeshPipeline_->GetPipelineLayout(), 4, 1, &boneOffsets, 0, nullptr);
 
@@ -295,10 +317,6 @@ namespace Engine {
 			PushConstants_t constants = {};
 			constants.model = meshes[i].transform;
 			constants.color = meshes[i].color;
-			constants.duration = meshes[i].duration;
-			constants.looping = meshes[i].looping;
-			constants.ticksPerSecond = meshes[i].ticksPerSecond;
-			constants.time = meshes[i].time;
 
 
 			vkCmdPushConstants(commandBuffer, shadowPipeline_->GetPipelineLayout(), 
@@ -318,13 +336,8 @@ namespace Engine {
 					threadID, shadowPipeline_->GetPipelineId(), 
 					4, shadowPipeline_->GetDescriptorSetLayout(4));
 
-			VkDescriptorSet boneDescriptor = meshes[i].boneData->GetDescriptorSet(threadID, shadowPipeline_->GetPipelineId(), 3);
-			if (boneDescriptor == VK_NULL_HANDLE)
-				boneDescriptor = meshes[i].boneData->CreateDescriptorSet(threadID, shadowPipeline_->GetPipelineId(),
-					3, shadowPipeline_->GetDescriptorSetLayout(3));
-
 			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, shadowPipeline_->GetPipelineLayout(),
-				3, 1, &(boneDescriptor), 0, nullptr);
+				3, 1, &paletteDescriptors_[threadID], 1, &meshes[i].paletteOffset);
 
 			vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, shadowPipeline_->GetPipelineLayout(), 4, 1, &boneOffsets, 0, nullptr);
 
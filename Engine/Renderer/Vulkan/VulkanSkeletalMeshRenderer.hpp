@@ -10,7 +10,6 @@
 #include "Engine/Renderer/Vulkan/VulkanBuffer.hpp"
 #include "Engine/Renderer/Vulkan/VulkanDescriptorPool.hpp"
 #include "Engine/Mesh/VulkanMesh.hpp"
-#include "Engine/Animation/Skeleton.hpp"
 #include "Engine/Material/VulkanMaterial.hpp"
 #include <ThirdParty/glm/glm/glm.hpp>
 
@@ -26,10 +25,13 @@ namespace Engine {
 
 		void StartRender(glm::mat4 view, glm::mat4 projection);
 
+		/// <summary>
+		/// Queues a skinned mesh for rendering. The bone transforms are copied into the skinning palette of this frame,
+		/// consecutive meshes of the same model share a single palette. Meshes beyond MAX_INSTANCE_COUNT palettes are not drawn.
+		/// </summary>
+		/// <param name="boneTransforms">The transform of every bone relative to the model by bone data index, see Model::GetBoneTransforms.</param>
 		void RenderMesh(const glm::mat4x4& modelMatrix, VulkanMesh* mesh,
-			VulkanMaterial* material, Skeleton* skeleton,
-			size_t animation,
-			float time, float ticksPerSecond, float duration, bool looping,
+			VulkanMaterial* material, const eastl::vector<glm::mat4>& boneTransforms,
 			const glm::vec4& mainColor = glm::vec4(1.f, 1.f, 1.f, 1.f));
 
 		void FinishRender(size_t threadID, VkCommandPool commandPool, VkCommandBuffer buffer);
@@ -40,6 +42,7 @@ namespace Engine {
 		void Recreate();
 
 		const int MAX_INSTANCE_COUNT = 256;
+		const int MAX_BONE_COUNT = 256;
 
 	protected:
 
@@ -48,6 +51,12 @@ namespace Engine {
 
 		eastl::unique_ptr<VulkanBuffer> uniformBuffer_;
 
+		// The bone transforms of every rendered model, one palette of MAX_BONE_COUNT matrices each, selected with a dynamic offset.
+		eastl::unique_ptr<VulkanBuffer> paletteBuffer_;
+		eastl::vector<glm::mat4> palettes_;
+		eastl::vector<VkDescriptorSet> paletteDescriptors_;
+		const glm::mat4* lastPaletteSource_;
+
 		typedef struct {
 			glm::mat4 view;
 			glm::mat4 proj;
@@ -64,24 +73,14 @@ namespace Engine {
 		typedef struct {
 			glm::mat4 model;
 			glm::vec4 color;
-			float time;
-			float ticksPerSecond;
-			float duration;
-			bool looping;
 		}PushConstants_t;
 
 		struct MeshData {
 			glm::mat4 transform;
 			VulkanMaterial* material;
-			Skeleton* skeleton;
-			VulkanTexture* boneData;
 			VulkanMesh* mesh;
 			glm::vec4 color;
-			size_t animation;
-			float time;
-			float ticksPerSecond;
-			float duration;
-			bool looping;
+			uint32_t paletteOffset;
 		};
 
 		eastl::vector<MeshData> meshes;
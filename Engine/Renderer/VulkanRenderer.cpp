@@ -333,7 +333,8 @@ namespace Engine
 
 	void VulkanRenderer::Render(const glm::mat4x4 & modelMatrix, eastl::shared_ptr<Model> model, const glm::vec4 & mainColor)
 	{
-		eastl::vector<eastl::shared_ptr<Mesh>> meshes = model->GetModelMeshes();
+		eastl::vector<eastl::shared_ptr<Mesh>>& meshes = model->GetModelMeshes();
+		const eastl::vector<glm::mat4>& meshTransforms = model->GetMeshTransforms();
 
 		for (size_t i = 0, size = meshes.size(); i < size; i++) {
 			if (meshes[i] == nullptr)
@@ -347,18 +348,19 @@ namespace Engine
 			bool isAnimated = eastl::dynamic_pointer_cast<VulkanMesh, Mesh>(meshes[i])->IsAnimated();
 			size_t currentAnimationIndex = model->GetCurrentAnimationIndex();
 
+			// Skinned meshes keep the model matrix, the transforms of their nodes are part of the bone transforms.
 			if (!isAnimated ||
 				currentAnimationIndex == -1 ||
 				model->GetSkeleton() == nullptr) {
-				vulkanStaticMeshRenderer->RenderMesh(modelMatrix,
+				vulkanStaticMeshRenderer->RenderMesh(isAnimated ? modelMatrix : modelMatrix * meshTransforms[i],
 					eastl::dynamic_pointer_cast<VulkanMesh, Mesh>(meshes[i]), material, mainColor);
 			}
 			else {
+				// Only the first mesh of the model evaluates the pose, the other meshes find it up to date.
+				model->EvaluatePose();
 				vulkanSkeletalMeshRenderer->RenderMesh(modelMatrix,
 					static_cast<VulkanMesh*>(meshes[i].get()),
-					material.get(), model->GetSkeleton().get(), model->GetCurrentAnimationIndex(), model->GetAnimationTime(),
-					model->GetSkeleton()->GetAnimationTicksPerSecond(model->GetCurrentAnimationIndex()),
-					model->GetAnimationDuration(), model->IsLooping(), mainColor);
+					material.get(), model->GetBoneTransforms(), mainColor);
 			}
 		}
 	}
@@ -0,0 +1,109 @@
+#include "Engine/Resources/MappedIOSystem.hpp"
+#include "Engine/Utility/Utility.hpp"
+
+#include <cstring>
+
+namespace Engine
+{
+	bool MappedIOSystem::Exists(const char* file) const
+	{
+		uint64_t size;
+		int64_t modificationTime;
+		return Utility::GetFileInfo(file, size, modificationTime);
+	}
+
+	char MappedIOSystem::getOsSeparator() const
+	{
+#ifdef _WIN32
+		return '\\';
+#else
+		return '/';
+#endif
+	}
+
+	Assimp::IOStream* MappedIOSystem::Open(const char* file, const char* mode)
+	{
+		if (strchr(mode, 'w') != nullptr || strchr(mode, 'a') != nullptr || strchr(mode, '+') != nullptr)
+			return nullptr;
+
+		MappedFile mappedFile(file);
+		if (mappedFile.IsOpen() == false)
+			return nullptr;
+
+		return new MappedIOStream(eastl::move(mappedFile));
+	}
+
+	void MappedIOSystem::Close(Assimp::IOStream* file)
+	{
+		delete file;
+	}
+
+	MappedIOStream::MappedIOStream(MappedFile&& file) : file(eastl::move(file)), position(0)
+	{
+	}
+
+	size_t MappedIOStream::Read(void* buffer, size_t size, size_t count)
+	{
+		if (size == 0)
+			return 0;
+
+		// Only whole elements are read, like fread.
+		const size_t available = (file.GetSize() - position) / size;
+		if (count > available)
+			count = available;
+
+		if (count > 0)
+		{
+			memcpy(buffer, file.GetData() + position, size * count);
+			position += size * count;
+		}
+		return count;
+	}
+
+	size_t MappedIOStream::Write(const void* buffer, size_t size, size_t count)
+	{
+		return 0;
+	}
+
+	aiReturn MappedIOStream::Seek(size_t offset, aiOrigin origin)
+	{
+		size_t newPosition;
+		switch (origin)
+		{
+		case aiOrigin_SET:
+			newPosition = offset;
+			break;
+		case aiOrigin_CUR:
+			newPosition = position + offset;
+			break;
+		case aiOrigin_END:
+			// The offset is unsigned, it counts back from the end of the file.
+			if (offset > file.GetSize())
+				return aiReturn_FAILURE;
+			newPosition = file.GetSize() - offset;
+			break;
+		default:
+			return aiReturn_FAILURE;
+		}
+
+		if (newPosition > file.GetSize())
+			return aiReturn_FAILURE;
+
+		position = newPosition;
+		return aiReturn_SUCCESS;
+	}
+
+	size_t MappedIOStream::Tell() const
+	{
+		return position;
+	}
+
+	size_t MappedIOStream::FileSize() const
+	{
+		return file.GetSize();
+	}
+
+	void MappedIOStream::Flush()
+	{
+	}
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Engine/api.hpp"
+#include "Engine/Utility/MappedFile.hpp"
+
+#include <ThirdParty/assimp/include/assimp/IOStream.hpp>
+#include <ThirdParty/assimp/include/assimp/IOSystem.hpp>
+
+namespace Engine
+{
+	/// <summary>
+	/// Lets Assimp read model files through a memory mapping instead of buffered file reads. Files the model refers to, like material libraries, are mapped as well.
+	/// Pass a new instance to Assimp::Importer::SetIOHandler, the importer takes ownership of it.
+	/// </summary>
+	class ENGINE_API MappedIOSystem : public Assimp::IOSystem
+	{
+	public:
+		bool Exists(const char* file) const override;
+		char getOsSeparator() const override;
+
+		/// <summary>
+		/// Maps the given file. Only reading is supported, opening a file for writing fails.
+		/// </summary>
+		Assimp::IOStream* Open(const char* file, const char* mode = "rb") override;
+		void Close(Assimp::IOStream* file) override;
+	};
+
+	/// <summary>
+	/// A read-only Assimp stream over a mapped file, created by MappedIOSystem.
+	/// </summary>
+	class ENGINE_API MappedIOStream : public Assimp::IOStream
+	{
+		friend class MappedIOSystem;
+
+		explicit MappedIOStream(MappedFile&& file);
+	public:
+		size_t Read(void* buffer, size_t size, size_t count) override;
+		size_t Write(const void* buffer, size_t size, size_t count) override;
+		aiReturn Seek(size_t offset, aiOrigin origin) override;
+		size_t Tell() const override;
+		size_t FileSize() const override;
+		void Flush() override;
+
+	private:
+		MappedFile file;
+		size_t position;
+	};
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,488 @@
+#include "Engine/Resources/ModelCache.hpp"
+#include "Engine/Utility/MappedFile.hpp"
+#include "Engine/Utility/Utility.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace Engine
+{
+	constexpr uint32_t ModelCache::Version;
+
+	namespace
+	{
+		constexpr uint32_t CacheMagic = 0x4853454D; // "MESH"
+		constexpr size_t CacheAlignment = 16;
+
+		/// <summary>
+		/// The start of every cache file. The vertex size is stored so a change of the vertex layout also invalidates the cache.
+		/// </summary>
+		struct CacheHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t vertexSize;
+			uint32_t flags;
+			uint64_t sourceSize;
+			int64_t sourceModificationTime;
+			uint64_t cacheSize;
+		};
+
+		enum CacheFlags : uint32_t
+		{
+			CACHE_FLAG_HAS_ANIMATIONS = 1 << 0
+		};
+
+		class CacheWriter
+		{
+		public:
+			explicit CacheWriter(eastl::vector<char>& buffer) : buffer(buffer)
+			{
+			}
+
+			void Write(const void* data, size_t size)
+			{
+				if (size == 0)
+					return;
+
+				const char* bytes = static_cast<const char*>(data);
+				buffer.insert(buffer.end(), bytes, bytes + size);
+			}
+
+			template<typename T>
+			void WriteValue(const T& value)
+			{
+				Write(&value, sizeof(T));
+			}
+
+			template<typename T>
+			void WriteArray(const eastl::vector<T>& values)
+			{
+				WriteValue(uint32_t(values.size()));
+				Align();
+				Write(values.data(), values.size() * sizeof(T));
+			}
+
+			void WriteString(const eastl::string& value)
+			{
+				WriteValue(uint32_t(value.size()));
+				Write(value.data(), value.size());
+			}
+
+			void Align()
+			{
+				buffer.resize((buffer.size() + CacheAlignment - 1) & ~(CacheAlignment - 1), 0);
+			}
+
+		private:
+			eastl::vector<char>& buffer;
+		};
+
+		/// <summary>
+		/// Reads the values written by the cache writer. Reading past the end of the data fails the reader instead of reading out of bounds.
+		/// </summary>
+		class CacheReader
+		{
+		public:
+			CacheReader(const char* data, size_t size) : data(data), size(size), offset(0), failed(false)
+			{
+			}
+
+			bool Read(void* destination, size_t byteCount)
+			{
+				if (failed || byteCount > size - offset)
+				{
+					failed = true;
+					return false;
+				}
+				if (byteCount == 0)
+					return true;
+
+				memcpy(destination, data + offset, byteCount);
+				offset += byteCount;
+				return true;
+			}
+
+			template<typename T>
+			T ReadValue()
+			{
+				T value = {};
+				Read(&value, sizeof(T));
+				return value;
+			}
+
+			/// <summary>
+			/// Reads the amount of elements that follow, every element takes up at least the given amount of bytes.
+			/// The reader fails when the remaining data can't hold that many elements, so a damaged count can't cause a huge allocation.
+			/// </summary>
+			uint32_t ReadCount(size_t minimumElementSize)
+			{
+				const uint32_t count = ReadValue<uint32_t>();
+				if (failed || count > (size - offset) / minimumElementSize)
+				{
+					failed = true;
+					return 0;
+				}
+				return count;
+			}
+
+			template<typename T>
+			void ReadArray(eastl::vector<T>& values)
+			{
+				const uint32_t count = ReadValue<uint32_t>();
+				Align();
+				if (failed || count > (size - offset) / sizeof(T))
+				{
+					failed = true;
+					return;
+				}
+
+				values.resize(count);
+				Read(values.data(), count * sizeof(T));
+			}
+
+			void ReadString(eastl::string& value)
+			{
+				const uint32_t length = ReadValue<uint32_t>();
+				if (failed || length > size - offset)
+				{
+					failed = true;
+					return;
+				}
+
+				value.assign(data + offset, data + offset + length);
+				offset += length;
+			}
+
+			void Align()
+			{
+				offset = (offset + CacheAlignment - 1) & ~(CacheAlignment - 1);
+				if (offset > size)
+				{
+					offset = size;
+					failed = true;
+				}
+			}
+
+			bool HasFailed() const
+			{
+				return failed;
+			}
+
+		private:
+			const char* data;
+			size_t size;
+			size_t offset;
+			bool failed;
+		};
+
+		void WriteTrack(CacheWriter& writer, const VectorTrack& track)
+		{
+			writer.WriteArray(track.GetTimes());
+			writer.WriteArray(track.GetValues());
+			writer.WriteValue(track.GetMinimum());
+			writer.WriteValue(track.GetStep());
+		}
+
+		void WriteTrack(CacheWriter& writer, const RotationTrack& track)
+		{
+			writer.WriteArray(track.GetTimes());
+			writer.WriteArray(track.GetValues());
+		}
+
+		/// <summary>
+		/// A track either has a single key without a time, or a time for each of its keys. Other tracks would make sampling read out of bounds.
+		/// </summary>
+		bool IsValidTrack(size_t timeCount, size_t keyCount)
+		{
+			return (timeCount == 0 && keyCount <= 1) || (timeCount == keyCount && keyCount > 1);
+		}
+
+		bool ReadTrack(CacheReader& reader, VectorTrack& track)
+		{
+			eastl::vector<float> times;
+			eastl::vector<QuantizedVector> values;
+			reader.ReadArray(times);
+			reader.ReadArray(values);
+			const glm::vec3 minimum = reader.ReadValue<glm::vec3>();
+			const glm::vec3 step = reader.ReadValue<glm::vec3>();
+
+			const bool isValid = IsValidTrack(times.size(), values.size());
+			track.SetKeys(eastl::move(times), eastl::move(values), minimum, step);
+			return isValid;
+		}
+
+		bool ReadTrack(CacheReader& reader, RotationTrack& track)
+		{
+			eastl::vector<float> times;
+			eastl::vector<QuantizedQuaternion> values;
+			reader.ReadArray(times);
+			reader.ReadArray(values);
+
+			const bool isValid = IsValidTrack(times.size(), values.size());
+			track.SetKeys(eastl::move(times), eastl::move(values));
+			return isValid;
+		}
+	}
+
+	eastl::string ModelCache::GetCachePath(const eastl::string& sourcePath)
+	{
+		return sourcePath + ".meshcache";
+	}
+
+	bool ModelCache::Load(const eastl::string& sourcePath, ModelData& modelData)
+	{
+		uint64_t sourceSize;
+		int64_t sourceModificationTime;
+		if (Utility::GetFileInfo(sourcePath, sourceSize, sourceModificationTime) == false)
+			return false;
+
+		// The cache is read straight from the mapping, only the pages that are used are read from disk.
+		const MappedFile file(GetCachePath(sourcePath));
+		const size_t fileSize = file.GetSize();
+		if (fileSize < sizeof(CacheHeader))
+			return false;
+
+		// Check the header before reading the rest, an outdated cache is rejected without touching its contents.
+		CacheReader reader(reinterpret_cast<const char*>(file.GetData()), fileSize);
+		const CacheHeader header = reader.ReadValue<CacheHeader>();
+		if (header.magic != CacheMagic || header.version != Version || header.vertexSize != sizeof(Vertex) ||
+			header.sourceSize != sourceSize || header.sourceModificationTime != sourceModificationTime || header.cacheSize != fileSize)
+			return false;
+
+		modelData.hasAnimations = (header.flags & CACHE_FLAG_HAS_ANIMATIONS) != 0;
+
+		modelData.meshes.resize(reader.ReadCount(sizeof(uint32_t)));
+		for (size_t i = 0, size = modelData.meshes.size(); i < size && reader.HasFailed() == false; ++i)
+		{
+			MeshData& mesh = modelData.meshes[i];
+			mesh.materialIndex = reader.ReadValue<uint32_t>();
+			reader.ReadArray(mesh.vertices);
+			reader.ReadArray(mesh.indices);
+			reader.ReadArray(mesh.shadowIndices);
+
+			mesh.bones.resize(reader.ReadCount(sizeof(uint32_t)));
+			for (size_t j = 0, boneCount = mesh.bones.size(); j < boneCount && reader.HasFailed() == false; ++j)
+			{
+				reader.ReadString(mesh.bones[j].name);
+				mesh.bones[j].offset = reader.ReadValue<glm::mat4>();
+				reader.ReadArray(mesh.bones[j].weights);
+			}
+		}
+
+		reader.ReadArray(modelData.meshInstances);
+
+		modelData.materials.resize(reader.ReadCount(sizeof(uint32_t)));
+		for (size_t i = 0, size = modelData.materials.size(); i < size && reader.HasFailed() == false; ++i)
+		{
+			MaterialDescription& material = modelData.materials[i];
+			material.diffuseColor = reader.ReadValue<glm::vec4>();
+			material.specularColor = reader.ReadValue<glm::vec4>();
+			material.specularScale = reader.ReadValue<float>();
+			material.specularExponent = reader.ReadValue<float>();
+			reader.ReadString(material.diffuseTexture);
+			reader.ReadString(material.specularTexture);
+			reader.ReadString(material.bumpMapTexture);
+		}
+
+		modelData.textures.resize(reader.ReadCount(sizeof(uint32_t)));
+		for (size_t i = 0, size = modelData.textures.size(); i < size && reader.HasFailed() == false; ++i)
+		{
+			modelData.textures[i].width = reader.ReadValue<uint32_t>();
+			modelData.textures[i].height = reader.ReadValue<uint32_t>();
+			reader.ReadArray(modelData.textures[i].data);
+		}
+
+		bool hasValidTracks = true;
+		SkeletonData& skeleton = modelData.skeleton;
+		skeleton.bones.resize(reader.ReadCount(sizeof(uint32_t)));
+		for (size_t i = 0, size = skeleton.bones.size(); i < size && reader.HasFailed() == false; ++i)
+		{
+			SkeletonData::Bone& bone = skeleton.bones[i];
+			reader.ReadString(bone.name);
+			bone.parentIndex = reader.ReadValue<int32_t>();
+			bone.transform = reader.ReadValue<glm::mat4>();
+			bone.defaultPose = reader.ReadValue<BoneTransform>();
+		}
+
+		skeleton.animations.resize(reader.ReadCount(sizeof(uint32_t)));
+		for (size_t i = 0, size = skeleton.animations.size(); i < size && reader.HasFailed() == false; ++i)
+		{
+			SkeletonData::Animation& animation = skeleton.animations[i];
+			reader.ReadString(animation.name);
+			animation.duration = reader.ReadValue<float>();
+			animation.ticksPerSecond = reader.ReadValue<float>();
+
+			animation.nodes.resize(reader.ReadCount(sizeof(uint32_t)));
+			for (size_t j = 0, nodeCount = animation.nodes.size(); j < nodeCount && reader.HasFailed() == false; ++j)
+			{
+				SkeletonData::AnimationNode& node = animation.nodes[j];
+				node.bone = reader.ReadValue<uint32_t>();
+				node.preState = reader.ReadValue<uint32_t>();
+				node.postState = reader.ReadValue<uint32_t>();
+				hasValidTracks &= ReadTrack(reader, node.positions);
+				hasValidTracks &= ReadTrack(reader, node.rotations);
+				hasValidTracks &= ReadTrack(reader, node.scales);
+			}
+		}
+
+		if (reader.HasFailed() || hasValidTracks == false)
+			return false;
+
+		// Damaged indices would make the meshes read out of bounds.
+		for (size_t i = 0, size = modelData.meshInstances.size(); i < size; ++i)
+		{
+			if (modelData.meshInstances[i].mesh >= modelData.meshes.size())
+				return false;
+		}
+		for (size_t i = 0, size = modelData.meshes.size(); i < size; ++i)
+		{
+			const MeshData& mesh = modelData.meshes[i];
+			for (size_t j = 0, indexCount = mesh.indices.size(); j < indexCount; ++j)
+			{
+				if (mesh.indices[j] >= mesh.vertices.size())
+					return false;
+			}
+			for (size_t j = 0, indexCount = mesh.shadowIndices.size(); j < indexCount; ++j)
+			{
+				if (mesh.shadowIndices[j] >= mesh.vertices.size())
+					return false;
+			}
+			for (size_t j = 0, boneCount = mesh.bones.size(); j < boneCount; ++j)
+			{
+				for (size_t k = 0, weightCount = mesh.bones[j].weights.size(); k < weightCount; ++k)
+				{
+					if (mesh.bones[j].weights[k].vertexId >= mesh.vertices.size())
+						return false;
+				}
+			}
+		}
+		for (size_t i = 0, size = skeleton.bones.size(); i < size; ++i)
+		{
+			// Every parent comes before its children.
+			if (skeleton.bones[i].parentIndex < -1 || skeleton.bones[i].parentIndex >= int32_t(i))
+				return false;
+		}
+		for (size_t i = 0, size = skeleton.animations.size(); i < size; ++i)
+		{
+			for (size_t j = 0, nodeCount = skeleton.animations[i].nodes.size(); j < nodeCount; ++j)
+			{
+				if (skeleton.animations[i].nodes[j].bone >= skeleton.bones.size())
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool ModelCache::Save(const eastl::string& sourcePath, const ModelData& modelData)
+	{
+		CacheHeader header = {};
+		header.magic = CacheMagic;
+		header.version = Version;
+		header.vertexSize = sizeof(Vertex);
+		header.flags = modelData.hasAnimations ? uint32_t(CACHE_FLAG_HAS_ANIMATIONS) : 0u;
+		if (Utility::GetFileInfo(sourcePath, header.sourceSize, header.sourceModificationTime) == false)
+			return false;
+
+		eastl::vector<char> buffer;
+		CacheWriter writer(buffer);
+		writer.WriteValue(header);
+
+		writer.WriteValue(uint32_t(modelData.meshes.size()));
+		for (size_t i = 0, size = modelData.meshes.size(); i < size; ++i)
+		{
+			const MeshData& mesh = modelData.meshes[i];
+			writer.WriteValue(mesh.materialIndex);
+			writer.WriteArray(mesh.vertices);
+			writer.WriteArray(mesh.indices);
+			writer.WriteArray(mesh.shadowIndices);
+
+			writer.WriteValue(uint32_t(mesh.bones.size()));
+			for (size_t j = 0, boneCount = mesh.bones.size(); j < boneCount; ++j)
+			{
+				writer.WriteString(mesh.bones[j].name);
+				writer.WriteValue(mesh.bones[j].offset);
+				writer.WriteArray(mesh.bones[j].weights);
+			}
+		}
+
+		writer.WriteArray(modelData.meshInstances);
+
+		writer.WriteValue(uint32_t(modelData.materials.size()));
+		for (size_t i = 0, size = modelData.materials.size(); i < size; ++i)
+		{
+			const MaterialDescription& material = modelData.materials[i];
+			writer.WriteValue(material.diffuseColor);
+			writer.WriteValue(material.specularColor);
+			writer.WriteValue(material.specularScale);
+			writer.WriteValue(material.specularExponent);
+			writer.WriteString(material.diffuseTexture);
+			writer.WriteString(material.specularTexture);
+			writer.WriteString(material.bumpMapTexture);
+		}
+
+		writer.WriteValue(uint32_t(modelData.textures.size()));
+		for (size_t i = 0, size = modelData.textures.size(); i < size; ++i)
+		{
+			writer.WriteValue(modelData.textures[i].width);
+			writer.WriteValue(modelData.textures[i].height);
+			writer.WriteArray(modelData.textures[i].data);
+		}
+
+		const SkeletonData& skeleton = modelData.skeleton;
+		writer.WriteValue(uint32_t(skeleton.bones.size()));
+		for (size_t i = 0, size = skeleton.bones.size(); i < size; ++i)
+		{
+			const SkeletonData::Bone& bone = skeleton.bones[i];
+			writer.WriteString(bone.name);
+			writer.WriteValue(bone.parentIndex);
+			writer.WriteValue(bone.transform);
+			writer.WriteValue(bone.defaultPose);
+		}
+
+		writer.WriteValue(uint32_t(skeleton.animations.size()));
+		for (size_t i = 0, size = skeleton.animations.size(); i < size; ++i)
+		{
+			const SkeletonData::Animation& animation = skeleton.animations[i];
+			writer.WriteString(animation.name);
+			writer.WriteValue(animation.duration);
+			writer.WriteValue(animation.ticksPerSecond);
+
+			writer.WriteValue(uint32_t(animation.nodes.size()));
+			for (size_t j = 0, nodeCount = animation.nodes.size(); j < nodeCount; ++j)
+			{
+				const SkeletonData::AnimationNode& node = animation.nodes[j];
+				writer.WriteValue(node.bone);
+				writer.WriteValue(node.preState);
+				writer.WriteValue(node.postState);
+				WriteTrack(writer, node.positions);
+				WriteTrack(writer, node.rotations);
+				WriteTrack(writer, node.scales);
+			}
+		}
+
+		// The size of the complete file is stored in the header, so a partially written cache is never used.
+		const uint64_t cacheSize = buffer.size();
+		memcpy(buffer.data() + offsetof(CacheHeader, cacheSize), &cacheSize, sizeof(cacheSize));
+
+		// The cache is written next to the old one and moved over it afterwards, so a reader never sees a half written cache, not even while it is being saved.
+		const eastl::string cachePath = GetCachePath(sourcePath);
+		const eastl::string temporaryPath = cachePath + ".tmp";
+		std::ofstream file(temporaryPath.c_str(), std::ios::binary | std::ios::trunc);
+		if (file.is_open() == false)
+			return false;
+
+		file.write(buffer.data(), buffer.size());
+		file.close();
+		if (file.fail() || Utility::RenameFile(temporaryPath, cachePath) == false)
+		{
+			std::remove(temporaryPath.c_str());
+			return false;
+		}
+
+		return true;
+	}
+} // namespace Engine
\ No newline at end of file
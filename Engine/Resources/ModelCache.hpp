@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Engine/api.hpp"
+#include "Engine/Animation/SkeletonData.hpp"
+#include "Engine/Mesh/Mesh.hpp"
+#include "Engine/Material/Material.hpp"
+
+#include <ThirdParty/EASTL-master/include/EASTL/string.h>
+#include <ThirdParty/EASTL-master/include/EASTL/vector.h>
+
+namespace Engine
+{
+	/// <summary>
+	/// A texture stored inside of a model file, in the same layout Assimp uses.
+	/// </summary>
+	struct EmbeddedTexture
+	{
+		uint32_t width;						/// The amount of bytes of compressed data when the height is 0
+		uint32_t height;					/// 0 for compressed textures, otherwise the texture holds width * height BGRA texels
+		eastl::vector<uint8_t> data;
+	};
+
+	/// <summary>
+	/// A mesh placed in a model by one of the nodes of the model file. A mesh used by several nodes has an instance for each of them.
+	/// </summary>
+	struct MeshInstance
+	{
+		glm::mat4 transform;				/// The transform of the node relative to the root of the model
+		uint32_t mesh;						/// The index of the mesh in the model data
+	};
+
+	/// <summary>
+	/// Everything the engine needs from a model file, without any Assimp types. Read from the model file itself or from its baked cache.
+	/// </summary>
+	struct ModelData
+	{
+		eastl::vector<MeshData> meshes;
+		eastl::vector<MaterialDescription> materials;
+		eastl::vector<EmbeddedTexture> textures;	/// Embedded texture N is referred to as "*N" by the materials
+		eastl::vector<MeshInstance> meshInstances;	/// The meshes in the order they are added to the model
+		bool hasAnimations = false;
+		SkeletonData skeleton;						/// The bones and animations of the file, only read for animated models
+	};
+
+	/// <summary>
+	/// Stores the model data read from a model file in a binary file next to it, so later loads of the model don't have to import it again.
+	/// The cache contains the size and modification time of the file it was baked from, and is ignored once the file changes.
+	/// Every array in the file is aligned to 16 bytes, so the file can be used straight from memory.
+	/// </summary>
+	class ENGINE_API ModelCache
+	{
+	public:
+		/// <summary>
+		/// Changes whenever the layout of the cache or the way models are processed changes, caches with another version are baked again.
+		/// </summary>
+		static constexpr uint32_t Version = 4;
+
+		/// <summary>
+		/// Returns the path of the cache of the given model file.
+		/// </summary>
+		static eastl::string GetCachePath(const eastl::string& sourcePath);
+
+		/// <summary>
+		/// Reads the cache of the given model file.
+		/// </summary>
+		/// <param name="sourcePath">The path of the model file.</param>
+		/// <param name="modelData">Filled with the cached model, undefined when the cache can't be used.</param>
+		/// <returns>Returns false if there is no cache, or if it is out of date or damaged.</returns>
+		static bool Load(const eastl::string& sourcePath, ModelData& modelData);
+
+		/// <summary>
+		/// Writes the cache of the given model file.
+		/// </summary>
+		/// <param name="sourcePath">The path of the model file the data has been read from.</param>
+		/// <param name="modelData">The model data to store.</param>
+		/// <returns>Returns false if the cache couldn't be written.</returns>
+		static bool Save(const eastl::string& sourcePath, const ModelData& modelData);
+	};
+} // namespace Engine
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "Engine/Resources/ResourceManager.hpp"
+#include "Engine/Resources/MappedIOSystem.hpp"
 #include "Engine/Utility/Defines.hpp"
 #include "Engine/Utility/Logging.hpp"
+#include "Engine/Utility/Utility.hpp"
+#include "Engine/engine.hpp"
 
 #ifdef USING_OPENGL
 #include "Engine/Texture/OpenGLTexture.hpp"
@@ -13,58 +16,601 @@
 #endif
 
 #include <ThirdParty/EASTL-master/include/EASTL/algorithm.h>
+#include <ThirdParty/EASTL-master/include/EASTL/hash_set.h>
+#include <ThirdParty/EASTL-master/include/EASTL/sort.h>
 #include <iostream>
 #include <ThirdParty/assimp/include/assimp/postprocess.h>
 
 namespace Engine
 {
-	eastl::weak_ptr<Model> ResourceManager::GetModel(eastl::string modelName)
+	eastl::weak_ptr<Model> ResourceManager::GetModel(const eastl::string& modelName)
 	{
-		// if already loaded
+		// If not (yet) loaded
+		const auto it = modelsByName_.find(modelName);
+		if (it == modelsByName_.end())
+			return eastl::shared_ptr<Model>();
+
+		UseModel(it->second);
+		return it->second;
+	}
+
+	void ResourceManager::UseModel(const eastl::shared_ptr<Model>& model)
+	{
+		model->lastUsedFrame = frame_;
+
+		// Models whose meshes have been evicted are loaded again the first time they are needed, the load is started by the next Update.
+		// Loading on the job system keeps a model that is needed while rendering from stalling the frame.
+		if (model->loadState == ModelLoadState::UNLOADED)
+		{
+			model->loadState = ModelLoadState::LOADING;
+			modelsToReload_.push_back(model);
+		}
+	}
+
+	eastl::weak_ptr<Model> ResourceManager::CreateModel(eastl::string modelName, eastl::string meshToLoad, eastl::string skeletonToLoad)
+	{
+		eastl::shared_ptr<Model> model = eastl::shared_ptr<Model>(new Model(nullptr, modelName));
+		model->meshFile = meshToLoad;
+		model->skeletonFile = skeletonToLoad;
+		model->lastUsedFrame = frame_;
+
+		if (LoadModel(model) == false)
+			return eastl::shared_ptr<Model>();
+
+		AddModel(model);
+		return model;
+	}
+
+	eastl::weak_ptr<Model> ResourceManager::CreateModelAsync(eastl::string modelName, eastl::string meshToLoad, eastl::string skeletonToLoad)
+	{
+		// The model is available right away, so it can be looked up and assigned while it is still loading.
+		eastl::shared_ptr<Model> model = eastl::shared_ptr<Model>(new Model(nullptr, modelName));
+		AddModel(model);
+		model->meshFile = meshToLoad;
+		model->skeletonFile = skeletonToLoad;
+		model->lastUsedFrame = frame_;
+
+		LoadModelAsync(model);
+		return model;
+	}
+
+	void ResourceManager::AddModel(const eastl::shared_ptr<Model>& model)
+	{
+		loadedModels_.push_back(model);
+		modelsByName_.insert(eastl::make_pair(model->GetName(), model));
+	}
+
+	bool ResourceManager::LoadModel(const eastl::shared_ptr<Model>& model)
+	{
+		ModelLoad load;
+		PrepareModelLoad(load, model->GetName(), model->meshFile, model->skeletonFile);
+		ReadModel(load);
+
+		if (load.isRead == false)
+		{
+			debug_warning("ResourceManager", "LoadModel", load.errorString);
+			return false;
+		}
+
+		load.model = model;
+		FinalizeModel(load);
+		return true;
+	}
+
+	void ResourceManager::LoadModelAsync(const eastl::shared_ptr<Model>& model)
+	{
+		eastl::shared_ptr<ModelLoad> load = eastl::shared_ptr<ModelLoad>(new ModelLoad());
+		PrepareModelLoad(*load, model->GetName(), model->meshFile, model->skeletonFile);
+		load->model = model;
+		load->model->loadState = ModelLoadState::LOADING;
+
+		// The job only touches the load itself, the resource manager is left alone until the load is finalized on the main thread.
+		// It runs in the background, so a ParallelFor on the main thread never ends up reading a whole model file.
+		load->job = Engine::GetEngine().lock()->GetJobSystem().lock()->RunInBackground([load]()
+		{
+			ReadModel(*load);
+		});
+		pendingModels_.push_back(load);
+	}
+
+	ResourceManager::ModelLoad::~ModelLoad()
+	{
+		// Textures that haven't been handed over to the GPU still own their pixels.
+		for (size_t i = 0, size = textures.size(); i < size; ++i)
+		{
+			if (textures[i].data != nullptr)
+				stbi_image_free(textures[i].data);
+		}
+	}
+
+	void ResourceManager::Update()
+	{
+		++frame_;
+
+		for (size_t i = 0, size = modelsToReload_.size(); i < size; ++i)
+			LoadModelAsync(modelsToReload_[i]);
+		modelsToReload_.clear();
+
+		const eastl::shared_ptr<JobSystem> jobSystem = Engine::GetEngine().lock()->GetJobSystem().lock();
+
+		size_t pendingCount = 0;
+		for (size_t i = 0, size = pendingModels_.size(); i < size; ++i)
+		{
+			eastl::shared_ptr<ModelLoad>& load = pendingModels_[i];
+
+			// Without workers jobs only run when they are waited for.
+			if (jobSystem->GetWorkerCount() == 0)
+				jobSystem->Wait(load->job);
+
+			if (load->job->GetIsFinished() == false)
+			{
+				pendingModels_[pendingCount++] = eastl::move(load);
+				continue;
+			}
+
+			if (load->isRead == false)
+			{
+				debug_warning("ResourceManager", "CreateModelAsync", load->errorString);
+				load->model->loadState = ModelLoadState::FAILED;
+				continue;
+			}
+
+			FinalizeModel(*load);
+		}
+		pendingModels_.resize(pendingCount);
+
+		if (IsOverBudget() == false)
+			return;
+
+		// Assets nothing refers to can be freed without unloading anything, models are only unloaded when that isn't enough.
+		EvictUnreferencedAssets();
+		while (IsOverBudget() && UnloadLeastRecentlyUsedModel())
+			EvictUnreferencedAssets();
+	}
+
+	void ResourceManager::SetMemoryBudget(AssetCategory category, size_t budget)
+	{
+		memoryBudgets_[size_t(category)] = budget;
+	}
+
+	size_t ResourceManager::GetMemoryBudget(AssetCategory category) const
+	{
+		return memoryBudgets_[size_t(category)];
+	}
+
+	size_t ResourceManager::GetMemoryUsage(AssetCategory category) const
+	{
+		return memoryUsage_[size_t(category)];
+	}
+
+	void ResourceManager::SetEvictionDelay(uint64_t frameCount)
+	{
+		evictionDelay_ = frameCount;
+	}
+
+	uint64_t ResourceManager::GetEvictionDelay() const
+	{
+		return evictionDelay_;
+	}
+
+	bool ResourceManager::IsOverBudget() const
+	{
+		for (size_t i = 0; i < size_t(AssetCategory::COUNT); ++i)
+		{
+			if (memoryUsage_[i] > memoryBudgets_[i])
+				return true;
+		}
+		return false;
+	}
+
+	bool ResourceManager::IsEvictable(uint64_t lastUsedFrame) const
+	{
+		return frame_ - lastUsedFrame > evictionDelay_;
+	}
+
+	void ResourceManager::EvictUnreferencedAssets()
+	{
+		size_t& meshUsage = memoryUsage_[size_t(AssetCategory::MESH)];
+		if (meshUsage > memoryBudgets_[size_t(AssetCategory::MESH)])
+		{
+			// Meshes only held by the resource manager aren't used by any model.
+			eastl::vector<eastl::shared_ptr<Mesh>*> candidates;
+			for (size_t i = 0, size = loadedMeshes_.size(); i < size; ++i)
+			{
+				if (loadedMeshes_[i].use_count() == 1 && IsEvictable(loadedMeshes_[i]->lastUsedFrame))
+					candidates.push_back(&loadedMeshes_[i]);
+			}
+			eastl::sort(candidates.begin(), candidates.end(), [](const eastl::shared_ptr<Mesh>* a, const eastl::shared_ptr<Mesh>* b)
+			{
+				return (*a)->lastUsedFrame < (*b)->lastUsedFrame;
+			});
+
+			for (size_t i = 0, size = candidates.size(); i < size && meshUsage > memoryBudgets_[size_t(AssetCategory::MESH)]; ++i)
+			{
+				eastl::shared_ptr<Mesh>& mesh = *candidates[i];
+				meshUsage -= mesh->memorySize;
+
+				const auto range = meshesByHash_.equal_range(mesh->hash);
+				for (auto it = range.first; it != range.second; ++it)
+				{
+					if (it->second.lock() == mesh)
+					{
+						meshesByHash_.erase(it);
+						break;
+					}
+				}
+				mesh.reset();
+			}
+
+			loadedMeshes_.erase(eastl::remove(loadedMeshes_.begin(), loadedMeshes_.end(), eastl::shared_ptr<Mesh>()), loadedMeshes_.end());
+		}
+
+		size_t& textureUsage = memoryUsage_[size_t(AssetCategory::TEXTURE)];
+		if (textureUsage > memoryBudgets_[size_t(AssetCategory::TEXTURE)])
+		{
+			// Materials only hold weak pointers to their textures, so the textures of the materials of the loaded models are kept explicitly.
+			eastl::hash_set<const Texture*> materialTextures;
+			for (size_t i = 0, size = loadedModels_.size(); i < size; ++i)
+			{
+				const auto& meshMaterialMap = loadedModels_[i]->meshMaterialMap;
+				for (auto it = meshMaterialMap.begin(); it != meshMaterialMap.end(); ++it)
+				{
+					const Material* material = it->second.get();
+					if (material == nullptr)
+						continue;
+
+					const eastl::weak_ptr<Texture>* textures[] = { &material->diffuseTexture, &material->defaultDiffuseTexture, &material->bumpMapTexture,
+						&material->defaultBumpMapTexture, &material->specularTexture, &material->defaultSpecularTexture, &material->missingTexture };
+					for (size_t j = 0; j < sizeof(textures) / sizeof(textures[0]); ++j)
+						materialTextures.insert(textures[j]->lock().get());
+				}
+			}
+
+			eastl::vector<eastl::map<eastl::string, eastl::shared_ptr<Texture>>::iterator> candidates;
+			for (auto it = loadedTextures_.begin(); it != loadedTextures_.end(); ++it)
+			{
+				const eastl::shared_ptr<Texture>& texture = it->second;
+				if (texture != nullptr && texture.use_count() == 1 && IsEvictable(texture->lastUsedFrame) &&
+					materialTextures.find(texture.get()) == materialTextures.end())
+					candidates.push_back(it);
+			}
+			eastl::sort(candidates.begin(), candidates.end(), [](const eastl::map<eastl::string, eastl::shared_ptr<Texture>>::iterator& a,
+				const eastl::map<eastl::string, eastl::shared_ptr<Texture>>::iterator& b)
+			{
+				return a->second->lastUsedFrame < b->second->lastUsedFrame;
+			});
+
+			for (size_t i = 0, size = candidates.size(); i < size && textureUsage > memoryBudgets_[size_t(AssetCategory::TEXTURE)]; ++i)
+			{
+				textureUsage -= candidates[i]->second->memorySize;
+				loadedTextures_.erase(candidates[i]);
+			}
+		}
+	}
+
+	bool ResourceManager::UnloadLeastRecentlyUsedModel()
+	{
+		Model* leastRecentlyUsed = nullptr;
 		for (size_t i = 0, size = loadedModels_.size(); i < size; ++i)
 		{
-			if (loadedModels_[i]->GetName() == modelName)
-				return loadedModels_[i];
+			Model* model = loadedModels_[i].get();
+			if (model->loadState == ModelLoadState::LOADED && model->componentCount == 0 && model->meshes.empty() == false && IsEvictable(model->lastUsedFrame) &&
+				(leastRecentlyUsed == nullptr || model->lastUsedFrame < leastRecentlyUsed->lastUsedFrame))
+				leastRecentlyUsed = model;
 		}
 
-		// If not (yet) loaded
-		return eastl::shared_ptr<Model>();
+		if (leastRecentlyUsed == nullptr)
+			return false;
+
+		// The meshes were last used together with the model, which orders them correctly against the other unreferenced meshes.
+		for (size_t i = 0, size = leastRecentlyUsed->meshes.size(); i < size; ++i)
+		{
+			Mesh* mesh = leastRecentlyUsed->meshes[i].get();
+			mesh->lastUsedFrame = eastl::max(mesh->lastUsedFrame, leastRecentlyUsed->lastUsedFrame);
+		}
+
+		leastRecentlyUsed->meshes.clear();
+		leastRecentlyUsed->meshTransforms.clear();
+		leastRecentlyUsed->meshMaterialMap.clear();
+		leastRecentlyUsed->loadState = ModelLoadState::UNLOADED;
+		return true;
 	}
 
-	eastl::weak_ptr<Model> ResourceManager::CreateModel(eastl::string modelName, eastl::string meshToLoad, eastl::string skeletonToLoad)
+	void ResourceManager::PrepareModelLoad(ModelLoad& load, const eastl::string& modelName, const eastl::string& meshToLoad, const eastl::string& skeletonToLoad) const
 	{
-		Assimp::Importer importer;
-		eastl::string path = "Resources/Models/" + meshToLoad;
-		eastl::string skeletonPath;
+		load.modelName = modelName;
+		load.meshToLoad = meshToLoad;
+		load.skeletonToLoad = skeletonToLoad != "" ? skeletonToLoad : meshToLoad;
+		load.isSkeletonGiven = skeletonToLoad != "";
 
-		const aiScene* scene = importer.ReadFile(path.c_str(), aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices | aiProcess_ImproveCacheLocality |
-			aiProcess_OptimizeMeshes);
+		load.isSkeletonLoaded = false;
+		for (size_t i = 0, size = loadedSkeletons_.size(); i < size; ++i)
+		{
+			if (loadedSkeletons_[i]->GetName() == load.skeletonToLoad)
+				load.isSkeletonLoaded = true;
+		}
+	}
 
-		// check if there's a scene or flags and check if the flags show incomplete scene
-		// or a missing root node (any successful import returns rood node)
-		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+	void ResourceManager::ReadModel(ModelLoad& load)
+	{
+		eastl::string path = "Resources/Models/" + load.meshToLoad;
+
+		if (ModelCache::Load(path, load.data) == false)
 		{
-			debug_warning("ResourceManager", "CreateModel", importer.GetErrorString());
-			return eastl::shared_ptr<Model>();
+			load.data = ModelData();
+
+			Assimp::Importer importer;
+			importer.SetIOHandler(new MappedIOSystem());
+			const aiScene* scene = importer.ReadFile(path.c_str(), aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices | aiProcess_ImproveCacheLocality |
+				aiProcess_OptimizeMeshes);
+
+			// check if there's a scene or flags and check if the flags show incomplete scene
+			// or a missing root node (any successful import returns rood node)
+			if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+			{
+				load.errorString = importer.GetErrorString();
+				return;
+			}
+
+			ReadScene(scene, load.data);
+
+			// A cache that can't be written only means the next load imports the file again.
+			ModelCache::Save(path, load.data);
+		}
+
+		load.isRead = true;
+		DecodeMaterialTextures(load);
+
+		// Models without bones or animations don't need a skeleton, unless one has been given explicitly.
+		load.needsSkeleton = load.isSkeletonGiven || load.data.hasAnimations;
+		for (size_t i = 0, size = load.data.meshes.size(); i < size && load.needsSkeleton == false; ++i)
+			load.needsSkeleton = load.data.meshes[i].bones.empty() == false;
+
+		// The skeleton of the model file is part of the model data and its cache, only a skeleton from another file is imported.
+		if (load.needsSkeleton && load.isSkeletonLoaded == false && load.skeletonToLoad == load.meshToLoad)
+		{
+			load.skeletonData = eastl::move(load.data.skeleton);
+			load.isSkeletonRead = true;
+		}
+		else if (load.needsSkeleton && load.isSkeletonLoaded == false)
+		{
+			eastl::string skeletonPath = "Resources/Models/" + load.skeletonToLoad;
+			Assimp::Importer skeletonImporter;
+			skeletonImporter.SetIOHandler(new MappedIOSystem());
+			const aiScene* skeletonScene = skeletonImporter.ReadFile(skeletonPath.c_str(), 0);
+
+			if (!skeletonScene || skeletonScene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !skeletonScene->mRootNode)
+			{
+				load.skeletonErrorString = skeletonImporter.GetErrorString();
+			}
+			else
+			{
+				Skeleton::ReadSkeletonData(skeletonScene, load.skeletonData);
+				load.isSkeletonRead = true;
+			}
+		}
+	}
+
+	void ResourceManager::ReadScene(const aiScene* scene, ModelData& modelData)
+	{
+		modelData.meshes.resize(scene->mNumMeshes);
+		for (unsigned i = 0; i < scene->mNumMeshes; ++i)
+			ReadMeshData(scene->mMeshes[i], modelData.meshes[i]);
+
+		modelData.materials.resize(scene->mNumMaterials);
+		for (unsigned i = 0; i < scene->mNumMaterials; ++i)
+			ReadMaterialDescription(scene->mMaterials[i], modelData.materials[i]);
+
+		modelData.textures.resize(scene->mNumTextures);
+		for (unsigned i = 0; i < scene->mNumTextures; ++i)
+		{
+			const aiTexture* texture = scene->mTextures[i];
+			const uint8_t* data = reinterpret_cast<const uint8_t*>(texture->pcData);
+			const size_t size = texture->mHeight == 0 ? texture->mWidth : size_t(texture->mWidth) * texture->mHeight * sizeof(aiTexel);
+
+			modelData.textures[i].width = texture->mWidth;
+			modelData.textures[i].height = texture->mHeight;
+			modelData.textures[i].data.assign(data, data + size);
+		}
+
+		ReadMeshInstances(scene->mRootNode, glm::mat4(1), modelData);
+		modelData.hasAnimations = scene->HasAnimations();
+		Skeleton::ReadSkeletonData(scene, modelData.skeleton);
+	}
+
+	void ResourceManager::ReadMeshInstances(const aiNode* node, const glm::mat4& parentTransform, ModelData& modelData)
+	{
+		// Assimp stores its matrices row major
+		const aiMatrix4x4& local = node->mTransformation;
+		const glm::mat4 transform = parentTransform * glm::mat4(local.a1, local.b1, local.c1, local.d1,
+			local.a2, local.b2, local.c2, local.d2,
+			local.a3, local.b3, local.c3, local.d3,
+			local.a4, local.b4, local.c4, local.d4);
+
+		// A node only places its own meshes, a mesh shared by several nodes is read once and instanced by each of them
+		for (unsigned i = 0; i < node->mNumMeshes; ++i)
+			modelData.meshInstances.push_back(MeshInstance{ transform, node->mMeshes[i] });
+
+		for (unsigned i = 0; i < node->mNumChildren; ++i)
+			ReadMeshInstances(node->mChildren[i], transform, modelData);
+	}
+
+	void ResourceManager::ReadMaterialDescription(const aiMaterial* material, MaterialDescription& description)
+	{
+		aiColor3D color(0.f, 0.f, 0.f);
+		material->Get(AI_MATKEY_COLOR_DIFFUSE, color);
+		float transparency = 1.f;
+		material->Get(AI_MATKEY_OPACITY, transparency);
+		description.diffuseColor = glm::vec4(color.r, color.g, color.b, transparency);
+
+		color = aiColor3D(0.f, 0.f, 0.f);
+		material->Get(AI_MATKEY_COLOR_SPECULAR, color);
+		description.specularColor = glm::vec4(color.r, color.g, color.b, 0.f);
+
+		float shiny = 0.f;
+		material->Get(AI_MATKEY_SHININESS, shiny);
+		description.specularExponent = shiny;
+
+		float specScale = 1.f;
+		material->Get(AI_MATKEY_SHININESS_STRENGTH, specScale);
+		description.specularScale = specScale;
+
+		const aiTextureType textureTypes[] = { aiTextureType_DIFFUSE, aiTextureType_SPECULAR, aiTextureType_NORMALS };
+		eastl::string* texturePaths[] = { &description.diffuseTexture, &description.specularTexture, &description.bumpMapTexture };
+		for (size_t i = 0; i < sizeof(textureTypes) / sizeof(textureTypes[0]); ++i)
+		{
+			aiString path;
+			if (material->GetTextureCount(textureTypes[i]) > 0 && material->GetTexture(textureTypes[i], 0, &path) == AI_SUCCESS)
+				*texturePaths[i] = eastl::string(path.C_Str());
+		}
+	}
+
+	void ResourceManager::DecodeMaterialTextures(ModelLoad& load)
+	{
+		for (size_t i = 0, size = load.data.materials.size(); i < size; ++i)
+		{
+			const MaterialDescription& material = load.data.materials[i];
+			const eastl::string* texturePaths[] = { &material.diffuseTexture, &material.specularTexture, &material.bumpMapTexture };
+
+			for (size_t j = 0; j < sizeof(texturePaths) / sizeof(texturePaths[0]); ++j)
+			{
+				const eastl::string& path = *texturePaths[j];
+				if (path.empty())
+					continue;
+
+				// Embedded textures are named after the model, the same way the material names them.
+				const bool isEmbedded = path[0] == '*';
+				DecodedTexture decodedTexture = {};
+				decodedTexture.name = isEmbedded ? load.modelName + path : path;
+
+				bool isDecoded = false;
+				for (size_t k = 0, textureCount = load.textures.size(); k < textureCount && isDecoded == false; ++k)
+					isDecoded = load.textures[k].name == decodedTexture.name;
+				if (isDecoded)
+					continue;
+
+				if (isEmbedded)
+				{
+					const uint32_t index = atoi(path.c_str() + 1);
+					if (index >= load.data.textures.size() || DecodeEmbeddedTexture(load.data.textures[index], decodedTexture) == false)
+						continue;
+				}
+				else
+				{
+					// Files that can't be decoded are left to the texture itself, which falls back to the default texture.
+					decodedTexture.data = Texture::LoadImageFile("Resources/Textures/" + decodedTexture.name,
+						decodedTexture.width, decodedTexture.height, decodedTexture.channels);
+					decodedTexture.genMipMaps = true;
+				}
+
+				if (decodedTexture.data != nullptr)
+					load.textures.push_back(eastl::move(decodedTexture));
+			}
+		}
+	}
+
+	bool ResourceManager::DecodeEmbeddedTexture(const EmbeddedTexture& texture, DecodedTexture& decodedTexture)
+	{
+		decodedTexture.genMipMaps = false;
+
+		if (texture.height == 0)
+		{
+			// Compressed texture
+			decodedTexture.data = stbi_load_from_memory(texture.data.data(), int(texture.data.size()),
+				&decodedTexture.width, &decodedTexture.height, &decodedTexture.channels, STBI_rgb_alpha);
+			return decodedTexture.data != nullptr;
 		}
 
-		eastl::weak_ptr<Skeleton> skeleton;
-		if (skeletonToLoad != "")
-			skeleton = CreateSkeleton(skeletonToLoad);
-		else
-			skeleton = CreateSkeleton(meshToLoad);
+		// Uncompressed textures are stored as BGRA texels.
+		const size_t texelCount = size_t(texture.width) * texture.height;
+		if (texture.data.size() < texelCount * 4)
+			return false;
+
+		decodedTexture.data = static_cast<stbi_uc*>(malloc(texelCount * 4));
+		if (decodedTexture.data == nullptr)
+			return false;
+
+		for (size_t i = 0; i < texelCount; ++i)
+		{
+			decodedTexture.data[i * 4] = texture.data[i * 4 + 2];
+			decodedTexture.data[i * 4 + 1] = texture.data[i * 4 + 1];
+			decodedTexture.data[i * 4 + 2] = texture.data[i * 4];
+			decodedTexture.data[i * 4 + 3] = texture.data[i * 4 + 3];
+		}
+
+		decodedTexture.width = int(texture.width);
+		decodedTexture.height = int(texture.height);
+		decodedTexture.channels = 4;
+		return true;
+	}
+
+	void ResourceManager::FinalizeModel(ModelLoad& load)
+	{
+		// The textures are created before the materials, so the materials find them instead of loading them again.
+		for (size_t i = 0, size = load.textures.size(); i < size; ++i)
+			AddDecodedTexture(load.textures[i]);
+
+		eastl::shared_ptr<Skeleton> skeleton;
+		for (size_t i = 0, size = loadedSkeletons_.size(); i < size && load.needsSkeleton; ++i)
+		{
+			if (loadedSkeletons_[i]->GetName() == load.skeletonToLoad)
+				skeleton = loadedSkeletons_[i];
+		}
 
-		loadedModels_.push_back(eastl::shared_ptr<Model>(new Model(scene, modelName)));
-		eastl::shared_ptr<Model>modelToAddTo = loadedModels_.back();
+		// Another load can have added the same skeleton while this one was running.
+		if (skeleton == nullptr && load.isSkeletonRead)
+		{
+			skeleton = eastl::shared_ptr<Skeleton>(new Skeleton(load.skeletonData));
+			skeleton->SetName(load.skeletonToLoad);
+			loadedSkeletons_.push_back(skeleton);
+		}
+		else if (skeleton == nullptr && load.needsSkeleton)
+		{
+			debug_warning("ResourceManager", "CreateSkeleton", load.skeletonErrorString);
+		}
 
 		// process the nodes and extract their data
-		ProcessModel(modelName, modelToAddTo, scene->mRootNode, scene, skeleton.lock());
-		return loadedModels_.back();
+		ProcessModel(load.modelName, load.model, load.data, skeleton);
+		load.model->loadState = ModelLoadState::LOADED;
+	}
+
+	void ResourceManager::AddDecodedTexture(DecodedTexture& decodedTexture)
+	{
+		if (loadedTextures_.find(decodedTexture.name) != loadedTextures_.end())
+			return;
+
+#ifdef USING_OPENGL
+		eastl::shared_ptr<Texture> createdTexture = eastl::shared_ptr<OpenGLTexture>(new OpenGLTexture(decodedTexture.width, decodedTexture.height));
+#endif
+#ifdef USING_VULKAN
+		eastl::shared_ptr<Texture> createdTexture = eastl::shared_ptr<VulkanTexture>(new VulkanTexture(decodedTexture.width, decodedTexture.height));
+#endif
+		createdTexture->fileName = decodedTexture.name;
+		createdTexture->channels = decodedTexture.channels;
+		createdTexture->CreateTextureWithData(decodedTexture.data, decodedTexture.genMipMaps);
+
+		stbi_image_free(decodedTexture.data);
+		decodedTexture.data = nullptr;
+
+		InsertTexture(decodedTexture.name, eastl::move(createdTexture));
+	}
+
+	eastl::weak_ptr<Texture> ResourceManager::InsertTexture(const eastl::string& textureName, eastl::shared_ptr<Texture> texture)
+	{
+		// Every loaded texture is uploaded as RGBA8.
+		texture->memorySize = size_t(texture->width) * size_t(texture->height) * 4;
+		texture->lastUsedFrame = frame_;
+		memoryUsage_[size_t(AssetCategory::TEXTURE)] += texture->memorySize;
+
+		eastl::shared_ptr<Texture>& loadedTexture = loadedTextures_[textureName];
+		loadedTexture = eastl::move(texture);
+		return loadedTexture;
 	}
 
 	eastl::weak_ptr<Skeleton> ResourceManager::CreateSkeleton(eastl::string skeletonToLoad)
 	{
 		Assimp::Importer importer;
+		importer.SetIOHandler(new MappedIOSystem());
 		eastl::string path = "Resources/Models/" + skeletonToLoad;
 
 		for (size_t i = 0, size = loadedSkeletons_.size(); i < size; ++i) {
@@ -92,6 +638,7 @@ namespace Engine
 	void ResourceManager::AddAnimationsToSkeleton(eastl::string skeletonName, eastl::string animationsToLoad, eastl::vector<eastl::string> names)
 	{
 		Assimp::Importer importer;
+		importer.SetIOHandler(new MappedIOSystem());
 		eastl::string path = "Resources/Animations/" + animationsToLoad;
 		const aiScene* scene = importer.ReadFile(path.c_str(), 0);
 
@@ -103,22 +650,34 @@ namespace Engine
 		}
 	}
 
-	eastl::weak_ptr<Mesh> ResourceManager::CreateMesh(aiMesh* mesh, eastl::shared_ptr<Skeleton> skeleton, eastl::vector<Vertex> vertices, eastl::vector<unsigned> indices)
+	eastl::weak_ptr<Mesh> ResourceManager::CreateMesh(MeshData&& meshData, eastl::shared_ptr<Skeleton> skeleton)
 	{
 		// If already loaded
-		eastl::weak_ptr<Mesh> meshToReturn = GetMesh(vertices, indices);
+		const uint64_t hash = Mesh::CalculateHash(meshData.vertices, meshData.indices);
+		eastl::weak_ptr<Mesh> meshToReturn = GetMesh(meshData.vertices, meshData.indices, hash);
 		if (meshToReturn.expired() == false && meshToReturn.lock().get() != nullptr)
+		{
+			meshToReturn.lock()->lastUsedFrame = frame_;
 			return meshToReturn;
+		}
+
+		const size_t memorySize = meshData.vertices.size() * sizeof(Vertex) + meshData.indices.size() * sizeof(unsigned);
 
 #ifdef USING_OPENGL
-		eastl::shared_ptr<Mesh> createdMesh = eastl::shared_ptr<OpenGLMesh>(new OpenGLMesh(vertices, indices));
+		eastl::shared_ptr<Mesh> createdMesh = eastl::shared_ptr<OpenGLMesh>(new OpenGLMesh(eastl::move(meshData.vertices), eastl::move(meshData.indices)));
 #endif
 #ifdef USING_VULKAN
-		eastl::shared_ptr<Mesh> createdMesh = eastl::shared_ptr<VulkanMesh>(new VulkanMesh(mesh, skeleton, vertices, indices));
+		eastl::shared_ptr<Mesh> createdMesh = eastl::shared_ptr<VulkanMesh>(new VulkanMesh(eastl::move(meshData), skeleton));
 #endif
+		createdMesh->hash = hash;
+		createdMesh->memorySize = memorySize;
+		createdMesh->lastUsedFrame = frame_;
+		memoryUsage_[size_t(AssetCategory::MESH)] += memorySize;
+
+		meshesByHash_.insert(eastl::make_pair(hash, eastl::weak_ptr<Mesh>(createdMesh)));
 		loadedMeshes_.push_back(eastl::move(createdMesh));
 
-		return meshToReturn;
+		return loadedMeshes_.back();
 	}
 
 	eastl::weak_ptr<Texture> ResourceManager::GetTexture(eastl::string meshName)
@@ -128,7 +687,10 @@ namespace Engine
 			return eastl::shared_ptr<Texture>();
 
 		// if already loaded
-		return loadedTextures_[meshName];
+		eastl::shared_ptr<Texture>& texture = loadedTextures_[meshName];
+		if (texture != nullptr)
+			texture->lastUsedFrame = frame_;
+		return texture;
 	}
 
 	eastl::weak_ptr<Texture> ResourceManager::CreateTexture(eastl::string textureName)
@@ -144,52 +706,50 @@ namespace Engine
 #ifdef USING_VULKAN
 		eastl::shared_ptr<Texture> createdTexture = eastl::shared_ptr<VulkanTexture>(new VulkanTexture(textureName));
 #endif
-		loadedTextures_.insert(eastl::make_pair(textureName, eastl::move(createdTexture)));
-
-		return loadedTextures_[textureName];
+		return InsertTexture(textureName, eastl::move(createdTexture));
 	}
 
-	void ResourceManager::ProcessModel(eastl::string modelName, eastl::shared_ptr<Model> modelToAddTo, aiNode* node, const aiScene* scene, eastl::shared_ptr<Skeleton> skeleton)
+	void ResourceManager::ProcessModel(eastl::string modelName, eastl::shared_ptr<Model> modelToAddTo, ModelData& modelData, eastl::shared_ptr<Skeleton> skeleton)
 	{
+		modelToAddTo->SetSkeleton(skeleton);
 
-		if (node->mParent == nullptr)
-			modelToAddTo->SetSkeleton(skeleton);
+		// Every mesh of the model is created once together with its material and its data is moved into it, later instances of the mesh reuse both.
+		eastl::vector<eastl::shared_ptr<Mesh>> meshes(modelData.meshes.size());
 
-		// process all node's meshes if any
-		// if there aren't any try going through the children nodes
-		for (unsigned short i = 0; i < scene->mNumMeshes; i++)
+		for (size_t i = 0, size = modelData.meshInstances.size(); i < size; ++i)
 		{
-			aiMesh* mesh = scene->mMeshes[i];
+			const MeshInstance& instance = modelData.meshInstances[i];
 
+			if (meshes[instance.mesh] == nullptr)
+			{
+				MeshData& meshData = modelData.meshes[instance.mesh];
+				const MaterialDescription description = meshData.materialIndex < modelData.materials.size() ?
+					modelData.materials[meshData.materialIndex] : MaterialDescription();
 
-			modelToAddTo->AddMesh(ProcessMesh(mesh, scene, skeleton).lock());
+				meshes[instance.mesh] = CreateMesh(eastl::move(meshData), skeleton).lock();
 
-			eastl::shared_ptr<Material> material;
+				eastl::shared_ptr<Material> material;
 
 #ifdef USING_VULKAN
-			material = eastl::shared_ptr<VulkanMaterial>(new VulkanMaterial(scene,
-				static_cast<uint32_t>(mesh->mMaterialIndex), modelName));
+				material = eastl::shared_ptr<VulkanMaterial>(new VulkanMaterial(description, modelName));
 #endif
 #ifdef USING_OPENGL
-			material = eastl::shared_ptr<Material>(new Material(scene,
-				static_cast<uint32_t>(mesh->mMaterialIndex), modelName));
+				material = eastl::shared_ptr<Material>(new Material(description, modelName));
 #endif
 
-			modelToAddTo->SetMeshMaterial(modelToAddTo->GetModelMeshes()[modelToAddTo->GetModelMeshes().size() - 1], eastl::move(material));
-		}
+				modelToAddTo->SetMeshMaterial(meshes[instance.mesh], eastl::move(material));
+			}
 
-		for (unsigned short i = 0; i < node->mNumChildren; i++)
-		{
-			ProcessModel(modelName, modelToAddTo, node->mChildren[i], scene, skeleton);
+			modelToAddTo->AddMesh(meshes[instance.mesh], instance.transform);
 		}
 	}
 
-	eastl::weak_ptr<Mesh> ResourceManager::ProcessMesh(aiMesh* mesh, const aiScene* scene, eastl::shared_ptr<Skeleton> skeleton)
+	void ResourceManager::ReadMeshData(aiMesh* mesh, MeshData& meshData)
 	{
-		eastl::vector<Vertex> vertices;
-		eastl::vector<unsigned> indices;
-		eastl::vector<eastl::shared_ptr<Texture>> diffuseTextures;
-		eastl::vector<eastl::shared_ptr<Texture>> specularTextures;
+		eastl::vector<Vertex>& vertices = meshData.vertices;
+		eastl::vector<unsigned>& indices = meshData.indices;
+		vertices.reserve(mesh->mNumVertices);
+		indices.reserve(mesh->mNumFaces * 3);
 
 		//unpack vertices
 		for (unsigned i = 0; i < mesh->mNumVertices; i++)
@@ -246,13 +806,28 @@ namespace Engine
 			}
 		}
 
-		//TODO - Parse materials
-		if (mesh->mMaterialIndex >= 0)
+		meshData.bones.resize(mesh->mNumBones);
+		for (unsigned i = 0; i < mesh->mNumBones; ++i)
 		{
-			aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+			const aiBone* bone = mesh->mBones[i];
+			MeshBone& meshBone = meshData.bones[i];
+
+			meshBone.name = eastl::string(bone->mName.C_Str());
+			meshBone.offset = glm::mat4(bone->mOffsetMatrix.a1, bone->mOffsetMatrix.b1, bone->mOffsetMatrix.c1, bone->mOffsetMatrix.d1,
+				bone->mOffsetMatrix.a2, bone->mOffsetMatrix.b2, bone->mOffsetMatrix.c2, bone->mOffsetMatrix.d2,
+				bone->mOffsetMatrix.a3, bone->mOffsetMatrix.b3, bone->mOffsetMatrix.c3, bone->mOffsetMatrix.d3,
+				bone->mOffsetMatrix.a4, bone->mOffsetMatrix.b4, bone->mOffsetMatrix.c4, bone->mOffsetMatrix.d4);
+
+			meshBone.weights.resize(bone->mNumWeights);
+			for (unsigned j = 0; j < bone->mNumWeights; ++j)
+				meshBone.weights[j] = VertexWeight{ bone->mWeights[j].mVertexId, bone->mWeights[j].mWeight };
 		}
 
-		return CreateMesh(mesh, skeleton, vertices, indices);
+		meshData.materialIndex = mesh->mMaterialIndex;
+
+		// The adjacency is only used by the shadow volumes of the Vulkan renderer, but it's part of the baked data so the cache works for every renderer.
+		Mesh::CalculateShadowIndices(vertices, indices, meshData.shadowIndices);
+
 	}
 
 	eastl::weak_ptr<Texture> ResourceManager::CreateTexture(eastl::string textureName, stbi_uc * data, int width, int height)
@@ -270,9 +845,7 @@ namespace Engine
 #endif
 		createdTexture->CreateTextureWithData(data, false);
 
-		loadedTextures_.insert(eastl::make_pair(textureName, eastl::move(createdTexture)));
-
-		return loadedTextures_[textureName];
+		return InsertTexture(textureName, eastl::move(createdTexture));
 	}
 
 	void ResourceManager::AddTexture(eastl::string textureName, eastl::shared_ptr<Texture> textureToAdd)
@@ -282,38 +855,18 @@ namespace Engine
 		if (textureToReturn.expired() == false && textureToReturn.lock().get() != nullptr)
 			return;
 
-		loadedTextures_[textureName] = eastl::move(textureToAdd);
+		InsertTexture(textureName, eastl::move(textureToAdd));
 	}
 
-	eastl::weak_ptr<Mesh> ResourceManager::GetMesh(eastl::vector<Vertex> vertices, eastl::vector<unsigned> indices)
+	eastl::weak_ptr<Mesh> ResourceManager::GetMesh(const eastl::vector<Vertex>& vertices, const eastl::vector<unsigned>& indices, uint64_t hash) const
 	{
-		if (loadedMeshes_.size() == 0) return eastl::shared_ptr<Mesh>();
-
-		for (size_t i = 0, size = loadedMeshes_.size(); i < size; ++i)
+		// Different geometry can share a hash, so every mesh with the hash is compared in full.
+		const auto range = meshesByHash_.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it)
 		{
-			bool isEqual = true;
-
-			if (loadedMeshes_[i]->vertices.size() != vertices.size()) continue;
-			if (loadedMeshes_[i]->indices.size() != indices.size()) continue;
-
-			for (size_t j = 0, verticesSize = loadedMeshes_[i]->vertices.size(); j < verticesSize; ++j)
-			{
-				Vertex vertex = loadedMeshes_[i]->vertices[j];
-
-				if (vertex.normal != vertices[j].normal) { isEqual = false; break; }
-				if (vertex.position != vertices[j].position) { isEqual = false; break; }
-				if (vertex.texCoords != vertices[j].texCoords) { isEqual = false; break; }
-			}
-
-			if (isEqual == false) continue;
-
-			for (size_t j = 0, indicesSize = loadedMeshes_[i]->indices.size(); j < indicesSize; ++j)
-			{
-				if (loadedMeshes_[i]->indices[j] != indices[j]) { isEqual = false; break; }
-			}
-
-			if (isEqual)
-				return loadedMeshes_[i];
+			eastl::shared_ptr<Mesh> mesh = it->second.lock();
+			if (mesh != nullptr && mesh->HasGeometry(vertices, indices))
+				return mesh;
 		}
 
 		return eastl::shared_ptr<Mesh>();
@@ -2,14 +2,28 @@
 
 #include "Engine/api.hpp"
 #include "Engine/Model/Model.hpp"
+#include "Engine/Resources/ModelCache.hpp"
 
 #include <ThirdParty/assimp/include/assimp/Importer.hpp>
 #include <ThirdParty/assimp/include/assimp/scene.h>
+#include <ThirdParty/EASTL-master/include/EASTL/hash_map.h>
 #include <ThirdParty/EASTL-master/include/EASTL/map.h>
 #include <ThirdParty/EASTL-master/include/EASTL/shared_ptr.h>
 
 namespace Engine
 {
+	class Job;
+
+	/// <summary>
+	/// The kinds of assets the resource manager keeps track of the memory of, each kind has its own budget.
+	/// </summary>
+	enum class AssetCategory
+	{
+		MESH = 0,		/// The vertices and indices of the loaded meshes
+		TEXTURE,		/// The pixels of the loaded textures
+		COUNT
+	};
+
 	/// <summary>
 	/// This class is used to create models, load in meshes and textures. NOTE: Only the Engine is allowed to create this object.
 	/// </summary>
@@ -17,13 +31,24 @@ namespace Engine
 	{
 	public:
 		/// <summary>
-		/// This method allows you to get a model with a specific name.
+		/// This method allows you to get a model with a specific name. The models are found through a hash table of their names.
+		/// A model whose meshes have been evicted to stay within the memory budget is loaded again on the job system, see UseModel.
+		/// NOTE: Code that uses a model every frame should look it up once and keep the pointer, see UseModel.
 		/// </summary>
 		/// <param name="modelName">The model name you are looking for.</param>
 		/// <returns>Returns a shared pointer to the model is it was found. Otherwise it will return a empty shared pointer.</returns>
-		eastl::weak_ptr<Model> GetModel(eastl::string modelName);
+		eastl::weak_ptr<Model> GetModel(const eastl::string& modelName);
+		/// <summary>
+		/// Marks a model that has been looked up before as used this frame, so it isn't evicted. Starts loading the model again if its meshes have been evicted.
+		/// The load is started by the next Update and runs on the job system, until it has finished the load state of the model is LOADING.
+		/// This is what GetModel does after finding the model, without looking up its name.
+		/// </summary>
+		/// <param name="model">The model that is used.</param>
+		void UseModel(const eastl::shared_ptr<Model>& model);
 		/// <summary>
 		/// This method will allow you to create a new model with the model name.
+		/// The first time a mesh file is loaded its processed contents are baked into a cache next to it, see ModelCache. Later loads read the cache instead of importing the file,
+		/// until the file changes. The cache contains the skeleton of an animated model as well, only a skeleton given as a separate file is still imported.
 		/// </summary>
 		/// <param name="modelName">The model you want to create.</param>
 		/// <param name="meshToLoad">Optional parameter where you can add a mesh you want to load in. NOTE: The mesh needs to be located under 'Resources/Models/'
@@ -34,6 +59,19 @@ namespace Engine
 		/// <returns>Will return a new model, optionally with an already loaded mesh and skeleton.</returns>
 		eastl::weak_ptr<Model> CreateModel(eastl::string modelName, eastl::string meshToLoad = "", eastl::string skeleton = "");
 		/// <summary>
+		/// This method will create a new model right away and load the mesh into it on the job system, so loading doesn't stall the frame.
+		/// Reading the file or its cache, processing the meshes, reading the skeleton and decoding the textures happen on worker threads.
+		/// The meshes and textures are uploaded on the main thread at the start of the frame after the load has finished, until then the model is an empty placeholder.
+		/// NOTE: Use Model::GetLoadState to check if the model has finished loading.
+		/// </summary>
+		/// <param name="modelName">The model you want to create.</param>
+		/// <param name="meshToLoad">The mesh you want to load in. NOTE: The mesh needs to be located under 'Resources/Models/'
+		/// You then give the mesh name + its extension. The mesh can be in a subfolder of 'Resources/Models/'</param>
+		/// <param name="skeleton">Optional parameter to load a specific skeleton with the model. If not specified the function will load the skeleton from
+		/// the same file as the model. NOTE: The skeleton needs to be located under 'Resources/Models/'</param>
+		/// <returns>Will return the new model, which is empty until it has finished loading.</returns>
+		eastl::weak_ptr<Model> CreateModelAsync(eastl::string modelName, eastl::string meshToLoad, eastl::string skeleton = "");
+		/// <summary>
 		/// This will load the skeleton data from the file specified. NOTe: This method will not load in the skeleton again, if it's already loaded in.
 		/// </summary>
 		/// <param name="skeletonToLoad">The file to load the skeleton from. NOTE: The skeleton needs to be located under 'Resources/Models/'
@@ -52,13 +90,12 @@ namespace Engine
 		void AddAnimationsToSkeleton(eastl::string skeletonName, eastl::string animationsToLoad = "", eastl::vector<eastl::string> names = {});
 		/// <summary>
 		/// This method allows you to create a new mesh. NOTE: This method will not load in the mesh again, if it's already loaded in.
+		/// Loaded meshes are found by the hash of their geometry, see Mesh::CalculateHash.
 		/// </summary>
-		/// <param name="mesh">The mesh you want to load in.</param>
+		/// <param name="meshData">The vertices, indices and bones of the mesh you want to load in. Moved into the created mesh, left untouched if the mesh was already loaded.</param>
 		/// <param name="skeleton">The skeleton the mesh is bound to. Passing a nullptr will create a non-animated mesh.</param>
-		/// <param name="vertices">The vertices of the mesh.</param>
-		/// <param name="indices">The indices of the mesh.</param>
 		/// <returns>Returns a shared_ptr of the mesh you want to create.</returns>
-		eastl::weak_ptr<Mesh> CreateMesh(aiMesh *mesh, eastl::shared_ptr<Skeleton> skeleton, eastl::vector<Vertex> vertices, eastl::vector<unsigned> indices);
+		eastl::weak_ptr<Mesh> CreateMesh(MeshData&& meshData, eastl::shared_ptr<Skeleton> skeleton);
 		/// <summary>
 		/// This method allows you to get a texture with the defined name.
 		/// </summary>
@@ -83,6 +120,35 @@ namespace Engine
 		/// <returns></returns>
 		eastl::weak_ptr<Texture> CreateTexture(eastl::string textureName, stbi_uc* data, int width, int height);
 
+		/// <summary>
+		/// Limits the memory used by the assets of the given category. Every frame the least recently used assets are evicted until the category is within its budget.
+		/// Only meshes and textures that nothing outside of the resource manager holds on to can be evicted, together with the materials of the loaded models.
+		/// When that isn't enough the meshes of the least recently used models are evicted, those models are loaded again the next time they are requested with GetModel.
+		/// Models held by a model component are never evicted, even when the component is disabled.
+		/// Evicted textures are loaded again by CreateTexture. Assets that have been used during the last few frames are never evicted, see SetEvictionDelay.
+		/// NOTE: Keep a shared pointer to textures that are used without a material, a weak pointer expires when the texture is evicted.
+		/// </summary>
+		/// <param name="category">The category to limit.</param>
+		/// <param name="budget">The maximum amount of bytes, the budget is unlimited by default.</param>
+		void SetMemoryBudget(AssetCategory category, size_t budget);
+		/// <summary>
+		/// Returns the maximum amount of bytes the assets of the given category can use.
+		/// </summary>
+		size_t GetMemoryBudget(AssetCategory category) const;
+		/// <summary>
+		/// Returns the amount of bytes used by the loaded assets of the given category.
+		/// </summary>
+		size_t GetMemoryUsage(AssetCategory category) const;
+		/// <summary>
+		/// Sets the amount of frames an asset has to be unused before it can be evicted. This has to cover the frames the renderer has in flight.
+		/// </summary>
+		/// <param name="frameCount">The amount of frames, 3 by default.</param>
+		void SetEvictionDelay(uint64_t frameCount);
+		/// <summary>
+		/// Returns the amount of frames an asset has to be unused before it can be evicted.
+		/// </summary>
+		uint64_t GetEvictionDelay() const;
+
 	private:
 		friend class Engine;
 		ResourceManager() = default;
@@ -90,18 +156,172 @@ namespace Engine
 		~ResourceManager() = default;
 	private:
 
+		/// <summary>
+		/// The pixels of a texture used by a model file, decoded to RGBA.
+		/// </summary>
+		struct DecodedTexture
+		{
+			eastl::string name;
+			stbi_uc* data;
+			int width;
+			int height;
+			int channels;
+			bool genMipMaps;
+		};
+
+		/// <summary>
+		/// Everything read from a model file. This is filled in without touching the resource manager, so it can be done on a worker thread.
+		/// </summary>
+		struct ModelLoad
+		{
+			~ModelLoad();
+
+			eastl::string modelName;
+			eastl::string meshToLoad;
+			eastl::string skeletonToLoad;
+			bool isSkeletonGiven = false;	/// Whether the skeleton comes from a separate file, which is loaded even if the model isn't animated
+			bool isSkeletonLoaded = false;	/// Whether the skeleton had already been loaded when the load started
+			bool needsSkeleton = false;
+
+			ModelData data;
+			bool isRead = false;
+			eastl::string errorString;
+
+			// The skeleton creates its animation textures, so only its data is read on the worker thread.
+			SkeletonData skeletonData;
+			bool isSkeletonRead = false;
+			eastl::string skeletonErrorString;
+
+			eastl::vector<DecodedTexture> textures;
+
+			eastl::shared_ptr<Model> model;
+			eastl::shared_ptr<Job> job;
+		};
+
+		/// <summary>
+		/// Starts loading the models that are needed again after being evicted, finishes the asynchronous model loads whose worker job has completed, then evicts assets until every category is within its budget.
+		/// Called by the engine at the start of every frame.
+		/// </summary>
+		void Update();
+
+		/// <summary>
+		/// Loads the mesh of the given model, its files are stored in the model. Fills in the model on success.
+		/// </summary>
+		/// <returns>Returns false if the model file couldn't be read.</returns>
+		bool LoadModel(const eastl::shared_ptr<Model>& model);
+
+		/// <summary>
+		/// Starts loading the mesh of the given model on the job system, the model is filled in by Update once the load has finished.
+		/// </summary>
+		void LoadModelAsync(const eastl::shared_ptr<Model>& model);
+
+		/// <summary>
+		/// Prepares a load of the given files, the skeleton is only read when it hasn't been loaded before.
+		/// </summary>
+		void PrepareModelLoad(ModelLoad& load, const eastl::string& modelName, const eastl::string& meshToLoad, const eastl::string& skeletonToLoad) const;
+
+		/// <summary>
+		/// Reads the model from its cache, or imports the model file and bakes its cache. Then takes its skeleton from the model data or reads it from the skeleton file,
+		/// and decodes its textures. Safe to call from any thread.
+		/// </summary>
+		static void ReadModel(ModelLoad& load);
+
+		/// <summary>
+		/// Copies everything the engine uses out of an imported scene.
+		/// </summary>
+		static void ReadScene(const aiScene* scene, ModelData& modelData);
+
+		/// <summary>
+		/// Adds the meshes of the given node and its children to the mesh instances of the model.
+		/// </summary>
+		/// <param name="parentTransform">The transform of the parent of the node relative to the root of the model.</param>
+		static void ReadMeshInstances(const aiNode* node, const glm::mat4& parentTransform, ModelData& modelData);
+
+		/// <summary>
+		/// Reads the colors and the first diffuse, specular and normal texture of a material.
+		/// </summary>
+		static void ReadMaterialDescription(const aiMaterial* material, MaterialDescription& description);
+
+		/// <summary>
+		/// Decodes the textures of every material, the textures materials load when they are created.
+		/// </summary>
+		static void DecodeMaterialTextures(ModelLoad& load);
+
+		/// <summary>
+		/// Decodes an embedded texture to RGBA.
+		/// </summary>
+		/// <returns>Returns false if the texture couldn't be decoded.</returns>
+		static bool DecodeEmbeddedTexture(const EmbeddedTexture& texture, DecodedTexture& decodedTexture);
+
+		/// <summary>
+		/// Creates the skeleton, textures, meshes and materials of a model from a completed load. Needs to run on the main thread.
+		/// </summary>
+		void FinalizeModel(ModelLoad& load);
+
+		/// <summary>
+		/// Creates a texture from pixels decoded on a worker thread, unless a texture with the same name has already been loaded.
+		/// </summary>
+		void AddDecodedTexture(DecodedTexture& decodedTexture);
+
+		/// <summary>
+		/// Adds a model to the loaded models. When several models have the same name, GetModel keeps finding the first one.
+		/// </summary>
+		void AddModel(const eastl::shared_ptr<Model>& model);
+
+		/// <summary>
+		/// Adds a texture to the loaded textures and to the memory usage.
+		/// </summary>
+		eastl::weak_ptr<Texture> InsertTexture(const eastl::string& textureName, eastl::shared_ptr<Texture> texture);
+
+		/// <summary>
+		/// Returns whether the memory usage of any category is over its budget.
+		/// </summary>
+		bool IsOverBudget() const;
+
+		/// <summary>
+		/// Returns whether an asset last used during the given frame can be evicted. The frames that are still being rendered can use it.
+		/// </summary>
+		bool IsEvictable(uint64_t lastUsedFrame) const;
+
+		/// <summary>
+		/// Evicts the least recently used meshes and textures that are over budget, only assets that nothing else refers to are evicted.
+		/// </summary>
+		void EvictUnreferencedAssets();
+
+		/// <summary>
+		/// Evicts the meshes and materials of the least recently used loaded model. The model itself stays valid and keeps its skeleton.
+		/// </summary>
+		/// <returns>Returns false if every loaded model has been used too recently.</returns>
+		bool UnloadLeastRecentlyUsedModel();
+
 		friend class Model;
 		void AddTexture(eastl::string textureName, eastl::shared_ptr<Texture> textureToAdd);
-		eastl::weak_ptr<Mesh> GetMesh(eastl::vector<Vertex> vertices, eastl::vector<unsigned> indices);
-		void ProcessModel(eastl::string modelName, eastl::shared_ptr<Model> modelToAddTo, aiNode* node, const aiScene* scene, eastl::shared_ptr<Skeleton> skeleton);
-		eastl::weak_ptr<Mesh> ProcessMesh(aiMesh* mesh, const aiScene* scene, eastl::shared_ptr<Skeleton> skeleton);
+		/// <summary>
+		/// Finds a loaded mesh with the given geometry. Only the meshes with the same hash are compared.
+		/// </summary>
+		/// <param name="hash">The hash of the geometry, calculated by Mesh::CalculateHash.</param>
+		eastl::weak_ptr<Mesh> GetMesh(const eastl::vector<Vertex>& vertices, const eastl::vector<unsigned>& indices, uint64_t hash) const;
+		/// <summary>
+		/// Adds the meshes and materials of the model data to the model. The meshes are moved out of the model data.
+		/// </summary>
+		void ProcessModel(eastl::string modelName, eastl::shared_ptr<Model> modelToAddTo, ModelData& modelData, eastl::shared_ptr<Skeleton> skeleton);
+		static void ReadMeshData(aiMesh* mesh, MeshData& meshData);
 		eastl::vector<eastl::shared_ptr<Texture>> ProcessDiffuseTextures(aiMaterial* material);
 		eastl::vector<eastl::shared_ptr<Texture>> ProcessSpecularTextures(aiMaterial* material);
 		eastl::vector<eastl::shared_ptr<Texture>> LoadMaterialTextures(aiMaterial* material, aiTextureType textureType, eastl::string typeName);
 
 		eastl::vector<eastl::shared_ptr<Model>> loadedModels_;
+		eastl::hash_map<eastl::string, eastl::shared_ptr<Model>> modelsByName_;
 		eastl::vector<eastl::shared_ptr<Skeleton>> loadedSkeletons_;
 		eastl::vector<eastl::shared_ptr<Mesh>> loadedMeshes_;
+		eastl::hash_multimap<uint64_t, eastl::weak_ptr<Mesh>> meshesByHash_;
 		eastl::map<eastl::string, eastl::shared_ptr<Texture>> loadedTextures_;
+		eastl::vector<eastl::shared_ptr<ModelLoad>> pendingModels_;
+		eastl::vector<eastl::shared_ptr<Model>> modelsToReload_;
+
+		uint64_t frame_ = 0;
+		uint64_t evictionDelay_ = 3;
+		size_t memoryUsage_[size_t(AssetCategory::COUNT)] = {};
+		size_t memoryBudgets_[size_t(AssetCategory::COUNT)] = { SIZE_MAX, SIZE_MAX };
 	};
 } // namespace Engine
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "Engine/Texture/Texture.hpp"
 #include "Engine/engine.hpp"
 #include "Engine/Utility/Logging.hpp"
+#include "Engine/Utility/MappedFile.hpp"
 #include "Engine/Utility/Utility.hpp"
 
 #include <assert.h>
@@ -15,7 +16,7 @@ namespace Engine
 	////////////////////////////////////////////////////////////////////////////////
 	// Compile shader and report success or failure
 	////////////////////////////////////////////////////////////////////////////////
-	bool CompileShader(GLuint* shader, GLenum type, const GLchar* source)
+	bool CompileShader(GLuint* shader, GLenum type, const GLchar* source, GLint length)
 	{
 		GLint status;
 
@@ -26,7 +27,7 @@ namespace Engine
 		}
 
 		*shader = glCreateShader(type);
-		glShaderSource(*shader, 1, &source, nullptr);
+		glShaderSource(*shader, 1, &source, &length);
 		glGetError();
 		glCompileShader(*shader);
 
@@ -246,8 +247,15 @@ namespace Engine
 
 	GLuint LoadShader(eastl::string filePath, int shaderType)
 	{
+		// The source is passed with its length, the mapped file isn't null terminated.
+		MappedFile file(filePath);
+		if (!file.IsOpen())
+		{
+			throw std::runtime_error("Failed to open file!");
+		}
+
 		GLuint shader;
-		CompileShader(&shader, shaderType, reinterpret_cast<char const *const>(Utility::ReadFile(filePath, std::ios::binary).data()));
+		CompileShader(&shader, shaderType, reinterpret_cast<const GLchar*>(file.GetData()), GLint(file.GetSize()));
 		return shader;
 	}
 
@@ -1,6 +1,5 @@
 #include "Engine/Texture/OpenGLTexture.hpp"
 #ifdef USING_OPENGL
-#include "Engine/Utility/Utility.hpp"
 
 #include <ThirdParty/glew-2.1.0/include/GL/glew.h>
 
@@ -10,10 +9,9 @@ namespace Engine
 	{
 		eastl::string baseLocation = "Resources/Textures/";
 		baseLocation.append(filename);
-		stbi_uc* textureData = stbi_load(
-			Utility::FileExists(baseLocation) ?
-			baseLocation.c_str() :
-			"Resources/Textures/default.png", &width, &height, &channels, STBI_rgb_alpha);
+		stbi_uc* textureData = LoadImageFile(baseLocation, width, height, channels);
+		if (textureData == nullptr)
+			textureData = LoadImageFile("Resources/Textures/default.png", width, height, channels);
 		OpenGLTexture::CreateTextureWithData(textureData, true);
 		stbi_image_free(textureData);
 	}
@@ -1,4 +1,7 @@
 #include "Engine/Texture/Texture.hpp"
+#include "Engine/Utility/MappedFile.hpp"
+
+#include <climits>
 
 namespace Engine
 {
@@ -14,6 +17,15 @@ namespace Engine
 	{
 	}
 
+	stbi_uc* Texture::LoadImageFile(const eastl::string& path, int& width, int& height, int& channels)
+	{
+		const MappedFile file(path);
+		if (file.GetData() == nullptr || file.GetSize() > size_t(INT_MAX))
+			return nullptr;
+
+		return stbi_load_from_memory(file.GetData(), int(file.GetSize()), &width, &height, &channels, STBI_rgb_alpha);
+	}
+
 	uint64_t Texture::GetTexture() const
 	{
 		return texture;
@@ -38,6 +38,10 @@ namespace Engine
 		/// <param name="height">The height of the texture you want to create.</param>
 		Texture(int width, int height);
 
+		// Kept by the resource manager, which evicts the least recently used textures when they exceed its memory budget.
+		size_t memorySize = 0;
+		uint64_t lastUsedFrame = 0;
+
 		/// <summary>
 		/// Destructor of texture object.
 		/// </summary>
@@ -111,5 +115,15 @@ namespace Engine
 		/// <param name="filename">This is the name of the texture you want to load. NOTE: The texture needs to be in the folder 'Resources/Textures/' (It can be in a subfolder, as long as it's in the Textures folder). And the extension type needs to be added as well.</param>
 		/// <param name="desiredChannels">The amount of desired channels for this texture. This value is 4 by default.</param>
 		explicit Texture(const eastl::string& filename, int desiredChannels = 4);
+
+		/// <summary>
+		/// Decodes an image file to RGBA pixels with stb_image. The file is decoded straight from a memory mapping, without reading it into a buffer first.
+		/// </summary>
+		/// <param name="path">The path of the image file.</param>
+		/// <param name="width">Set to the width of the image.</param>
+		/// <param name="height">Set to the height of the image.</param>
+		/// <param name="channels">Set to the amount of channels in the image file, the pixels always have 4.</param>
+		/// <returns>Returns the pixels, which have to be freed with stbi_image_free. Returns nullptr if the file doesn't exist or can't be decoded.</returns>
+		static stbi_uc* LoadImageFile(const eastl::string& path, int& width, int& height, int& channels);
 	};
 } //namespace Engine
\ No newline at end of file
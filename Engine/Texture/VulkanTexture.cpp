@@ -1,5 +1,4 @@
 #include "Engine/Texture/VulkanTexture.hpp"
-#include "Engine/Utility/Utility.hpp"
 #ifdef USING_VULKAN
 #include "Engine/Renderer/VulkanRenderer.hpp"
 #include "Engine/engine.hpp"
@@ -12,11 +11,9 @@ namespace Engine
 		eastl::string baseLocation = "Resources/Textures/";
 		baseLocation.append(filename);
 
-		stbi_uc* textureData = stbi_load(
-			Utility::FileExists(baseLocation) ?
-			baseLocation.c_str() :
-			"Resources/Textures/default.png",
-			&width, &height, &channels, STBI_rgb_alpha);
+		stbi_uc* textureData = LoadImageFile(baseLocation, width, height, channels);
+		if (textureData == nullptr)
+			textureData = LoadImageFile("Resources/Textures/default.png", width, height, channels);
 
 		VulkanTexture::CreateTextureWithData(textureData, true);
 
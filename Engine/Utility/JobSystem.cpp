@@ -0,0 +1,254 @@
+#include "Engine/Utility/JobSystem.hpp"
+
+#include <assert.h>
+
+namespace Engine
+{
+	namespace
+	{
+		// The queue the current thread pushes its jobs to. Threads that are not workers all share queue 0.
+		thread_local size_t currentQueueIndex = 0;
+	}
+
+	Job::Job(std::function<void()> function) : function(eastl::move(function)), pendingDependencies(1), isScheduled(false), isFinished(false), isBackground(false)
+	{
+	}
+
+	bool Job::GetIsFinished() const
+	{
+		return isFinished;
+	}
+
+	JobSystem::JobSystem() : workerCount(0), queuedJobCount(0), isStopping(false)
+	{
+		const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+
+		// The thread waiting for the jobs helps out as well, so it doesn't need a worker of its own.
+		StartWorkers(hardwareThreads > 1 ? hardwareThreads - 1 : 0);
+	}
+
+	JobSystem::~JobSystem()
+	{
+		StopWorkers();
+	}
+
+	eastl::shared_ptr<Job> JobSystem::CreateJob(std::function<void()> function)
+	{
+		return eastl::shared_ptr<Job>(new Job(eastl::move(function)));
+	}
+
+	void JobSystem::AddDependency(const eastl::shared_ptr<Job>& job, const eastl::shared_ptr<Job>& dependency)
+	{
+		assert(job->isScheduled == false); // Dependencies have to be added before the job gets scheduled!
+
+		std::lock_guard<std::mutex> lock(dependency->dependentsMutex);
+		if (dependency->isFinished)
+			return;
+
+		++job->pendingDependencies;
+		dependency->dependents.push_back(job);
+	}
+
+	void JobSystem::Schedule(const eastl::shared_ptr<Job>& job)
+	{
+		assert(job->isScheduled == false); // A job can only be scheduled once!
+		job->isScheduled = true;
+
+		// Release the count that kept the job from running before it was scheduled.
+		if (--job->pendingDependencies == 0)
+			Enqueue(job);
+	}
+
+	eastl::shared_ptr<Job> JobSystem::Run(std::function<void()> function)
+	{
+		eastl::shared_ptr<Job> job = CreateJob(eastl::move(function));
+		Schedule(job);
+		return job;
+	}
+
+	eastl::shared_ptr<Job> JobSystem::RunInBackground(std::function<void()> function)
+	{
+		eastl::shared_ptr<Job> job = CreateJob(eastl::move(function));
+		job->isBackground = true;
+		Schedule(job);
+		return job;
+	}
+
+	void JobSystem::Wait(const eastl::shared_ptr<Job>& job)
+	{
+		assert(job->isScheduled); // Waiting for a job that has not been scheduled will never finish!
+
+		const size_t queueIndex = GetCurrentQueueIndex();
+		while (job->isFinished == false)
+		{
+			if (TryExecuteJob(queueIndex) == false)
+				std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::SetWorkerCount(size_t workerCount)
+	{
+		if (workerCount == this->workerCount)
+			return;
+
+		StopWorkers();
+		StartWorkers(workerCount);
+	}
+
+	size_t JobSystem::GetWorkerCount() const
+	{
+		return workerCount;
+	}
+
+	void JobSystem::StartWorkers(size_t workerCount)
+	{
+		isStopping = false;
+
+		queues.clear();
+		for (size_t i = 0; i < workerCount + 1; ++i)
+			queues.push_back(eastl::unique_ptr<JobQueue>(new JobQueue()));
+
+		// Set before the first worker starts, so the workers never see it change.
+		this->workerCount = workerCount;
+
+		workers.reserve(workerCount);
+		for (size_t i = 0; i < workerCount; ++i)
+			workers.push_back(std::thread(&JobSystem::WorkerLoop, this, i + 1));
+	}
+
+	void JobSystem::StopWorkers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(wakeUpMutex);
+			isStopping = true;
+		}
+		wakeUpCondition.notify_all();
+
+		for (size_t i = 0, size = workers.size(); i < size; ++i)
+			workers[i].join();
+		workers.clear();
+		workerCount = 0;
+
+		// Finish whatever was left behind by the workers on this thread, so no scheduled job is ever dropped.
+		while (TryExecuteJob(0) || TryExecuteBackgroundJob())
+		{
+		}
+	}
+
+	void JobSystem::WorkerLoop(size_t queueIndex)
+	{
+		currentQueueIndex = queueIndex;
+
+		while (isStopping == false)
+		{
+			if (TryExecuteJob(queueIndex) || TryExecuteBackgroundJob())
+				continue;
+
+			std::unique_lock<std::mutex> lock(wakeUpMutex);
+			wakeUpCondition.wait(lock, [this]() { return isStopping || queuedJobCount > 0; });
+		}
+	}
+
+	void JobSystem::Enqueue(const eastl::shared_ptr<Job>& job)
+	{
+		// Without workers nothing would pick up the background queue, so background jobs run on the thread that waits for them instead.
+		JobQueue& queue = job->isBackground && workerCount > 0 ? backgroundQueue : *queues[GetCurrentQueueIndex()];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back(job);
+		}
+
+		{
+			// Taking the lock makes sure a worker that is about to sleep can't miss this job.
+			std::lock_guard<std::mutex> lock(wakeUpMutex);
+			++queuedJobCount;
+		}
+		wakeUpCondition.notify_one();
+	}
+
+	bool JobSystem::TryExecuteJob(size_t queueIndex)
+	{
+		eastl::shared_ptr<Job> job;
+
+		{
+			JobQueue& queue = *queues[queueIndex];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.jobs.empty() == false)
+			{
+				// Without workers the jobs run in the order they were scheduled, which keeps the results deterministic.
+				// With workers the newest job is taken first, since its data is most likely still in the cache.
+				if (workerCount == 0)
+				{
+					job = queue.jobs.front();
+					queue.jobs.pop_front();
+				}
+				else
+				{
+					job = queue.jobs.back();
+					queue.jobs.pop_back();
+				}
+			}
+		}
+
+		// Steal the oldest job of one of the other queues.
+		for (size_t i = 1, size = queues.size(); job == nullptr && i < size; ++i)
+		{
+			JobQueue& queue = *queues[(queueIndex + i) % size];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.jobs.empty())
+				continue;
+
+			job = queue.jobs.front();
+			queue.jobs.pop_front();
+		}
+
+		if (job == nullptr)
+			return false;
+
+		--queuedJobCount;
+		Execute(job);
+		return true;
+	}
+
+	bool JobSystem::TryExecuteBackgroundJob()
+	{
+		eastl::shared_ptr<Job> job;
+
+		{
+			std::lock_guard<std::mutex> lock(backgroundQueue.mutex);
+			if (backgroundQueue.jobs.empty())
+				return false;
+
+			job = backgroundQueue.jobs.front();
+			backgroundQueue.jobs.pop_front();
+		}
+
+		--queuedJobCount;
+		Execute(job);
+		return true;
+	}
+
+	void JobSystem::Execute(const eastl::shared_ptr<Job>& job)
+	{
+		if (job->function)
+			job->function();
+
+		eastl::vector<eastl::shared_ptr<Job>> dependents;
+		{
+			std::lock_guard<std::mutex> lock(job->dependentsMutex);
+			job->isFinished = true;
+			dependents.swap(job->dependents);
+		}
+
+		for (size_t i = 0, size = dependents.size(); i < size; ++i)
+		{
+			if (--dependents[i]->pendingDependencies == 0)
+				Enqueue(dependents[i]);
+		}
+	}
+
+	size_t JobSystem::GetCurrentQueueIndex() const
+	{
+		return currentQueueIndex < queues.size() ? currentQueueIndex : 0;
+	}
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "Engine/api.hpp"
+
+#include <ThirdParty/EASTL-master/include/EASTL/deque.h>
+#include <ThirdParty/EASTL-master/include/EASTL/shared_ptr.h>
+#include <ThirdParty/EASTL-master/include/EASTL/unique_ptr.h>
+#include <ThirdParty/EASTL-master/include/EASTL/vector.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Engine
+{
+	class JobSystem;
+
+	/// <summary>
+	/// A single unit of work for the job system. Jobs can depend on other jobs, a job will only start once all of its dependencies have finished.
+	/// NOTE: Jobs can only be created by the job system.
+	/// </summary>
+	class ENGINE_API Job
+	{
+	public:
+		~Job() = default;
+
+		/// <summary>
+		/// This method allows you to check if this job has finished executing.
+		/// </summary>
+		/// <returns>Returns true if the job has finished.</returns>
+		bool GetIsFinished() const;
+
+	private:
+		friend class JobSystem;
+		explicit Job(std::function<void()> function);
+
+		std::function<void()> function;
+		eastl::vector<eastl::shared_ptr<Job>> dependents;
+		std::mutex dependentsMutex;
+		// Starts at one, the extra count is released when the job gets scheduled.
+		std::atomic<int> pendingDependencies;
+		std::atomic<bool> isScheduled;
+		std::atomic<bool> isFinished;
+		bool isBackground;
+	};
+
+	/// <summary>
+	/// This object runs jobs on a fixed amount of worker threads. Every worker has its own queue and steals work from the other queues when it runs out of jobs.
+	/// The thread calling Wait helps executing jobs until the job it waits for has finished. Background jobs are only picked up by idle workers, never by a waiting thread.
+	/// When the worker count is set to 0, all jobs run on the thread calling Wait in the order they were scheduled, which makes the results deterministic.
+	/// NOTE: This object can only be created by the Engine.
+	/// </summary>
+	class ENGINE_API JobSystem
+	{
+		friend class Engine;
+
+		JobSystem();
+	public:
+		~JobSystem();
+
+		/// <summary>
+		/// Creates a new job. The job will not run until it has been scheduled.
+		/// </summary>
+		/// <param name="function">The function to execute.</param>
+		/// <returns>Returns the created job.</returns>
+		eastl::shared_ptr<Job> CreateJob(std::function<void()> function);
+
+		/// <summary>
+		/// Makes the given job wait for the dependency to finish. NOTE: This needs to be called before the job has been scheduled.
+		/// </summary>
+		/// <param name="job">The job that has to wait.</param>
+		/// <param name="dependency">The job that has to finish first.</param>
+		void AddDependency(const eastl::shared_ptr<Job>& job, const eastl::shared_ptr<Job>& dependency);
+
+		/// <summary>
+		/// Submits the given job. The job will run as soon as all of its dependencies have finished.
+		/// </summary>
+		/// <param name="job">The job to schedule.</param>
+		void Schedule(const eastl::shared_ptr<Job>& job);
+
+		/// <summary>
+		/// Creates and schedules a job in one go.
+		/// </summary>
+		/// <param name="function">The function to execute.</param>
+		/// <returns>Returns the scheduled job.</returns>
+		eastl::shared_ptr<Job> Run(std::function<void()> function);
+
+		/// <summary>
+		/// Creates and schedules a long running job, like loading a file. Background jobs are only executed by workers that have nothing else to do,
+		/// so a thread waiting for its own jobs never gets stuck executing one. Without workers the job runs on the next thread that calls Wait.
+		/// </summary>
+		/// <param name="function">The function to execute.</param>
+		/// <returns>Returns the scheduled job.</returns>
+		eastl::shared_ptr<Job> RunInBackground(std::function<void()> function);
+
+		/// <summary>
+		/// Blocks until the given job has finished. The calling thread executes other jobs while it waits.
+		/// </summary>
+		/// <param name="job">The job to wait for.</param>
+		void Wait(const eastl::shared_ptr<Job>& job);
+
+		template<typename Function>
+		/// <summary>
+		/// Splits the range [0, count) into batches and runs the given function for every batch, then waits for all of them to finish.
+		/// </summary>
+		/// <param name="count">The amount of elements to process.</param>
+		/// <param name="batchSize">The maximum amount of elements per batch.</param>
+		/// <param name="function">The function to call, this function should accept the begin and end index of its batch.</param>
+		void ParallelFor(size_t count, size_t batchSize, Function function);
+
+		/// <summary>
+		/// Changes the amount of worker threads. All scheduled jobs will be finished before the workers are replaced.
+		/// Use 0 to run every job on the thread that waits for it, this is the deterministic single threaded mode.
+		/// </summary>
+		/// <param name="workerCount">The new amount of worker threads.</param>
+		void SetWorkerCount(size_t workerCount);
+
+		/// <summary>
+		/// Returns the amount of worker threads, not counting the thread that waits for jobs.
+		/// </summary>
+		size_t GetWorkerCount() const;
+
+	private:
+		struct JobQueue
+		{
+			eastl::deque<eastl::shared_ptr<Job>> jobs;
+			std::mutex mutex;
+		};
+
+		void StartWorkers(size_t workerCount);
+		void StopWorkers();
+		void WorkerLoop(size_t queueIndex);
+
+		void Enqueue(const eastl::shared_ptr<Job>& job);
+		bool TryExecuteJob(size_t queueIndex);
+		bool TryExecuteBackgroundJob();
+		void Execute(const eastl::shared_ptr<Job>& job);
+		size_t GetCurrentQueueIndex() const;
+
+		// Queue 0 belongs to the threads that are not workers, every worker owns the queue at its index + 1.
+		eastl::vector<eastl::unique_ptr<JobQueue>> queues;
+		JobQueue backgroundQueue;
+		eastl::vector<std::thread> workers;
+		// Only changed while no workers are running, so the workers can read it while the threads are being started.
+		size_t workerCount;
+		std::atomic<size_t> queuedJobCount;
+		std::atomic<bool> isStopping;
+		std::mutex wakeUpMutex;
+		std::condition_variable wakeUpCondition;
+	};
+
+	template <typename Function>
+	void JobSystem::ParallelFor(size_t count, size_t batchSize, Function function)
+	{
+		if (count == 0)
+			return;
+
+		if (batchSize == 0)
+			batchSize = 1;
+
+		// There is nothing to gain from splitting up the work without workers or when it fits in a single batch.
+		if (workerCount == 0 || count <= batchSize)
+		{
+			function(size_t(0), count);
+			return;
+		}
+
+		eastl::shared_ptr<Job> rootJob = CreateJob(std::function<void()>());
+
+		for (size_t begin = 0; begin < count; begin += batchSize)
+		{
+			const size_t end = begin + batchSize < count ? begin + batchSize : count;
+			eastl::shared_ptr<Job> batchJob = CreateJob([&function, begin, end]() { function(begin, end); });
+
+			AddDependency(rootJob, batchJob);
+			Schedule(batchJob);
+		}
+
+		Schedule(rootJob);
+		Wait(rootJob);
+	}
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include "Engine/Utility/MappedFile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Engine
+{
+	MappedFile::MappedFile() : data(nullptr), size(0), isOpen(false)
+	{
+	}
+
+	MappedFile::MappedFile(const eastl::string& fileName) : MappedFile()
+	{
+		Open(fileName);
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept : data(other.data), size(other.size), isOpen(other.isOpen)
+	{
+		other.data = nullptr;
+		other.size = 0;
+		other.isOpen = false;
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Close();
+			data = other.data;
+			size = other.size;
+			isOpen = other.isOpen;
+			other.data = nullptr;
+			other.size = 0;
+			other.isOpen = false;
+		}
+		return *this;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	bool MappedFile::Open(const eastl::string& fileName)
+	{
+		Close();
+
+		// The view keeps the file mapped on its own, so the handles are closed as soon as the view exists.
+#ifdef _WIN32
+		const HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER fileSize;
+		if (GetFileSizeEx(file, &fileSize) == FALSE || uint64_t(fileSize.QuadPart) > uint64_t(SIZE_MAX))
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		// Empty files can't be mapped.
+		if (fileSize.QuadPart > 0)
+		{
+			const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping == nullptr)
+			{
+				CloseHandle(file);
+				return false;
+			}
+
+			data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			CloseHandle(mapping);
+			if (data == nullptr)
+			{
+				CloseHandle(file);
+				return false;
+			}
+		}
+
+		CloseHandle(file);
+		size = size_t(fileSize.QuadPart);
+#else
+		const int file = open(fileName.c_str(), O_RDONLY);
+		if (file == -1)
+			return false;
+
+		struct stat fileStatus;
+		if (fstat(file, &fileStatus) != 0 || S_ISREG(fileStatus.st_mode) == false)
+		{
+			close(file);
+			return false;
+		}
+
+		// Empty files can't be mapped.
+		if (fileStatus.st_size > 0)
+		{
+			void* view = mmap(nullptr, size_t(fileStatus.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+			if (view == MAP_FAILED)
+			{
+				close(file);
+				return false;
+			}
+			data = static_cast<const uint8_t*>(view);
+		}
+
+		close(file);
+		size = size_t(fileStatus.st_size);
+#endif
+
+		isOpen = true;
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (data != nullptr)
+		{
+#ifdef _WIN32
+			UnmapViewOfFile(data);
+#else
+			munmap(const_cast<uint8_t*>(data), size);
+#endif
+		}
+
+		data = nullptr;
+		size = 0;
+		isOpen = false;
+	}
+
+	bool MappedFile::IsOpen() const
+	{
+		return isOpen;
+	}
+
+	const uint8_t* MappedFile::GetData() const
+	{
+		return data;
+	}
+
+	size_t MappedFile::GetSize() const
+	{
+		return size;
+	}
+} // namespace Engine
\ No newline at end of file
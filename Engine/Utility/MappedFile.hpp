@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Engine/api.hpp"
+
+#include <ThirdParty/EASTL-master/include/EASTL/string.h>
+
+#include <cstdint>
+
+namespace Engine
+{
+	/// <summary>
+	/// A file mapped read-only into memory. The contents are paged in by the operating system when they are first accessed,
+	/// so reading from the mapping doesn't copy the file into a buffer first. The mapping stays valid until the file is closed or destroyed.
+	/// </summary>
+	class ENGINE_API MappedFile
+	{
+	public:
+		MappedFile();
+		/// <summary>
+		/// Maps the given file, check IsOpen to see if it succeeded.
+		/// </summary>
+		explicit MappedFile(const eastl::string& fileName);
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+		MappedFile(const MappedFile& other) = delete;
+		MappedFile& operator=(const MappedFile& other) = delete;
+		~MappedFile();
+
+		/// <summary>
+		/// Maps the given file, the previously mapped file is closed first.
+		/// </summary>
+		/// <param name="fileName">The path of the file to map.</param>
+		/// <returns>Returns false if the file doesn't exist or couldn't be mapped.</returns>
+		bool Open(const eastl::string& fileName);
+
+		/// <summary>
+		/// Unmaps the file, the data returned by GetData can no longer be used.
+		/// </summary>
+		void Close();
+
+		/// <summary>
+		/// Returns true if a file is mapped. An empty file is open, but has no data.
+		/// </summary>
+		bool IsOpen() const;
+
+		/// <summary>
+		/// Returns the contents of the file, nullptr if the file is empty or not open. The mapping starts at a page boundary.
+		/// </summary>
+		const uint8_t* GetData() const;
+
+		/// <summary>
+		/// Returns the size of the file in bytes.
+		/// </summary>
+		size_t GetSize() const;
+
+	private:
+		const uint8_t* data;
+		size_t size;
+		bool isOpen;
+	};
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "Engine/Utility/TransformBatch.hpp"
+
+#if defined(__AVX__)
+#define ENGINE_TRANSFORM_BATCH_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ENGINE_TRANSFORM_BATCH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Engine
+{
+	constexpr size_t TransformBatch::Capacity;
+
+	void TransformBatch::SetTransform(size_t lane, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+	{
+		positionX[lane] = position.x;
+		positionY[lane] = position.y;
+		positionZ[lane] = position.z;
+		rotationX[lane] = rotation.x;
+		rotationY[lane] = rotation.y;
+		rotationZ[lane] = rotation.z;
+		rotationW[lane] = rotation.w;
+		scaleX[lane] = scale.x;
+		scaleY[lane] = scale.y;
+		scaleZ[lane] = scale.z;
+	}
+
+#if defined(ENGINE_TRANSFORM_BATCH_AVX) || defined(ENGINE_TRANSFORM_BATCH_SSE)
+	namespace
+	{
+		/// <summary>
+		/// Writes four matrices that are stored as one register per matrix element, columns[column][row] holds that element of all four matrices.
+		/// </summary>
+		void StoreMatrices(__m128 columns[4][4], size_t count, glm::mat4x4* const* outputs)
+		{
+			for (size_t column = 0; column < 4; ++column)
+			{
+				// After the transpose every register holds a complete column of a single matrix.
+				_MM_TRANSPOSE4_PS(columns[column][0], columns[column][1], columns[column][2], columns[column][3]);
+
+				for (size_t lane = 0; lane < count; ++lane)
+					_mm_storeu_ps(&(*outputs[lane])[column][0], columns[column][lane]);
+			}
+		}
+	}
+#endif
+
+#if defined(ENGINE_TRANSFORM_BATCH_AVX)
+	void ComposeTransforms(const TransformBatch& batch, size_t count, glm::mat4x4* const* outputs)
+	{
+		const __m256 one = _mm256_set1_ps(1.0f);
+
+		const __m256 x = _mm256_load_ps(batch.rotationX);
+		const __m256 y = _mm256_load_ps(batch.rotationY);
+		const __m256 z = _mm256_load_ps(batch.rotationZ);
+		const __m256 w = _mm256_load_ps(batch.rotationW);
+		const __m256 x2 = _mm256_add_ps(x, x);
+		const __m256 y2 = _mm256_add_ps(y, y);
+		const __m256 z2 = _mm256_add_ps(z, z);
+
+		const __m256 xx = _mm256_mul_ps(x, x2);
+		const __m256 yy = _mm256_mul_ps(y, y2);
+		const __m256 zz = _mm256_mul_ps(z, z2);
+		const __m256 xy = _mm256_mul_ps(x, y2);
+		const __m256 xz = _mm256_mul_ps(x, z2);
+		const __m256 yz = _mm256_mul_ps(y, z2);
+		const __m256 wx = _mm256_mul_ps(w, x2);
+		const __m256 wy = _mm256_mul_ps(w, y2);
+		const __m256 wz = _mm256_mul_ps(w, z2);
+
+		const __m256 scaleX = _mm256_load_ps(batch.scaleX);
+		const __m256 scaleY = _mm256_load_ps(batch.scaleY);
+		const __m256 scaleZ = _mm256_load_ps(batch.scaleZ);
+
+		__m256 elements[4][4];
+		elements[0][0] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), scaleX);
+		elements[0][1] = _mm256_mul_ps(_mm256_add_ps(xy, wz), scaleX);
+		elements[0][2] = _mm256_mul_ps(_mm256_sub_ps(xz, wy), scaleX);
+		elements[0][3] = _mm256_setzero_ps();
+		elements[1][0] = _mm256_mul_ps(_mm256_sub_ps(xy, wz), scaleY);
+		elements[1][1] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), scaleY);
+		elements[1][2] = _mm256_mul_ps(_mm256_add_ps(yz, wx), scaleY);
+		elements[1][3] = _mm256_setzero_ps();
+		elements[2][0] = _mm256_mul_ps(_mm256_add_ps(xz, wy), scaleZ);
+		elements[2][1] = _mm256_mul_ps(_mm256_sub_ps(yz, wx), scaleZ);
+		elements[2][2] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), scaleZ);
+		elements[2][3] = _mm256_setzero_ps();
+		elements[3][0] = _mm256_load_ps(batch.positionX);
+		elements[3][1] = _mm256_load_ps(batch.positionY);
+		elements[3][2] = _mm256_load_ps(batch.positionZ);
+		elements[3][3] = one;
+
+		// Store the lower and upper four lanes separately.
+		for (size_t half = 0; half < 2 && half * 4 < count; ++half)
+		{
+			__m128 columns[4][4];
+			for (size_t column = 0; column < 4; ++column)
+			{
+				for (size_t row = 0; row < 4; ++row)
+					columns[column][row] = half == 0 ? _mm256_castps256_ps128(elements[column][row]) : _mm256_extractf128_ps(elements[column][row], 1);
+			}
+
+			const size_t laneCount = count - half * 4 < 4 ? count - half * 4 : 4;
+			StoreMatrices(columns, laneCount, outputs + half * 4);
+		}
+	}
+#elif defined(ENGINE_TRANSFORM_BATCH_SSE)
+	void ComposeTransforms(const TransformBatch& batch, size_t count, glm::mat4x4* const* outputs)
+	{
+		const __m128 one = _mm_set1_ps(1.0f);
+
+		for (size_t offset = 0; offset < count; offset += 4)
+		{
+			const __m128 x = _mm_load_ps(batch.rotationX + offset);
+			const __m128 y = _mm_load_ps(batch.rotationY + offset);
+			const __m128 z = _mm_load_ps(batch.rotationZ + offset);
+			const __m128 w = _mm_load_ps(batch.rotationW + offset);
+			const __m128 x2 = _mm_add_ps(x, x);
+			const __m128 y2 = _mm_add_ps(y, y);
+			const __m128 z2 = _mm_add_ps(z, z);
+
+			const __m128 xx = _mm_mul_ps(x, x2);
+			const __m128 yy = _mm_mul_ps(y, y2);
+			const __m128 zz = _mm_mul_ps(z, z2);
+			const __m128 xy = _mm_mul_ps(x, y2);
+			const __m128 xz = _mm_mul_ps(x, z2);
+			const __m128 yz = _mm_mul_ps(y, z2);
+			const __m128 wx = _mm_mul_ps(w, x2);
+			const __m128 wy = _mm_mul_ps(w, y2);
+			const __m128 wz = _mm_mul_ps(w, z2);
+
+			const __m128 scaleX = _mm_load_ps(batch.scaleX + offset);
+			const __m128 scaleY = _mm_load_ps(batch.scaleY + offset);
+			const __m128 scaleZ = _mm_load_ps(batch.scaleZ + offset);
+
+			__m128 columns[4][4];
+			columns[0][0] = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), scaleX);
+			columns[0][1] = _mm_mul_ps(_mm_add_ps(xy, wz), scaleX);
+			columns[0][2] = _mm_mul_ps(_mm_sub_ps(xz, wy), scaleX);
+			columns[0][3] = _mm_setzero_ps();
+			columns[1][0] = _mm_mul_ps(_mm_sub_ps(xy, wz), scaleY);
+			columns[1][1] = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), scaleY);
+			columns[1][2] = _mm_mul_ps(_mm_add_ps(yz, wx), scaleY);
+			columns[1][3] = _mm_setzero_ps();
+			columns[2][0] = _mm_mul_ps(_mm_add_ps(xz, wy), scaleZ);
+			columns[2][1] = _mm_mul_ps(_mm_sub_ps(yz, wx), scaleZ);
+			columns[2][2] = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), scaleZ);
+			columns[2][3] = _mm_setzero_ps();
+			columns[3][0] = _mm_load_ps(batch.positionX + offset);
+			columns[3][1] = _mm_load_ps(batch.positionY + offset);
+			columns[3][2] = _mm_load_ps(batch.positionZ + offset);
+			columns[3][3] = one;
+
+			StoreMatrices(columns, count - offset < 4 ? count - offset : 4, outputs + offset);
+		}
+	}
+#else
+	void ComposeTransforms(const TransformBatch& batch, size_t count, glm::mat4x4* const* outputs)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float x = batch.rotationX[i];
+			const float y = batch.rotationY[i];
+			const float z = batch.rotationZ[i];
+			const float w = batch.rotationW[i];
+			const float xx = x * (x + x);
+			const float yy = y * (y + y);
+			const float zz = z * (z + z);
+			const float xy = x * (y + y);
+			const float xz = x * (z + z);
+			const float yz = y * (z + z);
+			const float wx = w * (x + x);
+			const float wy = w * (y + y);
+			const float wz = w * (z + z);
+
+			glm::mat4x4& matrix = *outputs[i];
+			matrix[0] = glm::vec4((1.0f - (yy + zz)) * batch.scaleX[i], (xy + wz) * batch.scaleX[i], (xz - wy) * batch.scaleX[i], 0.0f);
+			matrix[1] = glm::vec4((xy - wz) * batch.scaleY[i], (1.0f - (xx + zz)) * batch.scaleY[i], (yz + wx) * batch.scaleY[i], 0.0f);
+			matrix[2] = glm::vec4((xz + wy) * batch.scaleZ[i], (yz - wx) * batch.scaleZ[i], (1.0f - (xx + yy)) * batch.scaleZ[i], 0.0f);
+			matrix[3] = glm::vec4(batch.positionX[i], batch.positionY[i], batch.positionZ[i], 1.0f);
+		}
+	}
+#endif
+} // namespace Engine
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Engine/api.hpp"
+
+#include <ThirdParty/glm/glm/glm.hpp>
+#include <ThirdParty/glm/glm/gtc/quaternion.hpp>
+
+namespace Engine
+{
+	/// <summary>
+	/// A block of transforms stored as separate arrays per component, so multiple transforms can be composed into matrices at once.
+	/// The arrays are aligned for the widest vector instructions the engine uses.
+	/// </summary>
+	struct TransformBatch
+	{
+		/// <summary>
+		/// The amount of transforms a single batch can hold.
+		/// </summary>
+		static constexpr size_t Capacity = 8;
+
+		alignas(32) float positionX[Capacity];
+		alignas(32) float positionY[Capacity];
+		alignas(32) float positionZ[Capacity];
+		alignas(32) float rotationX[Capacity];
+		alignas(32) float rotationY[Capacity];
+		alignas(32) float rotationZ[Capacity];
+		alignas(32) float rotationW[Capacity];
+		alignas(32) float scaleX[Capacity];
+		alignas(32) float scaleY[Capacity];
+		alignas(32) float scaleZ[Capacity];
+
+		/// <summary>
+		/// Stores the given transform in the given lane of this batch.
+		/// </summary>
+		/// <param name="lane">The index in the batch, this has to be lower than the capacity.</param>
+		/// <param name="position">The translation of the transform.</param>
+		/// <param name="rotation">The rotation of the transform, this quaternion should be normalized.</param>
+		/// <param name="scale">The scale of the transform.</param>
+		void SetTransform(size_t lane, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+	};
+
+	/// <summary>
+	/// Builds the translation * rotation * scale matrix of the first count transforms of the given batch.
+	/// Uses AVX when the engine is compiled with AVX support, SSE on every other x86 target and plain scalar code elsewhere.
+	/// NOTE: The lanes past count are still calculated, but their results are thrown away.
+	/// </summary>
+	/// <param name="batch">The transforms to compose.</param>
+	/// <param name="count">The amount of transforms in the batch.</param>
+	/// <param name="outputs">The matrix every transform is written to, the array needs to contain at least count pointers.</param>
+	ENGINE_API void ComposeTransforms(const TransformBatch& batch, size_t count, glm::mat4x4* const* outputs);
+} // namespace Engine
\ No newline at end of file
@@ -1,32 +1,29 @@
 #include "Utility.hpp"
+#include "Engine/Utility/MappedFile.hpp"
+#include <cstdio>
 #include <fstream>
 #include <iostream>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
 
 namespace Engine
 {
 	eastl::vector<char> Utility::ReadFile(const eastl::string& fileName, int fileOpenMode)
 	{
-		std::ifstream file(fileName.c_str());
-
-		if (!file)
-		{
-			throw std::runtime_error("Failed to find file!");
-		}
+		MappedFile file(fileName);
 
-		if (!file.is_open())
+		if (!file.IsOpen())
 		{
 			throw std::runtime_error("Failed to open file!");
 		}
 
-		file.seekg(0, file.end);
-		size_t fileSize = size_t(file.tellg());
-		eastl::vector<char> buffer(fileSize);
-
-		file.seekg(0, file.beg);
-		file.read(buffer.data(), fileSize);
-		file.close();
-
-		return buffer;
+		const char* data = reinterpret_cast<const char*>(file.GetData());
+		return eastl::vector<char>(data, data + file.GetSize());
 	}
 
 	bool Utility::FileExists(const eastl::string& fileName)
@@ -38,4 +35,31 @@ namespace Engine
 
 		return fileExists;
 	}
+
+	bool Utility::GetFileInfo(const eastl::string& fileName, uint64_t& size, int64_t& modificationTime)
+	{
+#ifdef _WIN32
+		struct _stat64 fileStatus;
+		if (_stat64(fileName.c_str(), &fileStatus) != 0)
+			return false;
+#else
+		struct stat fileStatus;
+		if (stat(fileName.c_str(), &fileStatus) != 0)
+			return false;
+#endif
+
+		size = uint64_t(fileStatus.st_size);
+		modificationTime = int64_t(fileStatus.st_mtime);
+		return true;
+	}
+
+	bool Utility::RenameFile(const eastl::string& sourceFileName, const eastl::string& destinationFileName)
+	{
+#ifdef _WIN32
+		// Unlike rename, MoveFileEx is allowed to replace an existing file.
+		return MoveFileExA(sourceFileName.c_str(), destinationFileName.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+		return std::rename(sourceFileName.c_str(), destinationFileName.c_str()) == 0;
+#endif
+	}
 } // namespace Engine
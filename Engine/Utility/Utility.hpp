@@ -12,7 +12,20 @@ namespace Engine
 		Utility() = default;
 		~Utility() = default;
 
+		/// <summary>
+		/// Copies the contents of a file into a buffer. The file is always read as binary, use a MappedFile to read a file without copying it.
+		/// </summary>
 		static eastl::vector<char> ReadFile(const eastl::string& fileName, int fileOpenMode = 1);
 		static bool FileExists(const eastl::string& fileName);
+		/// <summary>
+		/// Reads the size and the time of the last modification of a file, without opening it.
+		/// </summary>
+		/// <returns>Returns false if the file doesn't exist.</returns>
+		static bool GetFileInfo(const eastl::string& fileName, uint64_t& size, int64_t& modificationTime);
+		/// <summary>
+		/// Renames a file, replacing the destination file in a single step if it exists. Readers either see the old or the new file, both files have to be on the same volume.
+		/// </summary>
+		/// <returns>Returns false if the file couldn't be moved, the destination is left untouched in that case.</returns>
+		static bool RenameFile(const eastl::string& sourceFileName, const eastl::string& destinationFileName);
 	};
 } // namespace Engine
\ No newline at end of file
@@ -107,6 +107,13 @@ namespace Engine
 		return instance->collisionSystem;
 	}
 
+	eastl::weak_ptr<JobSystem> Engine::GetJobSystem() const noexcept
+	{
+		if (instance->jobSystem == nullptr)
+			instance->jobSystem = eastl::shared_ptr<JobSystem>(new JobSystem());
+		return instance->jobSystem;
+	}
+
 	eastl::weak_ptr<Engine> Engine::InitializeEngine(bool isPlaying) noexcept
 	{
 		if (instance != nullptr)
@@ -138,6 +145,10 @@ namespace Engine
 	{
 		GetTime().lock()->OnUpdateBegin();
 
+		// Models that finished loading in the background are finalized on the main thread, also while the game is paused.
+		if (instance->resourceManager != nullptr)
+			instance->resourceManager->Update();
+
 		if (instance->isPlaying)
 		{
 			if (instance->entitySystem != nullptr)
@@ -149,12 +160,20 @@ namespace Engine
 
 			if (instance->collisionSystem != nullptr)
 				instance->collisionSystem->Update();
+
+			// Sync point, every entity and component change recorded during the updates above, including the contact callbacks, is applied here.
+			if (instance->entitySystem != nullptr)
+				instance->entitySystem->ApplyCommands();
 		}
 
 		//Input manager should always update. 
 		if (instance->inputManager != nullptr)
 			instance->inputManager->Update();
 
+		// Apply every transform change before rendering, this also picks up changes made while the game isn't playing.
+		if (instance->entitySystem != nullptr)
+			instance->entitySystem->UpdateTransforms();
+
 		Render();
 		GetTime().lock()->OnUpdateEnd();
 	}
@@ -164,6 +183,8 @@ namespace Engine
 		SaveEngineSettings();
 
 		engineImGui.reset();
+		// Stop the workers first, so no job can be running while the other systems are destroyed.
+		instance->jobSystem.reset();
 		instance->time.reset();
 		instance->camera.reset();
 		instance->inputManager.reset();
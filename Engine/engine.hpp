@@ -10,6 +10,7 @@
 #include "Engine/Resources/ResourceManager.hpp"
 #include "Engine/Collision/CollisionSystem.hpp"
 #include "Engine/Utility/Random.hpp"
+#include "Engine/Utility/JobSystem.hpp"
 
 #include <ThirdParty/cereal/include/cereal/cereal.hpp>
 
@@ -142,6 +143,13 @@ namespace Engine
 		/// <returns>Returns a weak pointer to Random class object</returns>
 		eastl::weak_ptr<Random> GetRandom();
 
+		/// <summary>
+		/// This method allows you to get a weak pointer of the job system. 
+		/// If it hasn't been defined yet, it'll be created for you.
+		/// </summary>
+		/// <returns>Returns a weak pointer of the job system.</returns>
+		eastl::weak_ptr<JobSystem> GetJobSystem() const noexcept;
+
 		/// <summary>
 		/// The general update method of the entire engine system. 
 		/// Call this from your main loop.
@@ -186,6 +194,7 @@ namespace Engine
 		eastl::shared_ptr<ResourceManager> resourceManager;
 		eastl::shared_ptr<CollisionSystem> collisionSystem;
 		eastl::shared_ptr<Random> random;
+		eastl::shared_ptr<JobSystem> jobSystem;
 		bool isPlaying;
 	};
 